@@ -15,6 +15,11 @@ struct LiteralTypeEvaluator : boost::static_visitor<ExpressionType>
         return ExpressionType::Number;
     }
 
+    ExpressionType operator ()(int64_t const&) const
+    {
+        return ExpressionType::Number;
+    }
+
     ExpressionType operator ()(bool const&) const
     {
         return ExpressionType::Boolean;
@@ -122,6 +127,10 @@ void CLiteralAST::Accept(IExpressionVisitor &visitor)
 
 ExpressionType CLiteralAST::GetType() const
 {
+    if (IsUntypedInteger())
+    {
+        return m_integerType;
+    }
     LiteralTypeEvaluator visitor;
     return m_value.apply_visitor(visitor);
 }
@@ -131,6 +140,64 @@ const CLiteralAST::Value &CLiteralAST::GetValue() const
     return m_value;
 }
 
+bool CLiteralAST::IsUntypedInteger() const
+{
+    return boost::get<int64_t>(&m_value) != nullptr;
+}
+
+void CLiteralAST::SetIntegerType(ExpressionType type)
+{
+    if (!IsUntypedInteger())
+    {
+        throw std::logic_error("attempt to change type of non-integer literal");
+    }
+    m_integerType = type;
+}
+
+CConversionAST::CConversionAST(ExpressionType type, IExpressionASTUniquePtr &&value)
+    : m_expr(std::move(value))
+{
+    SetType(type);
+}
+
+void CConversionAST::Accept(IExpressionVisitor &visitor)
+{
+    visitor.Visit(*this);
+}
+
+IExpressionAST &CConversionAST::GetOperand()
+{
+    return *m_expr;
+}
+
+CSliceAST::CSliceAST(IExpressionASTUniquePtr &&value, IExpressionASTUniquePtr &&begin, IExpressionASTUniquePtr &&end)
+    : m_expr(std::move(value))
+    , m_begin(std::move(begin))
+    , m_end(std::move(end))
+{
+    SetType(ExpressionType::String);
+}
+
+void CSliceAST::Accept(IExpressionVisitor &visitor)
+{
+    visitor.Visit(*this);
+}
+
+IExpressionAST &CSliceAST::GetOperand()
+{
+    return *m_expr;
+}
+
+IExpressionAST *CSliceAST::GetBegin()
+{
+    return m_begin.get();
+}
+
+IExpressionAST *CSliceAST::GetEnd()
+{
+    return m_end.get();
+}
+
 CParameterDeclAST::CParameterDeclAST(unsigned nameId, ExpressionType type)
     : m_nameId(nameId)
 {
@@ -189,6 +256,21 @@ void CIfAst::Accept(IStatementVisitor &visitor)
     visitor.Visit(*this);
 }
 
+CLoopJumpAST::CLoopJumpAST(LoopJump kind)
+    : m_kind(kind)
+{
+}
+
+LoopJump CLoopJumpAST::GetKind() const
+{
+    return m_kind;
+}
+
+void CLoopJumpAST::Accept(IStatementVisitor &visitor)
+{
+    visitor.Visit(*this);
+}
+
 CAbstractLoopAst::CAbstractLoopAst(IExpressionASTUniquePtr &&condition, StatementsList &&body)
     : m_condition(std::move(condition))
     , m_body(std::move(body))
@@ -274,6 +356,16 @@ ExpressionType CFunctionAST::GetReturnType() const
     return m_returnType;
 }
 
+unsigned CFunctionAST::GetFastMathFlags() const
+{
+    return m_fastMathFlags;
+}
+
+void CFunctionAST::SetFastMathFlags(unsigned flags)
+{
+    m_fastMathFlags = flags;
+}
+
 CReturnAST::CReturnAST(IExpressionASTUniquePtr &&value)
     : m_value(std::move(value))
 {
@@ -2,6 +2,7 @@
 
 #include <memory>
 #include <vector>
+#include <cstdint>
 #include "ASTVisitor.h"
 #include <boost/variant.hpp>
 #include <boost/optional.hpp>
@@ -25,6 +26,7 @@ enum class ExpressionType
     Boolean,
     Number,
     String,
+    Int,
 };
 
 class IExpressionAST
@@ -50,6 +52,8 @@ public:
     virtual ExpressionType GetReturnType()const = 0;
     virtual const ParameterDeclList &GetParameters()const = 0;
     virtual const StatementsList &GetBody()const = 0;
+    // Флаги FastMath::Flag, заданные аннотацией @fastmath.
+    virtual unsigned GetFastMathFlags()const = 0;
 };
 
 class CAbstractExpressionAST : public IExpressionAST
@@ -66,11 +70,23 @@ enum class BinaryOperation
 {
     Less,
     Equals,
+    NotEquals,
+    Greater,
+    LessOrEquals,
+    GreaterOrEquals,
+    // Логические операции вычисляют правый операнд, только если от него зависит результат.
+    And,
+    Or,
     Add,
     Substract,
     Multiply,
     Divide,
-    Modulo
+    Modulo,
+    BitwiseAnd,
+    BitwiseOr,
+    BitwiseXor,
+    ShiftLeft,
+    ShiftRight
 };
 
 class CBinaryExpressionAST : public CAbstractExpressionAST
@@ -92,7 +108,9 @@ private:
 enum class UnaryOperation
 {
     Plus,
-    Minus
+    Minus,
+    BitwiseNot,
+    LogicalNot
 };
 
 class CUnaryExpressionAST : public CAbstractExpressionAST
@@ -112,9 +130,12 @@ private:
 class CLiteralAST : public IExpressionAST
 {
 public:
+    // Целочисленная константа (int64_t) не имеет собственного типа:
+    //  по умолчанию она имеет тип Number, а в контексте Int - тип Int.
     typedef boost::variant<
         bool,
         double,
+        int64_t,
         std::string
     > Value;
 
@@ -123,9 +144,12 @@ public:
     ExpressionType GetType()const override;
 
     const Value &GetValue()const;
+    bool IsUntypedInteger()const;
+    void SetIntegerType(ExpressionType type);
 
 private:
     const Value m_value;
+    ExpressionType m_integerType = ExpressionType::Number;
 };
 
 class CCallAST : public CAbstractExpressionAST
@@ -142,6 +166,38 @@ private:
     ExpressionList m_arguments;
 };
 
+// Явное преобразование типа: `Int(x)`, `Number(x)`, `String(x)`.
+class CConversionAST : public CAbstractExpressionAST
+{
+public:
+    CConversionAST(ExpressionType type, IExpressionASTUniquePtr && value);
+    void Accept(IExpressionVisitor & visitor) override;
+
+    IExpressionAST &GetOperand();
+
+private:
+    IExpressionASTUniquePtr m_expr;
+};
+
+// Срез строки `s[begin:end]`, любая из границ может быть опущена.
+// Срез ссылается на байты исходной строки и не копирует их.
+class CSliceAST : public CAbstractExpressionAST
+{
+public:
+    CSliceAST(IExpressionASTUniquePtr && value, IExpressionASTUniquePtr && begin, IExpressionASTUniquePtr && end);
+    void Accept(IExpressionVisitor & visitor) override;
+
+    IExpressionAST &GetOperand();
+    // Возвращают nullptr для опущенной границы.
+    IExpressionAST *GetBegin();
+    IExpressionAST *GetEnd();
+
+private:
+    IExpressionASTUniquePtr m_expr;
+    IExpressionASTUniquePtr m_begin;
+    IExpressionASTUniquePtr m_end;
+};
+
 class CParameterDeclAST : public CAbstractExpressionAST
 {
 public:
@@ -209,6 +265,27 @@ private:
     IExpressionASTUniquePtr m_value;
 };
 
+enum class LoopJump
+{
+    Break,
+    Continue,
+};
+
+// `break` выходит из ближайшего объемлющего цикла, `continue` переходит к проверке его условия.
+class CLoopJumpAST : public IStatementAST
+{
+public:
+    CLoopJumpAST(LoopJump kind);
+
+    LoopJump GetKind()const;
+
+protected:
+    void Accept(IStatementVisitor & visitor) override;
+
+private:
+    const LoopJump m_kind;
+};
+
 class CAbstractLoopAst : public IStatementAST
 {
 public:
@@ -272,12 +349,15 @@ public:
     const ParameterDeclList &GetParameters()const override;
     const StatementsList &GetBody()const override;
     ExpressionType GetReturnType() const override;
+    unsigned GetFastMathFlags() const override;
+    void SetFastMathFlags(unsigned flags);
 
 private:
     unsigned m_nameId;
     ParameterDeclList m_parameters;
     StatementsList m_body;
     ExpressionType m_returnType;
+    unsigned m_fastMathFlags = 0;
 };
 
 class CProgramAst
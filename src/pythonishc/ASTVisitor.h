@@ -7,6 +7,8 @@ class CLiteralAST;
 class CCallAST;
 class CVariableRefAST;
 class CParameterDeclAST;
+class CConversionAST;
+class CSliceAST;
 
 class IExpressionVisitor
 {
@@ -18,12 +20,15 @@ public:
     virtual void Visit(CCallAST & expr) = 0;
     virtual void Visit(CVariableRefAST & expr) = 0;
     virtual void Visit(CParameterDeclAST & expr) = 0;
+    virtual void Visit(CConversionAST & expr) = 0;
+    virtual void Visit(CSliceAST & expr) = 0;
 };
 
 class IStatementAST;
 class CPrintAST;
 class CAssignAST;
 class CReturnAST;
+class CLoopJumpAST;
 class CWhileAst;
 class CRepeatAst;
 class CIfAst;
@@ -35,6 +40,7 @@ public:
     virtual void Visit(CPrintAST & ast) = 0;
     virtual void Visit(CAssignAST & ast) = 0;
     virtual void Visit(CReturnAST & ast) = 0;
+    virtual void Visit(CLoopJumpAST & ast) = 0;
     virtual void Visit(CWhileAst & ast) = 0;
     virtual void Visit(CRepeatAst & ast) = 0;
     virtual void Visit(CIfAst & ast) = 0;
@@ -0,0 +1,43 @@
+#include "Builtins.h"
+#include <unordered_map>
+
+const BuiltinSignature *FindBuiltinCall(const std::string &name)
+{
+    static const std::vector<BuiltinSignature> BUILTINS = {
+        { BuiltinCall::Intern, "Intern", { ExpressionType::String }, ExpressionType::String },
+        { BuiltinCall::Length, "Length", { ExpressionType::String }, ExpressionType::Int },
+        { BuiltinCall::Find, "Find", { ExpressionType::String, ExpressionType::String }, ExpressionType::Int },
+        { BuiltinCall::StartsWith, "StartsWith", { ExpressionType::String, ExpressionType::String },
+          ExpressionType::Boolean },
+        { BuiltinCall::Copy, "Copy", { ExpressionType::String }, ExpressionType::String },
+        { BuiltinCall::ReadLine, "ReadLine", {}, ExpressionType::String },
+        { BuiltinCall::ReadNumber, "ReadNumber", {}, ExpressionType::Number },
+        { BuiltinCall::EndOfInput, "EndOfInput", {}, ExpressionType::Boolean },
+        { BuiltinCall::Open, "Open", { ExpressionType::String, ExpressionType::String }, ExpressionType::Int },
+        { BuiltinCall::ReadAll, "ReadAll", { ExpressionType::Int }, ExpressionType::String },
+        { BuiltinCall::WriteString, "WriteString", { ExpressionType::Int, ExpressionType::String },
+          ExpressionType::Boolean },
+        { BuiltinCall::WriteLine, "WriteLine", { ExpressionType::Int, ExpressionType::String },
+          ExpressionType::Boolean },
+        { BuiltinCall::Close, "Close", { ExpressionType::Int }, ExpressionType::Boolean },
+        { BuiltinCall::Sqrt, "Sqrt", { ExpressionType::Number }, ExpressionType::Number },
+        { BuiltinCall::Abs, "Abs", { ExpressionType::Number }, ExpressionType::Number },
+        { BuiltinCall::Floor, "Floor", { ExpressionType::Number }, ExpressionType::Number },
+        { BuiltinCall::Ceil, "Ceil", { ExpressionType::Number }, ExpressionType::Number },
+        { BuiltinCall::Pow, "Pow", { ExpressionType::Number, ExpressionType::Number }, ExpressionType::Number },
+        { BuiltinCall::Min, "Min", { ExpressionType::Number, ExpressionType::Number }, ExpressionType::Number },
+        { BuiltinCall::Max, "Max", { ExpressionType::Number, ExpressionType::Number }, ExpressionType::Number },
+        { BuiltinCall::Fma, "Fma", { ExpressionType::Number, ExpressionType::Number, ExpressionType::Number },
+          ExpressionType::Number },
+    };
+    static const std::unordered_map<std::string, const BuiltinSignature *> BY_NAME = [] {
+        std::unordered_map<std::string, const BuiltinSignature *> byName;
+        for (const BuiltinSignature &builtin : BUILTINS)
+        {
+            byName[builtin.name] = &builtin;
+        }
+        return byName;
+    }();
+    auto it = BY_NAME.find(name);
+    return (it != BY_NAME.end()) ? it->second : nullptr;
+}
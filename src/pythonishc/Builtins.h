@@ -0,0 +1,64 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include "AST.h"
+
+// Встроенные функции языка, которые вызываются так же, как функции программы.
+// Функция программы с тем же именем скрывает встроенную.
+enum class BuiltinCall
+{
+    // Intern(s String) String - строка с тем же текстом из таблицы интернированных строк.
+    Intern,
+    // Length(s String) Int - длина строки в байтах.
+    Length,
+    // Find(s String, sub String) Int - позиция первого вхождения sub в s или -1.
+    Find,
+    // StartsWith(s String, prefix String) Boolean - начинается ли s с prefix.
+    StartsWith,
+    // Copy(s String) String - копия строки, которая не удерживает исходную строку среза.
+    Copy,
+    // ReadLine() String - следующая строка stdin без перевода строки или "" в конце ввода.
+    ReadLine,
+    // ReadNumber() Number - следующее число stdin, NaN для слова, которое не является числом.
+    ReadNumber,
+    // EndOfInput() Boolean - прочитан ли весь stdin.
+    EndOfInput,
+    // Open(path String, mode String) Int - номер файла, открытого на чтение ("r"),
+    //  перезапись ("w") или дозапись ("a"), либо -1.
+    Open,
+    // ReadAll(file Int) String - непрочитанная часть файла, открытого на чтение.
+    ReadAll,
+    // WriteString(file Int, s String) Boolean - дописывает s в файл, false при ошибке записи.
+    WriteString,
+    // WriteLine(file Int, s String) Boolean - дописывает s и перевод строки.
+    WriteLine,
+    // Close(file Int) Boolean - закрывает файл, false при ошибке записи или закрытия.
+    Close,
+    // Математические функции Number, каждая - одна встроенная функция LLVM (intrinsic).
+    // Sqrt(x) - корень, NaN для отрицательного x.
+    Sqrt,
+    // Abs(x) - модуль.
+    Abs,
+    // Floor(x) и Ceil(x) - округление вниз и вверх.
+    Floor,
+    Ceil,
+    // Pow(x, y) - x в степени y.
+    Pow,
+    // Min(x, y) и Max(x, y) - меньшее и большее из чисел; если одно из них NaN, возвращается другое.
+    Min,
+    Max,
+    // Fma(x, y, z) - x * y + z с одним округлением.
+    Fma,
+};
+
+struct BuiltinSignature
+{
+    BuiltinCall id;
+    const char *name;
+    std::vector<ExpressionType> parameters;
+    ExpressionType returnType;
+};
+
+// Возвращает описание встроенной функции с данным именем или nullptr.
+const BuiltinSignature *FindBuiltinCall(const std::string &name);
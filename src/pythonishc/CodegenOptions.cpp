@@ -0,0 +1,16 @@
+#include "CodegenOptions.h"
+#include <unordered_map>
+
+unsigned FastMath::ParseFlag(const std::string &name)
+{
+    static const std::unordered_map<std::string, unsigned> FLAGS = {
+        { "reassoc",  Reassoc },
+        { "contract", Contract },
+        { "nnan",     NoNaNs },
+        { "ninf",     NoInfs },
+        { "arcp",     Reciprocal },
+        { "fast",     All },
+    };
+    auto it = FLAGS.find(name);
+    return (it != FLAGS.end()) ? it->second : None;
+}
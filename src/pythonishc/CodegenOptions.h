@@ -0,0 +1,38 @@
+#pragma once
+
+#include <string>
+
+namespace FastMath
+{
+// Флаги ослабления требований IEEE 754 к операциям над Number.
+// Включаются опцией компилятора --fast-math или аннотацией функции @fastmath.
+enum Flag : unsigned
+{
+    None = 0,
+    // Разрешает переупорядочивать операции, например, при векторизации сумм.
+    Reassoc = 1 << 0,
+    // Разрешает сливать `a * b + c` в одну инструкцию FMA.
+    Contract = 1 << 1,
+    // Разрешает считать, что NaN и бесконечности не встречаются.
+    NoNaNs = 1 << 2,
+    NoInfs = 1 << 3,
+    // Разрешает заменять `x / c` на `x * (1 / c)`.
+    Reciprocal = 1 << 4,
+    All = Reassoc | Contract | NoNaNs | NoInfs | Reciprocal,
+};
+
+// Возвращает флаг по имени: reassoc, contract, nnan, ninf, arcp или fast (все флаги).
+// Для неизвестного имени возвращает None.
+unsigned ParseFlag(const std::string &name);
+}
+
+struct CodegenOptions
+{
+    // Флаги FastMath, действующие во всех функциях программы.
+    unsigned fastMathFlags = FastMath::None;
+    // Сообщать, какие переменные Number хранятся в 64-битных целых.
+    bool reportNarrowing = false;
+    // Выделять память строк функциями malloc/free вместо пула библиотеки времени выполнения,
+    //  например, для отладки с AddressSanitizer или valgrind.
+    bool useLibCAllocator = false;
+};
@@ -4,6 +4,10 @@
 #include "FrontendContext.h"
 
 #define BOOST_RESULT_OF_USE_DECLTYPE
+#include <algorithm>
+#include <limits>
+#include <map>
+#include <cstring>
 #include <boost/variant.hpp>
 #include <boost/range/algorithm.hpp>
 #include <boost/range/algorithm_ext/for_each.hpp>
@@ -18,7 +22,11 @@
 #include <llvm/IR/Function.h>
 #include <llvm/IR/Verifier.h>
 #include <llvm/IR/GlobalVariable.h>
+#include <llvm/IR/Intrinsics.h>
+#include <llvm/IR/Operator.h>
+#include <llvm/IR/MDBuilder.h>
 #include <llvm/Support/raw_ostream.h>
+#include <llvm/Transforms/Utils/ModuleUtils.h>
 #include <llvm/ADT/STLExtras.h>
 #include "end_llvm.h"
 
@@ -27,6 +35,52 @@ using namespace llvm;
 namespace
 {
 
+// Вместимость буфера на стеке для временной строки.
+const unsigned STACK_STRING_CAPACITY = 256;
+// Ограничение на суммарный размер таких буферов в кадре стека одной функции.
+const unsigned MAX_STACK_STRINGS_SIZE = 4096;
+// Начальная ёмкость буфера переменной, в конец которой дописываются строки.
+const unsigned MIN_APPEND_CAPACITY = 32;
+// Размер буфера, в который библиотека времени выполнения записывает число,
+//  совпадает с PYTHONISH_NUMBER_BUFFER_SIZE из runtime/runtime.h.
+const unsigned NUMBER_TEXT_CAPACITY = 32;
+// Литералы не длиннее этого сравниваются загрузками слов, более длинные - через memcmp.
+const unsigned MAX_WORD_COMPARED_LITERAL = 64;
+// Минимальное число веток `if s == "A" ... else if s == "B"`, для которого генерируется switch.
+const unsigned MIN_LITERAL_SWITCH_ARMS = 3;
+
+// Байтам строки предшествует заголовок со счётчиком ссылок:
+//   struct { size_t refcount; char data[]; }
+// Программа однопоточна, поэтому счётчик меняется без атомарных операций.
+const uint64_t STRING_HEADER_SIZE = sizeof(size_t);
+// Счётчик временной строки: она живёт до конца оператора, сохранённая строка копируется.
+const uint64_t STRING_TEMPORARY = 0;
+// Строки со счётчиком не меньше STRING_INTERNED бессмертны: они не освобождаются,
+//  а копирование сводится к копированию указателя.
+const uint64_t STRING_IMMORTAL = std::numeric_limits<size_t>::max();
+// Счётчик интернированной строки, совпадает с PYTHONISH_STRING_INTERNED из runtime/runtime.h.
+// Интернированная строка тоже бессмертна, а две такие строки равны, только если равны их указатели.
+// Длинные литералы интернированы: в модуле нет двух литералов с одинаковым текстом.
+const uint64_t STRING_INTERNED = STRING_IMMORTAL - 1;
+
+// Короткая строка хранится прямо в значении String, без памяти в куче.
+// Байты значения (целевая платформа little-endian) - символы строки, дополненные нулями,
+//  а старший байт поля length - тег INLINE_TAG | длина.
+// Длина строки в куче меньше 2^56, поэтому у неё два старших бита поля length равны нулю.
+const unsigned INLINE_STRING_CAPACITY = sizeof(void *) + sizeof(size_t) - 1;
+const unsigned INLINE_TAG_SHIFT = 8 * sizeof(size_t) - 8;
+const uint64_t INLINE_TAG = 0x80;
+
+// Срез (view) ссылается на байты другой строки в куче, не копируя их:
+//  data указывает внутрь исходной строки, а поле length равно
+//  VIEW_TAG | (смещение от начала исходной строки << VIEW_OFFSET_SHIFT) | длина.
+// Срез владеет ссылкой на исходную строку: её заголовок находится перед data - смещение.
+const unsigned VIEW_TAG_SHIFT = 8 * sizeof(size_t) - 2;
+const uint64_t VIEW_TAG = uint64_t(1) << VIEW_TAG_SHIFT;
+const unsigned VIEW_OFFSET_SHIFT = 32;
+const uint64_t VIEW_MAX_OFFSET = (uint64_t(1) << (VIEW_TAG_SHIFT - VIEW_OFFSET_SHIFT)) - 1;
+const uint64_t VIEW_MAX_LENGTH = (uint64_t(1) << VIEW_OFFSET_SHIFT) - 1;
+
 // Поскольку сейчас компилятор не совершает кросскомпиляции, то мы просто определяем
 // размер size_t и такой же размер используем в сгенерированном коде.
 llvm::Type *GetPointerSizeType(LLVMContext &context)
@@ -47,6 +101,21 @@ ConstantInt *AddInt32Literal(CCodegenContext &context, uint64_t value)
     return ConstantInt::get(context.GetLLVMContext(), APInt(32, value, true));
 }
 
+ConstantInt *AddInt64Literal(CCodegenContext &context, int64_t value)
+{
+    return ConstantInt::get(context.GetLLVMContext(), APInt(64, static_cast<uint64_t>(value), true));
+}
+
+// Целое значение литерала, который генерируется как i64.
+int64_t GetIntegerLiteralValue(const CLiteralAST &expr)
+{
+    if (const int64_t *pValue = boost::get<int64_t>(&expr.GetValue()))
+    {
+        return *pValue;
+    }
+    return static_cast<int64_t>(boost::get<double>(expr.GetValue()));
+}
+
 // Генерирует код константы LLVM.
 struct LiteralCodeGenerator : boost::static_visitor<Constant *>
 {
@@ -60,6 +129,12 @@ struct LiteralCodeGenerator : boost::static_visitor<Constant *>
         return ConstantFP::get(m_context.GetLLVMContext(), APFloat(value));
     }
 
+    // Целочисленная константа типа Number.
+    Constant *operator ()(int64_t const& value) const
+    {
+        return ConstantFP::get(m_context.GetLLVMContext(), APFloat(static_cast<double>(value)));
+    }
+
     Constant *operator ()(bool const& value) const
     {
         return ConstantInt::get(m_context.GetLLVMContext(), APInt(1, value ? 1 : 0, true));
@@ -83,10 +158,71 @@ Value *GenerateUnaryExpr(IRBuilder<> & builder, LLVMContext &context, UnaryOpera
         return x;
     case UnaryOperation::Minus:
         return builder.CreateFNeg(x, "negtmp");
+    case UnaryOperation::BitwiseNot:
+    case UnaryOperation::LogicalNot:
+        break;
     }
     throw std::runtime_error("Unknown unary operation");
 }
 
+// Сравнение, которое сводится к `<` или `==` над теми же операндами:
+//  `a > b` - это `b < a`, `a <= b` - это `!(b < a)`, `a != b` - это `!(a == b)`.
+struct ComparisonForm
+{
+    BinaryOperation base;
+    bool isSwapped;
+    bool isNegated;
+};
+
+// Возвращает false, если операция не является сравнением.
+bool GetComparisonForm(BinaryOperation op, ComparisonForm &form)
+{
+    switch (op)
+    {
+    case BinaryOperation::Less:
+        form = {BinaryOperation::Less, false, false};
+        return true;
+    case BinaryOperation::Greater:
+        form = {BinaryOperation::Less, true, false};
+        return true;
+    case BinaryOperation::LessOrEquals:
+        form = {BinaryOperation::Less, true, true};
+        return true;
+    case BinaryOperation::GreaterOrEquals:
+        form = {BinaryOperation::Less, false, true};
+        return true;
+    case BinaryOperation::Equals:
+        form = {BinaryOperation::Equals, false, false};
+        return true;
+    case BinaryOperation::NotEquals:
+        form = {BinaryOperation::Equals, false, true};
+        return true;
+    default:
+        return false;
+    }
+}
+
+// Выражение можно вычислить, даже если его значение не понадобится: оно не вызывает функций,
+//  не работает со строками и не делит, то есть не может аварийно завершить программу.
+bool IsSafeToSpeculate(IExpressionAST &expr)
+{
+    if (dynamic_cast<CLiteralAST *>(&expr) || dynamic_cast<CVariableRefAST *>(&expr))
+    {
+        return expr.GetType() != ExpressionType::String;
+    }
+    if (auto *pUnary = dynamic_cast<CUnaryExpressionAST *>(&expr))
+    {
+        return IsSafeToSpeculate(pUnary->GetOperand());
+    }
+    if (auto *pBinary = dynamic_cast<CBinaryExpressionAST *>(&expr))
+    {
+        const BinaryOperation op = pBinary->GetOperation();
+        return op != BinaryOperation::Divide && op != BinaryOperation::Modulo
+                && IsSafeToSpeculate(pBinary->GetLeft()) && IsSafeToSpeculate(pBinary->GetRight());
+    }
+    return false;
+}
+
 AllocaInst *MakeLocalVariable(Function &function, Type & type, const std::string &name)
 {
     BasicBlock &block = function.getEntryBlock();
@@ -95,10 +231,187 @@ AllocaInst *MakeLocalVariable(Function &function, Type & type, const std::string
     return temp.CreateAlloca(&type, nullptr, name);
 }
 
+// String - структура {i8* data, size_t length}, см. CManagedStrings.
+StructType *GetStringType(LLVMContext &context)
+{
+    return StructType::get(context, {Type::getInt8PtrTy(context), GetPointerSizeType(context)});
+}
+
+bool IsStringValue(Value *pValue)
+{
+    return pValue->getType()->isStructTy();
+}
+
+// Возвращает указатель на счётчик ссылок строки по указателю на её байты.
+Value *GetRefcountPtr(IRBuilder<> &builder, CCodegenContext &context, Value *pData)
+{
+    Value *pHeader = builder.CreateGEP(pData, AddSizeLiteral(context, 0 - STRING_HEADER_SIZE), "str_header");
+    Type *sizeType = GetPointerSizeType(context.GetLLVMContext());
+    return builder.CreateBitCast(pHeader, sizeType->getPointerTo(), "refcount_ptr");
+}
+
+Value *IsInlineString(IRBuilder<> &builder, CCodegenContext &context, Value *pString)
+{
+    Value *lengthWord = builder.CreateExtractValue(pString, {1}, "length_word");
+    return builder.CreateICmpSLT(lengthWord, AddSizeLiteral(context, 0), "is_inline");
+}
+
+Value *IsViewString(IRBuilder<> &builder, CCodegenContext &context, Value *pString)
+{
+    Value *lengthWord = builder.CreateExtractValue(pString, {1}, "length_word");
+    Value *tags = builder.CreateLShr(lengthWord, VIEW_TAG_SHIFT, "tags");
+    return builder.CreateICmpEQ(tags, AddSizeLiteral(context, 1), "is_view");
+}
+
+Value *GetStringLength(IRBuilder<> &builder, CCodegenContext &context, Value *pString)
+{
+    Value *lengthWord = builder.CreateExtractValue(pString, {1}, "length_word");
+    Value *tag = builder.CreateLShr(lengthWord, INLINE_TAG_SHIFT, "tag");
+    Value *inlineLength = builder.CreateAnd(tag, AddSizeLiteral(context, INLINE_TAG - 1), "inline_length");
+    Value *viewLength = builder.CreateAnd(lengthWord, AddSizeLiteral(context, VIEW_MAX_LENGTH), "view_length");
+    Value *heapLength = builder.CreateSelect(IsViewString(builder, context, pString), viewLength, lengthWord,
+                                             "heap_length");
+    return builder.CreateSelect(IsInlineString(builder, context, pString), inlineLength, heapLength, "length");
+}
+
+// Возвращает указатель на счётчик ссылок блока, в котором лежат байты строки в куче:
+//  у среза это счётчик исходной строки.
+Value *GetBlockRefcountPtr(IRBuilder<> &builder, CCodegenContext &context, Value *pString)
+{
+    Value *pData = builder.CreateExtractValue(pString, {0}, "data");
+    Value *lengthWord = builder.CreateExtractValue(pString, {1}, "length_word");
+    Value *viewOffset = builder.CreateAnd(builder.CreateLShr(lengthWord, VIEW_OFFSET_SHIFT),
+                                          AddSizeLiteral(context, VIEW_MAX_OFFSET), "view_offset");
+    Value *offset = builder.CreateSelect(IsViewString(builder, context, pString), viewOffset,
+                                         AddSizeLiteral(context, 0), "offset");
+    Value *pBlockData = builder.CreateGEP(pData, builder.CreateNeg(offset), "block_data");
+    return GetRefcountPtr(builder, context, pBlockData);
+}
+
+// Возвращает указатель на байты строки. Короткая строка для этого копируется в слот на стеке,
+//  который живёт до выхода из функции.
+Value *GetStringData(IRBuilder<> &builder, CCodegenContext &context, Value *pString)
+{
+    Value *pHeapData = builder.CreateExtractValue(pString, {0}, "heap_data");
+    if (auto *pConstant = dyn_cast<Constant>(pString))
+    {
+        if (!cast<ConstantInt>(pConstant->getAggregateElement(1u))->isNegative())
+        {
+            return pHeapData;
+        }
+    }
+    Function *pFunction = builder.GetInsertBlock()->getParent();
+    AllocaInst *pSlot = MakeLocalVariable(*pFunction, *pString->getType(), "inline_slot");
+    builder.CreateStore(pString, pSlot);
+    Value *pInlineData = builder.CreateBitCast(pSlot, builder.getInt8PtrTy(), "inline_data");
+    return builder.CreateSelect(IsInlineString(builder, context, pString), pInlineData, pHeapData, "data");
+}
+
+// Загружает короткую строку, байты которой уже скопированы в обнулённый слот, и записывает в неё длину.
+Value *LoadInlineString(IRBuilder<> &builder, CCodegenContext &context, AllocaInst *pSlot, Value *length)
+{
+    Value *inlineStr = builder.CreateLoad(pSlot, "inline_str");
+    Value *tag = builder.CreateOr(length, AddSizeLiteral(context, INLINE_TAG), "tag");
+    Value *lengthWord = builder.CreateOr(builder.CreateExtractValue(inlineStr, {1}),
+                                         builder.CreateShl(tag, INLINE_TAG_SHIFT), "length_word");
+    return builder.CreateInsertValue(inlineStr, lengthWord, {1}, "inline_str");
+}
+
+// Возвращает текст строкового литерала или nullptr, если выражение не является им.
+const std::string *GetStringLiteral(IExpressionAST &expr)
+{
+    auto *pLiteral = dynamic_cast<CLiteralAST *>(&expr);
+    return pLiteral ? boost::get<std::string>(&pLiteral->GetValue()) : nullptr;
+}
+
+// Для условия `x == "literal"` или `"literal" == x` возвращает переменную x
+//  и записывает literal в pLiteral, для других условий возвращает nullptr.
+CVariableRefAST *MatchLiteralEquality(IExpressionAST &condition, const std::string *&pLiteral)
+{
+    auto *pCompare = dynamic_cast<CBinaryExpressionAST *>(&condition);
+    if (!pCompare || pCompare->GetOperation() != BinaryOperation::Equals
+            || pCompare->GetLeft().GetType() != ExpressionType::String)
+    {
+        return nullptr;
+    }
+    auto *pVariable = dynamic_cast<CVariableRefAST *>(&pCompare->GetLeft());
+    pLiteral = GetStringLiteral(pCompare->GetRight());
+    if (!pVariable)
+    {
+        pVariable = dynamic_cast<CVariableRefAST *>(&pCompare->GetRight());
+        pLiteral = GetStringLiteral(pCompare->GetLeft());
+    }
+    return (pVariable && pLiteral) ? pVariable : nullptr;
+}
+
+// Сравнивает size байт по адресу pData со словом литерала, начинающимся с offset.
+Value *CreateLiteralWordEqual(IRBuilder<> &builder, CCodegenContext &context, Value *pData,
+                              const std::string &literal, size_t offset, unsigned size)
+{
+    uint64_t expected = 0;
+    for (unsigned i = 0; i < size; ++i)
+    {
+        expected |= uint64_t(static_cast<unsigned char>(literal[offset + i])) << (8 * i);
+    }
+    IntegerType *wordType = builder.getIntNTy(8 * size);
+    Value *pByte = builder.CreateGEP(pData, AddSizeLiteral(context, offset), "literal_byte");
+    Value *pWord = builder.CreateBitCast(pByte, wordType->getPointerTo(), "literal_word_ptr");
+    LoadInst *word = builder.CreateLoad(pWord, "literal_word");
+    word->setAlignment(1);
+    return builder.CreateICmpEQ(word, ConstantInt::get(wordType, expected), "same_word");
+}
+
+// Сравнивает байты строки известной длины с литералом той же длины.
+// Короткий литерал сравнивается загрузками по 8, 4, 2 или 1 байт, последняя загрузка
+//  может перекрывать предыдущую: 11 байт сравниваются словами [0, 8) и [3, 11).
+Value *CreateLiteralBytesEqual(IRBuilder<> &builder, CCodegenContext &context, Value *pData,
+                               const std::string &literal)
+{
+    const size_t length = literal.size();
+    if (length > MAX_WORD_COMPARED_LITERAL)
+    {
+        auto *pMemcmp = context.GetBuiltinFunction(BuiltinFunction::MEMCMP);
+        Value *order = builder.CreateCall(pMemcmp, {pData, context.AddCStringLiteral(literal),
+                                                    AddSizeLiteral(context, length)}, "strings_cmp");
+        return builder.CreateICmpEQ(order, AddInt32Literal(context, 0), "is_0");
+    }
+    Value *isEqual = builder.getTrue();
+    if (length == 0)
+    {
+        return isEqual;
+    }
+    unsigned size = 8;
+    while (size > length)
+    {
+        size /= 2;
+    }
+    for (size_t offset = 0; offset < length; offset += size)
+    {
+        offset = std::min<size_t>(offset, length - size);
+        isEqual = builder.CreateAnd(isEqual, CreateLiteralWordEqual(builder, context, pData, literal, offset, size),
+                                    "same_bytes");
+    }
+    return isEqual;
+}
+
+// Выделяет блок со строкой длины length функцией allocator (malloc или арена)
+//  и возвращает указатель на байты строки.
+Value *CreateStringBlock(IRBuilder<> &builder, CCodegenContext &context, Value *length, uint64_t refcount,
+                         BuiltinFunction allocator)
+{
+    auto *pAllocate = context.GetBuiltinFunction(allocator);
+    Value *size = builder.CreateAdd(length, AddSizeLiteral(context, STRING_HEADER_SIZE), "block_size");
+    Value *pBlock = builder.CreateCall(pAllocate, {size}, "str_block");
+    Value *pData = builder.CreateGEP(pBlock, AddSizeLiteral(context, STRING_HEADER_SIZE), "block_data");
+    builder.CreateStore(AddSizeLiteral(context, refcount), GetRefcountPtr(builder, context, pData));
+    return pData;
+}
+
 // Отображение типов на LLVM-IR:
 // Boolean -> i1
 // Number -> double
-// String -> i8*
+// String -> {i8*, size_t}
+// Int -> i64
 Type *ConvertType(LLVMContext &context, ExpressionType type)
 {
     switch (type)
@@ -108,11 +421,55 @@ Type *ConvertType(LLVMContext &context, ExpressionType type)
     case ExpressionType::Number:
         return Type::getDoubleTy(context);
     case ExpressionType::String:
-        return Type::getInt8PtrTy(context);
+        return GetStringType(context);
+    case ExpressionType::Int:
+        return Type::getInt64Ty(context);
     }
     throw std::logic_error("ConvertType: unkown expression type");
 }
 
+// Отображение флагов FastMath на флаги инструкций LLVM.
+// В LLVM 3.9 переупорядочивание разрешается только вместе с остальными
+//  ослаблениями (unsafe algebra), а contract реализуется через llvm.fmuladd.
+FastMathFlags ConvertFastMathFlags(unsigned flags)
+{
+    FastMathFlags result;
+    if (flags & FastMath::Reassoc)
+    {
+        result.setUnsafeAlgebra();
+    }
+    if (flags & FastMath::NoNaNs)
+    {
+        result.setNoNaNs();
+    }
+    if (flags & FastMath::NoInfs)
+    {
+        result.setNoInfs();
+    }
+    if (flags & FastMath::Reciprocal)
+    {
+        result.setAllowReciprocal();
+    }
+    return result;
+}
+
+// Атрибуты функции сообщают кодогенератору, какие ослабления допустимы.
+void AddFastMathAttributes(Function &fn, unsigned flags)
+{
+    if (flags & FastMath::Reassoc)
+    {
+        fn.addFnAttr("unsafe-fp-math", "true");
+    }
+    if (flags & FastMath::NoNaNs)
+    {
+        fn.addFnAttr("no-nans-fp-math", "true");
+    }
+    if (flags & FastMath::NoInfs)
+    {
+        fn.addFnAttr("no-infs-fp-math", "true");
+    }
+}
+
 class CFunctionScopeLock
 {
 public:
@@ -144,31 +501,55 @@ CManagedStrings::~CManagedStrings()
 
 void CManagedStrings::FreeAll(llvm::IRBuilder<> & builder)
 {
-    auto *pFree = m_context.GetBuiltinFunction(BuiltinFunction::FREE);
+    auto *pRelease = m_context.GetBuiltinFunction(BuiltinFunction::STRING_RELEASE);
     for (llvm::Value *value : m_pointers)
     {
-        builder.CreateCall(pFree, {value});
+        builder.CreateCall(pRelease, {value});
+    }
+}
+
+std::unordered_set<Value *> CManagedStrings::GetPointers() const
+{
+    return m_pointers;
+}
+
+void CManagedStrings::FreeAllExcept(IRBuilder<> &builder, const std::unordered_set<Value *> &kept)
+{
+    auto *pRelease = m_context.GetBuiltinFunction(BuiltinFunction::STRING_RELEASE);
+    for (auto it = m_pointers.begin(); it != m_pointers.end();)
+    {
+        if (kept.count(*it))
+        {
+            ++it;
+        }
+        else
+        {
+            builder.CreateCall(pRelease, {*it});
+            it = m_pointers.erase(it);
+        }
     }
 }
 
 void CManagedStrings::Clear()
 {
     m_pointers.clear();
+    m_temporaries.clear();
 }
 
 Value *CManagedStrings::TakeStringOrCopy(llvm::IRBuilder<> & builder, Value *pString)
 {
-    // Если значение не является указателем, возвращаем это же значение.
-    if (!pString->getType()->isPointerTy())
+    // Если значение не является строкой, возвращаем это же значение.
+    if (!IsStringValue(pString))
     {
         return pString;
     }
     auto it = m_pointers.find(pString);
-    // Если кто-то уже владеет строкой, вызываем strdup, иначе снимаем со своего контроля.
+    // Если кто-то уже владеет строкой или она может лежать на стеке, захватываем ссылку
+    //  на неё (временная строка при этом копируется), иначе снимаем со своего контроля.
     if (it == m_pointers.end())
     {
-        auto pStrdup = m_context.GetBuiltinFunction(BuiltinFunction::STRDUP);
-        return builder.CreateCall(pStrdup, {pString}, "take_str");
+        auto *pRetain = m_context.GetBuiltinFunction(BuiltinFunction::STRING_RETAIN);
+        return builder.CreateCall(pRetain, {pString}, "retained_str");
     }
     else
     {
@@ -179,22 +560,47 @@ Value *CManagedStrings::TakeStringOrCopy(llvm::IRBuilder<> & builder, Value *pSt
 
 void CManagedStrings::Manage(Value *pString)
 {
-    if (m_pointers.count(pString))
+    if (IsManaged(pString))
     {
         throw std::logic_error("Attempt to manage string twice");
     }
     m_pointers.insert(pString);
 }
 
+void CManagedStrings::ManageTemporary(Value *pString)
+{
+    if (IsManaged(pString))
+    {
+        throw std::logic_error("Attempt to manage string twice");
+    }
+    m_temporaries.insert(pString);
+}
+
+bool CManagedStrings::IsManaged(Value *pString) const
+{
+    return m_pointers.count(pString) || m_temporaries.count(pString);
+}
+
+bool CManagedStrings::IsEmpty() const
+{
+    return m_pointers.empty() && m_temporaries.empty();
+}
+
+bool CManagedStrings::HasTemporaries() const
+{
+    return !m_temporaries.empty();
+}
+
 CCodegenContext::CCodegenContext(CFrontendContext &context)
     : m_context(context)
     , m_pLLVMContext(std::make_unique<llvm::LLVMContext>())
     , m_pModule(std::make_unique<llvm::Module>("main module", *m_pLLVMContext))
     , m_expressionStrings(*this)
-    , m_functionStrings(*this)
 {
     m_functions.PushScope();
     InitLibCBuiltins();
+    InitRuntimeBuiltins();
+    InitStringBuiltins();
 }
 
 CCodegenContext::~CCodegenContext()
@@ -211,6 +617,11 @@ void CCodegenContext::PrintError(const std::string &message) const
     m_context.PrintError(message);
 }
 
+void CCodegenContext::PrintNote(const std::string &message) const
+{
+    m_context.PrintNote(message);
+}
+
 LLVMContext &CCodegenContext::GetLLVMContext()
 {
     return *m_pLLVMContext;
@@ -221,6 +632,21 @@ Module &CCodegenContext::GetModule()
     return *m_pModule;
 }
 
+const CodegenOptions &CCodegenContext::GetOptions() const
+{
+    return m_options;
+}
+
+void CCodegenContext::SetOptions(const CodegenOptions &options)
+{
+    m_options = options;
+    // Функции пула совместимы с malloc и free, поэтому для перехода
+    //  на аллокатор libc достаточно переименовать объявления.
+    const bool useLibC = options.useLibCAllocator;
+    m_builtinFunctions[BuiltinFunction::MALLOC]->setName(useLibC ? "malloc" : "pythonish_alloc");
+    m_builtinFunctions[BuiltinFunction::FREE]->setName(useLibC ? "free" : "pythonish_free");
+}
+
 CScopeChain<AllocaInst *> &CCodegenContext::GetVariables()
 {
     return m_variables;
@@ -231,7 +657,45 @@ CScopeChain<Function *> &CCodegenContext::GetFunctions()
     return m_functions;
 }
 
+// Короткий литерал является константой String с байтами внутри значения,
+//  длинный хранится в глобальной константе вместе с заголовком,
+//  счётчик ссылок которого никогда не меняется и равен STRING_INTERNED.
 Constant *CCodegenContext::AddStringLiteral(const std::string &value)
+{
+    auto &elem = m_stringLiterals[value];
+    if (!elem && value.size() <= INLINE_STRING_CAPACITY)
+    {
+        size_t words[2] = {0, 0};
+        std::memcpy(words, value.data(), value.size());
+        words[1] |= static_cast<size_t>(INLINE_TAG | value.size()) << INLINE_TAG_SHIFT;
+        Constant *data = ConstantExpr::getIntToPtr(AddSizeLiteral(*this, words[0]), Type::getInt8PtrTy(*m_pLLVMContext));
+        elem = ConstantStruct::get(GetStringType(*m_pLLVMContext), {data, AddSizeLiteral(*this, words[1])});
+    }
+    if (!elem)
+    {
+        LLVMContext &context = *m_pLLVMContext;
+        Constant *pBytes = ConstantDataArray::getString(context, value, false);
+        Constant *pBlock = ConstantStruct::getAnon(context, {AddSizeLiteral(*this, STRING_INTERNED), pBytes});
+        GlobalVariable *global = new GlobalVariable(*m_pModule, pBlock->getType(), true,
+                                                    GlobalValue::InternalLinkage, pBlock, "str");
+        global->setAlignment(STRING_HEADER_SIZE);
+        Constant *zero = AddInt32Literal(*this, 0);
+        std::vector<Constant*> indices = {zero, AddInt32Literal(*this, 1), zero};
+        Constant *data = ConstantExpr::getInBoundsGetElementPtr(pBlock->getType(), global, indices);
+        Constant *length = AddSizeLiteral(*this, value.size());
+        elem = ConstantStruct::get(GetStringType(context), {data, length});
+    }
+    return elem;
+}
+
+Value *CCodegenContext::CreateString(IRBuilder<> &builder, Value *data, Value *length)
+{
+    Value *str = UndefValue::get(GetStringType(*m_pLLVMContext));
+    str = builder.CreateInsertValue(str, data, {0});
+    return builder.CreateInsertValue(str, length, {1}, "str");
+}
+
+Constant *CCodegenContext::AddCStringLiteral(const std::string &value)
 {
     auto &elem = m_strings[value];
     if (!elem)
@@ -261,9 +725,41 @@ CManagedStrings &CCodegenContext::GetExpressionStrings()
     return m_expressionStrings;
 }
 
-CManagedStrings &CCodegenContext::GetFunctionStrings()
+void CCodegenContext::UseInterning()
+{
+    m_usesInterning = true;
+}
+
+// Если программа интернирует строки, конструктор модуля до вызова main добавляет
+//  длинные литералы в таблицу интернированных строк, чтобы Intern возвращал сами литералы.
+// Иначе таблица не создаётся: равенство литералов и так проверяется по указателям.
+void CCodegenContext::FinishModule()
 {
-    return m_functionStrings;
+    std::vector<Constant *> literals;
+    for (const auto &literal : m_stringLiterals)
+    {
+        if (literal.first.size() > INLINE_STRING_CAPACITY)
+        {
+            literals.push_back(literal.second);
+        }
+    }
+    if (!m_usesInterning || literals.empty())
+    {
+        return;
+    }
+    LLVMContext &context = *m_pLLVMContext;
+    ArrayType *tableType = ArrayType::get(GetStringType(context), literals.size());
+    auto *pTable = new GlobalVariable(*m_pModule, tableType, true, GlobalValue::InternalLinkage,
+                                      ConstantArray::get(tableType, literals), "interned_literals");
+    auto *fnType = llvm::FunctionType::get(llvm::Type::getVoidTy(context), false);
+    auto *fn = llvm::Function::Create(fnType, llvm::Function::InternalLinkage, "intern_literals", m_pModule.get());
+    IRBuilder<> builder(BasicBlock::Create(context, "entry", fn));
+    Constant *zero = AddInt32Literal(*this, 0);
+    Constant *pFirst = ConstantExpr::getInBoundsGetElementPtr(tableType, pTable, ArrayRef<Constant *>{zero, zero});
+    builder.CreateCall(GetBuiltinFunction(BuiltinFunction::INTERN_LITERALS),
+                       {pFirst, AddSizeLiteral(*this, literals.size())});
+    builder.CreateRetVoid();
+    appendToGlobalCtors(*m_pModule, fn, 65535);
 }
 
 void CCodegenContext::InitLibCBuiltins()
@@ -276,52 +772,314 @@ void CCodegenContext::InitLibCBuiltins()
 
     llvm::Type *cStringType = llvm::Type::getInt8PtrTy(context);
     llvm::Type *int32Type = llvm::Type::getInt32Ty(context);
+    llvm::Type *sizeType = GetPointerSizeType(context);
+    // i8 *memcpy(i8* dest, i8* src, size_t count)
+    {
+        auto *fnType = llvm::FunctionType::get(cStringType, {cStringType, cStringType, sizeType}, false);
+        m_builtinFunctions[BuiltinFunction::MEMCPY] = declareFn(fnType, "memcpy");
+    }
+    // i32 memcmp(i8* lhs, i8* rhs, size_t count)
+    {
+        auto *fnType = llvm::FunctionType::get(int32Type, {cStringType, cStringType, sizeType}, false);
+        m_builtinFunctions[BuiltinFunction::MEMCMP] = declareFn(fnType, "memcmp");
+    }
+}
+
+// Функции библиотеки времени выполнения pythonish-runtime (см. runtime/runtime.h).
+void CCodegenContext::InitRuntimeBuiltins()
+{
+    auto & context = *m_pLLVMContext;
+    auto * pModule = m_pModule.get();
+    auto declareFn = [&](llvm::FunctionType *type, const char *name) {
+        return llvm::Function::Create(type, llvm::Function::ExternalLinkage, name, pModule);
+    };
+
+    llvm::Type *bytePtrType = llvm::Type::getInt8PtrTy(context);
     llvm::Type *voidType = llvm::Type::getVoidTy(context);
     llvm::Type *sizeType = GetPointerSizeType(context);
-    // i32 printf(i8* format, ...)
+    // i8 *pythonish_arena_alloc(size_t size)
+    {
+        auto *fnType = llvm::FunctionType::get(bytePtrType, {sizeType}, false);
+        m_builtinFunctions[BuiltinFunction::ARENA_ALLOC] = declareFn(fnType, "pythonish_arena_alloc");
+    }
+    // i8 *pythonish_arena_mark()
+    {
+        auto *fnType = llvm::FunctionType::get(bytePtrType, false);
+        m_builtinFunctions[BuiltinFunction::ARENA_MARK] = declareFn(fnType, "pythonish_arena_mark");
+    }
+    // void pythonish_arena_release(i8 *mark)
+    {
+        auto *fnType = llvm::FunctionType::get(voidType, {bytePtrType}, false);
+        m_builtinFunctions[BuiltinFunction::ARENA_RELEASE] = declareFn(fnType, "pythonish_arena_release");
+    }
+    // i8 *pythonish_alloc(size_t size), совместима с malloc
     {
-        auto *fnType = llvm::FunctionType::get(int32Type, {cStringType}, true);
-        m_builtinFunctions[BuiltinFunction::PRINTF] = declareFn(fnType, "printf");
+        auto *fnType = llvm::FunctionType::get(bytePtrType, {sizeType}, false);
+        llvm::Function *pAlloc = declareFn(fnType, "pythonish_alloc");
+        // Как и для malloc, возвращаемый блок не пересекается с другой памятью.
+        pAlloc->setDoesNotAlias(0);
+        m_builtinFunctions[BuiltinFunction::MALLOC] = pAlloc;
     }
-    // i8 *strcpy(i8* dest, i8* src)
+    // void pythonish_free(i8 *ptr), совместима с free
     {
-        auto *fnType = llvm::FunctionType::get(cStringType, {cStringType, cStringType}, false);
-        m_builtinFunctions[BuiltinFunction::STRCPY] = declareFn(fnType, "strcpy");
+        auto *fnType = llvm::FunctionType::get(voidType, {bytePtrType}, false);
+        m_builtinFunctions[BuiltinFunction::FREE] = declareFn(fnType, "pythonish_free");
     }
-    // i8 *strdup(i8 *str)
+    // void pythonish_write_str(i8 *data, size_t length)
     {
-        auto *fnType = llvm::FunctionType::get(cStringType, {cStringType}, false);
-        m_builtinFunctions[BuiltinFunction::STRDUP] = declareFn(fnType, "strdup");
+        auto *fnType = llvm::FunctionType::get(voidType, {bytePtrType, sizeType}, false);
+        m_builtinFunctions[BuiltinFunction::WRITE_STRING] = declareFn(fnType, "pythonish_write_str");
     }
-    // size_t strlen(i8 *str)
+    // void pythonish_write_num(double value)
     {
-        auto *fnType = llvm::FunctionType::get(sizeType, {cStringType}, false);
-        m_builtinFunctions[BuiltinFunction::STRLEN] = declareFn(fnType, "strlen");
+        auto *fnType = llvm::FunctionType::get(voidType, {llvm::Type::getDoubleTy(context)}, false);
+        m_builtinFunctions[BuiltinFunction::WRITE_NUMBER] = declareFn(fnType, "pythonish_write_num");
     }
-    // i32 strcmp(i8* str, i8* str)
+    // void pythonish_write_int(i64 value)
     {
-        auto *fnType = llvm::FunctionType::get(int32Type, {cStringType, cStringType}, false);
-        m_builtinFunctions[BuiltinFunction::STRCMP] = declareFn(fnType, "strcmp");
+        auto *fnType = llvm::FunctionType::get(voidType, {llvm::Type::getInt64Ty(context)}, false);
+        m_builtinFunctions[BuiltinFunction::WRITE_INT] = declareFn(fnType, "pythonish_write_int");
     }
-    // i8 *malloc(size_t size)
+    // void pythonish_write_bool(i32 value)
     {
-        auto *fnType = llvm::FunctionType::get(cStringType, {sizeType}, false);
-        m_builtinFunctions[BuiltinFunction::MALLOC] = declareFn(fnType, "malloc");
+        auto *fnType = llvm::FunctionType::get(voidType, {llvm::Type::getInt32Ty(context)}, false);
+        m_builtinFunctions[BuiltinFunction::WRITE_BOOLEAN] = declareFn(fnType, "pythonish_write_bool");
     }
-    // void *free(i8 *ptr)
+    // void pythonish_end_line()
     {
-        auto *fnType = llvm::FunctionType::get(voidType, {cStringType}, false);
-        m_builtinFunctions[BuiltinFunction::FREE] = declareFn(fnType, "free");
+        auto *fnType = llvm::FunctionType::get(voidType, false);
+        m_builtinFunctions[BuiltinFunction::END_LINE] = declareFn(fnType, "pythonish_end_line");
+    }
+    // size_t pythonish_format_num(double value, i8 *buffer)
+    {
+        auto *fnType = llvm::FunctionType::get(sizeType, {llvm::Type::getDoubleTy(context), bytePtrType}, false);
+        m_builtinFunctions[BuiltinFunction::FORMAT_NUMBER] = declareFn(fnType, "pythonish_format_num");
+    }
+    // size_t pythonish_format_int(i64 value, i8 *buffer)
+    {
+        auto *fnType = llvm::FunctionType::get(sizeType, {llvm::Type::getInt64Ty(context), bytePtrType}, false);
+        m_builtinFunctions[BuiltinFunction::FORMAT_INT] = declareFn(fnType, "pythonish_format_int");
+    }
+    // i8 *pythonish_intern(i8 *data, size_t length)
+    {
+        auto *fnType = llvm::FunctionType::get(bytePtrType, {bytePtrType, sizeType}, false);
+        m_builtinFunctions[BuiltinFunction::INTERN] = declareFn(fnType, "pythonish_intern");
+    }
+    // void pythonish_intern_literals(String *literals, size_t count)
+    {
+        llvm::Type *literalsType = GetStringType(context)->getPointerTo();
+        auto *fnType = llvm::FunctionType::get(voidType, {literalsType, sizeType}, false);
+        m_builtinFunctions[BuiltinFunction::INTERN_LITERALS] = declareFn(fnType, "pythonish_intern_literals");
+    }
+    // i64 pythonish_find(i8 *data, size_t length, i8 *sub, size_t subLength)
+    {
+        auto *fnType = llvm::FunctionType::get(llvm::Type::getInt64Ty(context),
+                                               {bytePtrType, sizeType, bytePtrType, sizeType}, false);
+        llvm::Function *pFind = declareFn(fnType, "pythonish_find");
+        pFind->setOnlyReadsMemory();
+        m_builtinFunctions[BuiltinFunction::FIND] = pFind;
+    }
+    // Функции ввода получают функции выделения и освобождения строк, см. BuiltinFunction::MALLOC.
+    llvm::Type *allocateType = llvm::FunctionType::get(bytePtrType, {sizeType}, false)->getPointerTo();
+    llvm::Type *freeType = llvm::FunctionType::get(voidType, {bytePtrType}, false)->getPointerTo();
+    // void pythonish_read_line(i8 *(*allocate)(size_t), void (*free)(i8 *), String *line)
+    {
+        llvm::Type *linePtrType = GetStringType(context)->getPointerTo();
+        auto *fnType = llvm::FunctionType::get(voidType, {allocateType, freeType, linePtrType}, false);
+        m_builtinFunctions[BuiltinFunction::READ_LINE] = declareFn(fnType, "pythonish_read_line");
+    }
+    // double pythonish_read_number(i8 *(*allocate)(size_t), void (*free)(i8 *))
+    {
+        auto *fnType = llvm::FunctionType::get(llvm::Type::getDoubleTy(context), {allocateType, freeType}, false);
+        m_builtinFunctions[BuiltinFunction::READ_NUMBER] = declareFn(fnType, "pythonish_read_number");
+    }
+    // i32 pythonish_end_of_input(i8 *(*allocate)(size_t), void (*free)(i8 *))
+    {
+        auto *fnType = llvm::FunctionType::get(llvm::Type::getInt32Ty(context), {allocateType, freeType}, false);
+        m_builtinFunctions[BuiltinFunction::END_OF_INPUT] = declareFn(fnType, "pythonish_end_of_input");
+    }
+    llvm::Type *int64Type = llvm::Type::getInt64Ty(context);
+    // i64 pythonish_open(i8 *path, size_t pathLength, i8 *mode, size_t modeLength)
+    {
+        auto *fnType = llvm::FunctionType::get(int64Type, {bytePtrType, sizeType, bytePtrType, sizeType}, false);
+        m_builtinFunctions[BuiltinFunction::FILE_OPEN] = declareFn(fnType, "pythonish_open");
+    }
+    // void pythonish_read_all(i8 *(*allocate)(size_t), void (*free)(i8 *), i64 file, String *text)
+    {
+        llvm::Type *textPtrType = GetStringType(context)->getPointerTo();
+        auto *fnType = llvm::FunctionType::get(voidType, {allocateType, freeType, int64Type, textPtrType}, false);
+        m_builtinFunctions[BuiltinFunction::FILE_READ_ALL] = declareFn(fnType, "pythonish_read_all");
+    }
+    // i32 pythonish_write_file(i64 file, i8 *data, size_t length), так же - pythonish_write_file_line
+    {
+        auto *fnType = llvm::FunctionType::get(llvm::Type::getInt32Ty(context),
+                                               {int64Type, bytePtrType, sizeType}, false);
+        m_builtinFunctions[BuiltinFunction::FILE_WRITE] = declareFn(fnType, "pythonish_write_file");
+        m_builtinFunctions[BuiltinFunction::FILE_WRITE_LINE] = declareFn(fnType, "pythonish_write_file_line");
+    }
+    // i32 pythonish_close(i64 file)
+    {
+        auto *fnType = llvm::FunctionType::get(llvm::Type::getInt32Ty(context), {int64Type}, false);
+        m_builtinFunctions[BuiltinFunction::FILE_CLOSE] = declareFn(fnType, "pythonish_close");
+    }
+    // void pythonish_print_str(i8 *data, size_t length)
+    {
+        auto *fnType = llvm::FunctionType::get(voidType, {bytePtrType, sizeType}, false);
+        m_builtinFunctions[BuiltinFunction::PRINT_STRING] = declareFn(fnType, "pythonish_print_str");
+    }
+    // void pythonish_print_num(double value)
+    {
+        auto *fnType = llvm::FunctionType::get(voidType, {llvm::Type::getDoubleTy(context)}, false);
+        m_builtinFunctions[BuiltinFunction::PRINT_NUMBER] = declareFn(fnType, "pythonish_print_num");
+    }
+    // void pythonish_print_int(i64 value)
+    {
+        auto *fnType = llvm::FunctionType::get(voidType, {llvm::Type::getInt64Ty(context)}, false);
+        m_builtinFunctions[BuiltinFunction::PRINT_INT] = declareFn(fnType, "pythonish_print_int");
+    }
+    // void pythonish_print_bool(i32 value)
+    {
+        auto *fnType = llvm::FunctionType::get(voidType, {llvm::Type::getInt32Ty(context)}, false);
+        m_builtinFunctions[BuiltinFunction::PRINT_BOOLEAN] = declareFn(fnType, "pythonish_print_bool");
     }
 }
 
-CExpressionCodeGenerator::CExpressionCodeGenerator(llvm::IRBuilder<> &builder, CCodegenContext &context)
+// Функции управления счётчиком ссылок генерируются в модуле и встраиваются оптимизатором.
+void CCodegenContext::InitStringBuiltins()
+{
+    auto & context = *m_pLLVMContext;
+    llvm::Type *stringType = GetStringType(context);
+    IRBuilder<> builder(context);
+    auto defineFn = [&](llvm::Type *returnType, const char *name) {
+        auto *fnType = llvm::FunctionType::get(returnType, {stringType}, false);
+        auto *fn = llvm::Function::Create(fnType, llvm::Function::InternalLinkage, name, m_pModule.get());
+        builder.SetInsertPoint(BasicBlock::Create(context, "entry", fn));
+        return fn;
+    };
+
+    /*** String str_retain(String str) ***
+     * if (isInline(str))
+     *     return str;
+     * size_t *refcount = blockRefcount(str); // у среза - счётчик исходной строки
+     * if (*refcount >= STRING_INTERNED) // литерал или интернированная строка
+     *     return str;
+     * if (*refcount != STRING_TEMPORARY) {
+     *     ++*refcount;
+     *     return str;
+     * }
+     * size_t length = length(str);
+     * char *data = <new block with refcount 1>;
+     * memcpy(data, str.data, length);
+     * return (String){ data, length };
+     */
+    {
+        Function *fn = defineFn(stringType, "str_retain");
+        Value *pString = &*fn->arg_begin();
+        BasicBlock *heapBB = BasicBlock::Create(context, "heap", fn);
+        BasicBlock *checkBB = BasicBlock::Create(context, "check_temporary", fn);
+        BasicBlock *countBB = BasicBlock::Create(context, "count", fn);
+        BasicBlock *copyBB = BasicBlock::Create(context, "copy", fn);
+        BasicBlock *doneBB = BasicBlock::Create(context, "done", fn);
+        builder.CreateCondBr(IsInlineString(builder, *this, pString), doneBB, heapBB);
+
+        builder.SetInsertPoint(heapBB);
+        Value *pRefcount = GetBlockRefcountPtr(builder, *this, pString);
+        Value *refcount = builder.CreateLoad(pRefcount, "refcount");
+        Value *isImmortal = builder.CreateICmpUGE(refcount, AddSizeLiteral(*this, STRING_INTERNED), "is_immortal");
+        builder.CreateCondBr(isImmortal, doneBB, checkBB);
+
+        builder.SetInsertPoint(checkBB);
+        Value *isTemporary = builder.CreateICmpEQ(refcount, AddSizeLiteral(*this, STRING_TEMPORARY), "is_temporary");
+        builder.CreateCondBr(isTemporary, copyBB, countBB);
+
+        builder.SetInsertPoint(countBB);
+        builder.CreateStore(builder.CreateAdd(refcount, AddSizeLiteral(*this, 1), "inc"), pRefcount);
+        builder.CreateBr(doneBB);
+
+        builder.SetInsertPoint(copyBB);
+        Value *pData = builder.CreateExtractValue(pString, {0}, "data");
+        Value *length = GetStringLength(builder, *this, pString);
+        Value *pCopyData = CreateStringBlock(builder, *this, length, 1, BuiltinFunction::MALLOC);
+        builder.CreateCall(GetBuiltinFunction(BuiltinFunction::MEMCPY), {pCopyData, pData, length});
+        builder.CreateRet(CreateString(builder, pCopyData, length));
+
+        builder.SetInsertPoint(doneBB);
+        builder.CreateRet(pString);
+        m_builtinFunctions[BuiltinFunction::STRING_RETAIN] = fn;
+    }
+
+    /*** void str_release(String str) ***
+     * if (isInline(str))
+     *     return;
+     * size_t *refcount = blockRefcount(str);
+     * if (*refcount < STRING_INTERNED && --*refcount == 0)
+     *     free(refcount);
+     */
+    {
+        Function *fn = defineFn(llvm::Type::getVoidTy(context), "str_release");
+        Value *pString = &*fn->arg_begin();
+        BasicBlock *heapBB = BasicBlock::Create(context, "heap", fn);
+        BasicBlock *releaseBB = BasicBlock::Create(context, "release", fn);
+        BasicBlock *freeBB = BasicBlock::Create(context, "free", fn);
+        BasicBlock *keepBB = BasicBlock::Create(context, "keep", fn);
+        BasicBlock *doneBB = BasicBlock::Create(context, "done", fn);
+        builder.CreateCondBr(IsInlineString(builder, *this, pString), doneBB, heapBB);
+
+        builder.SetInsertPoint(heapBB);
+        Value *pRefcount = GetBlockRefcountPtr(builder, *this, pString);
+        Value *refcount = builder.CreateLoad(pRefcount, "refcount");
+        Value *isImmortal = builder.CreateICmpUGE(refcount, AddSizeLiteral(*this, STRING_INTERNED), "is_immortal");
+        builder.CreateCondBr(isImmortal, doneBB, releaseBB);
+
+        builder.SetInsertPoint(releaseBB);
+        Value *decremented = builder.CreateSub(refcount, AddSizeLiteral(*this, 1), "dec");
+        Value *isDead = builder.CreateICmpEQ(decremented, AddSizeLiteral(*this, 0), "is_dead");
+        builder.CreateCondBr(isDead, freeBB, keepBB);
+
+        builder.SetInsertPoint(freeBB);
+        Value *pBlock = builder.CreateBitCast(pRefcount, builder.getInt8PtrTy(), "block");
+        builder.CreateCall(GetBuiltinFunction(BuiltinFunction::FREE), {pBlock});
+        builder.CreateBr(doneBB);
+
+        builder.SetInsertPoint(keepBB);
+        builder.CreateStore(decremented, pRefcount);
+        builder.CreateBr(doneBB);
+
+        builder.SetInsertPoint(doneBB);
+        builder.CreateRetVoid();
+        m_builtinFunctions[BuiltinFunction::STRING_RELEASE] = fn;
+    }
+}
+
+CExpressionCodeGenerator::CExpressionCodeGenerator(llvm::IRBuilder<> &builder, CCodegenContext &context,
+                                                   const FunctionAnalysis &analysis)
     : m_context(context)
     , m_builder(builder)
+    , m_analysis(analysis)
 {
 }
 
 Value *CExpressionCodeGenerator::Codegen(IExpressionAST &ast)
+{
+    try
+    {
+        m_values.clear();
+        ast.Accept(*this);
+        Value *pValue = m_values.at(0);
+        if (ast.GetType() == ExpressionType::Number)
+        {
+            pValue = ConvertToDouble(pValue);
+        }
+        return pValue;
+    }
+    catch (std::exception const& ex)
+    {
+        m_context.PrintError(ex.what());
+        return nullptr;
+    }
+}
+
+Value *CExpressionCodeGenerator::CodegenIntegral(IExpressionAST &ast)
 {
     try
     {
@@ -338,6 +1096,21 @@ Value *CExpressionCodeGenerator::Codegen(IExpressionAST &ast)
 
 void CExpressionCodeGenerator::Visit(CBinaryExpressionAST &expr)
 {
+    // Из операций над строками строку возвращает только конкатенация.
+    if (expr.GetType() == ExpressionType::String)
+    {
+        m_values.push_back(GenerateConcatenation(expr));
+        return;
+    }
+    if (expr.GetOperation() == BinaryOperation::And || expr.GetOperation() == BinaryOperation::Or)
+    {
+        m_values.push_back(GenerateLogicalExpr(expr));
+        return;
+    }
+    if (expr.GetLeft().GetType() == ExpressionType::String && TryGenerateLiteralCompare(expr))
+    {
+        return;
+    }
     expr.GetLeft().Accept(*this);
     expr.GetRight().Accept(*this);
     Value *a = m_values.at(m_values.size() - 2);
@@ -351,11 +1124,26 @@ void CExpressionCodeGenerator::Visit(CBinaryExpressionAST &expr)
         pValue = GenerateBooleanExpr(a, expr.GetOperation(), b);
         break;
     case ExpressionType::Number:
-        pValue = GenerateNumericExpr(a, expr.GetOperation(), b);
+    {
+        // Сравнение двух целочисленных операндов тоже выполняется в i64.
+        const bool isIntegerCompare = (expr.GetType() == ExpressionType::Boolean)
+                && a->getType()->isIntegerTy() && b->getType()->isIntegerTy();
+        if (IsIntegral(expr) || isIntegerCompare)
+        {
+            pValue = GenerateIntegerExpr(a, expr.GetOperation(), b);
+        }
+        else
+        {
+            pValue = GenerateNumericExpr(ConvertToDouble(a), expr.GetOperation(), ConvertToDouble(b));
+        }
         break;
+    }
     case ExpressionType::String:
         pValue = GenerateStringExpr(a, expr.GetOperation(), b);
         break;
+    case ExpressionType::Int:
+        pValue = GenerateIntExpr(a, expr.GetOperation(), b);
+        break;
     }
     m_values.push_back(pValue);
 }
@@ -365,38 +1153,307 @@ void CExpressionCodeGenerator::Visit(CUnaryExpressionAST &expr)
     expr.GetOperand().Accept(*this);
     Value *x = m_values.back();
     m_values.pop_back();
-    auto pValue = GenerateUnaryExpr(m_builder, m_context.GetLLVMContext(), expr.GetOperation(), x);
+    Value *pValue = nullptr;
+    if (expr.GetOperation() == UnaryOperation::LogicalNot)
+    {
+        pValue = m_builder.CreateNot(x, "nottmp");
+    }
+    else if (expr.GetType() == ExpressionType::Int)
+    {
+        switch (expr.GetOperation())
+        {
+        case UnaryOperation::Plus:
+            pValue = x;
+            break;
+        case UnaryOperation::Minus:
+            pValue = m_builder.CreateNeg(x, "negtmp");
+            break;
+        case UnaryOperation::BitwiseNot:
+            pValue = m_builder.CreateNot(x, "nottmp");
+            break;
+        case UnaryOperation::LogicalNot:
+            break;
+        }
+    }
+    else if (IsIntegral(expr))
+    {
+        const bool isMinus = (expr.GetOperation() == UnaryOperation::Minus);
+        pValue = isMinus ? m_builder.CreateNSWNeg(x, "negtmp") : x;
+    }
+    else
+    {
+        pValue = GenerateUnaryExpr(m_builder, m_context.GetLLVMContext(), expr.GetOperation(), ConvertToDouble(x));
+    }
     m_values.push_back(pValue);
 }
 
 void CExpressionCodeGenerator::Visit(CLiteralAST &expr)
 {
+    if (IsIntegral(expr) || expr.GetType() == ExpressionType::Int)
+    {
+        m_values.push_back(AddInt64Literal(m_context, GetIntegerLiteralValue(expr)));
+        return;
+    }
     LiteralCodeGenerator generator(m_context);
     Value *pValue = expr.GetValue().apply_visitor(generator);
     m_values.push_back(pValue);
 }
 
-void CExpressionCodeGenerator::Visit(CCallAST &expr)
+std::vector<Value *> CExpressionCodeGenerator::CodegenArguments(CCallAST &expr)
 {
-    Function *pFunction = *m_context.GetFunctions().GetSymbol(expr.GetFunctionNameId());
-
     std::vector<Value *> args;
     // swap arguments to visit and codegen
     std::swap(args, m_values);
     for (const IExpressionASTUniquePtr & subexpr : expr.GetArguments())
     {
         subexpr->Accept(*this);
+        if (subexpr->GetType() == ExpressionType::Number)
+        {
+            m_values.back() = ConvertToDouble(m_values.back());
+        }
     }
     std::swap(args, m_values);
 
-    Value *pValue = m_builder.CreateCall(pFunction, args, "calltmp");
-    if (pValue->getType()->isPointerTy())
+    return args;
+}
+
+CallInst *CExpressionCodeGenerator::CreateCall(CCallAST &expr, ArrayRef<Value *> args)
+{
+    Function *pFunction = *m_context.GetFunctions().GetSymbol(expr.GetFunctionNameId());
+    CallInst *pCall = m_builder.CreateCall(pFunction, args, "calltmp");
+    // Соглашение о вызове в call и в объявлении функции должно совпадать.
+    pCall->setCallingConv(pFunction->getCallingConv());
+
+    return pCall;
+}
+
+Value *CExpressionCodeGenerator::GetArenaMark() const
+{
+    return m_pArenaMark;
+}
+
+void CExpressionCodeGenerator::SetFastMathFlags(unsigned flags)
+{
+    m_fastMathFlags = flags;
+}
+
+void CExpressionCodeGenerator::Visit(CCallAST &expr)
+{
+    std::vector<Value *> args = CodegenArguments(expr);
+    // Функция программы скрывает встроенную функцию с тем же именем.
+    if (!m_context.GetFunctions().HasSymbol(expr.GetFunctionNameId()))
+    {
+        const BuiltinSignature &builtin = *FindBuiltinCall(m_context.GetString(expr.GetFunctionNameId()));
+        m_values.push_back(GenerateBuiltinCall(expr, builtin.id, args));
+        return;
+    }
+    Value *pValue = CreateCall(expr, args);
+    if (IsStringValue(pValue))
     {
         m_context.GetExpressionStrings().Manage(pValue);
     }
     m_values.push_back(pValue);
 }
 
+Value *CExpressionCodeGenerator::GenerateBuiltinCall(CCallAST &expr, BuiltinCall id, ArrayRef<Value *> args)
+{
+    switch (id)
+    {
+    case BuiltinCall::Intern:
+        return GenerateIntern(args[0]);
+    case BuiltinCall::Length:
+        return GetStringLength(m_builder, m_context, args[0]);
+    case BuiltinCall::Find:
+        return GenerateFind(args[0], args[1]);
+    case BuiltinCall::StartsWith:
+        return GenerateStartsWith(expr, args[0], args[1]);
+    case BuiltinCall::Copy:
+    {
+        StringPiece piece = {GetStringData(m_builder, m_context, args[0]), GetStringLength(m_builder, m_context, args[0])};
+        return CreateStringFromPieces(piece, IsTemporary(expr));
+    }
+    case BuiltinCall::ReadLine:
+        return GenerateReadString(BuiltinFunction::READ_LINE, {});
+    case BuiltinCall::ReadNumber:
+        return m_builder.CreateCall(m_context.GetBuiltinFunction(BuiltinFunction::READ_NUMBER),
+                                    {m_context.GetBuiltinFunction(BuiltinFunction::MALLOC),
+                                     m_context.GetBuiltinFunction(BuiltinFunction::FREE)}, "number");
+    case BuiltinCall::EndOfInput:
+    {
+        Value *isEnd = m_builder.CreateCall(m_context.GetBuiltinFunction(BuiltinFunction::END_OF_INPUT),
+                                            {m_context.GetBuiltinFunction(BuiltinFunction::MALLOC),
+                                             m_context.GetBuiltinFunction(BuiltinFunction::FREE)}, "end_of_input");
+        return m_builder.CreateICmpNE(isEnd, AddInt32Literal(m_context, 0), "is_end");
+    }
+    case BuiltinCall::Open:
+        return m_builder.CreateCall(m_context.GetBuiltinFunction(BuiltinFunction::FILE_OPEN),
+                                    {GetStringData(m_builder, m_context, args[0]),
+                                     GetStringLength(m_builder, m_context, args[0]),
+                                     GetStringData(m_builder, m_context, args[1]),
+                                     GetStringLength(m_builder, m_context, args[1])}, "file");
+    case BuiltinCall::ReadAll:
+        return GenerateReadString(BuiltinFunction::FILE_READ_ALL, {args[0]});
+    case BuiltinCall::WriteString:
+    case BuiltinCall::WriteLine:
+    {
+        BuiltinFunction writeFn = (id == BuiltinCall::WriteString) ? BuiltinFunction::FILE_WRITE
+                                                                   : BuiltinFunction::FILE_WRITE_LINE;
+        Value *isOk = m_builder.CreateCall(m_context.GetBuiltinFunction(writeFn),
+                                           {args[0], GetStringData(m_builder, m_context, args[1]),
+                                            GetStringLength(m_builder, m_context, args[1])}, "write_result");
+        return m_builder.CreateICmpNE(isOk, AddInt32Literal(m_context, 0), "is_written");
+    }
+    case BuiltinCall::Close:
+    {
+        Value *isOk = m_builder.CreateCall(m_context.GetBuiltinFunction(BuiltinFunction::FILE_CLOSE),
+                                           {args[0]}, "close_result");
+        return m_builder.CreateICmpNE(isOk, AddInt32Literal(m_context, 0), "is_closed");
+    }
+    case BuiltinCall::Sqrt:
+        return GenerateSqrt(args[0]);
+    case BuiltinCall::Abs:
+        return CreateMathIntrinsic(Intrinsic::fabs, args);
+    case BuiltinCall::Floor:
+        return CreateMathIntrinsic(Intrinsic::floor, args);
+    case BuiltinCall::Ceil:
+        return CreateMathIntrinsic(Intrinsic::ceil, args);
+    case BuiltinCall::Pow:
+        return CreateMathIntrinsic(Intrinsic::pow, args);
+    case BuiltinCall::Min:
+        return CreateMathIntrinsic(Intrinsic::minnum, args);
+    case BuiltinCall::Max:
+        return CreateMathIntrinsic(Intrinsic::maxnum, args);
+    case BuiltinCall::Fma:
+        return CreateMathIntrinsic(Intrinsic::fma, args);
+    }
+    throw std::logic_error("GenerateBuiltinCall: unknown builtin function");
+}
+
+// Короткая или уже интернированная строка возвращается как есть, остальные - через таблицу:
+//   if (isInline(s) || (!isView(s) && *refcount(s) == STRING_INTERNED))
+//       return s;
+//   return (String){ pythonish_intern(s.data, length(s)), length(s) };
+// Результат бессмертен, поэтому не требует освобождения.
+Value *CExpressionCodeGenerator::GenerateIntern(Value *pString)
+{
+    m_context.UseInterning();
+    LLVMContext &context = m_context.GetLLVMContext();
+    Function *pFunction = m_builder.GetInsertBlock()->getParent();
+    BasicBlock *startBB = m_builder.GetInsertBlock();
+    BasicBlock *heapBB = BasicBlock::Create(context, "intern_heap", pFunction);
+    BasicBlock *insertBB = BasicBlock::Create(context, "intern_insert", pFunction);
+    BasicBlock *doneBB = BasicBlock::Create(context, "intern_done", pFunction);
+    m_builder.CreateCondBr(IsInlineString(m_builder, m_context, pString), doneBB, heapBB);
+
+    m_builder.SetInsertPoint(heapBB);
+    Value *pData = m_builder.CreateExtractValue(pString, {0}, "data");
+    Value *pRefcount = GetBlockRefcountPtr(m_builder, m_context, pString);
+    Value *refcount = m_builder.CreateLoad(pRefcount, "refcount");
+    Value *isInterned = m_builder.CreateAnd(m_builder.CreateNot(IsViewString(m_builder, m_context, pString)),
+                                            m_builder.CreateICmpEQ(refcount, AddSizeLiteral(m_context, STRING_INTERNED)),
+                                            "is_interned");
+    m_builder.CreateCondBr(isInterned, doneBB, insertBB);
+
+    m_builder.SetInsertPoint(insertBB);
+    Value *length = GetStringLength(m_builder, m_context, pString);
+    auto *pIntern = m_context.GetBuiltinFunction(BuiltinFunction::INTERN);
+    Value *pInternedData = m_builder.CreateCall(pIntern, {pData, length}, "interned_data");
+    Value *pInterned = m_context.CreateString(m_builder, pInternedData, length);
+    m_builder.CreateBr(doneBB);
+
+    m_builder.SetInsertPoint(doneBB);
+    PHINode *result = m_builder.CreatePHI(pString->getType(), 3, "interned");
+    result->addIncoming(pString, startBB);
+    result->addIncoming(pString, heapBB);
+    result->addIncoming(pInterned, insertBB);
+    return result;
+}
+
+Value *CExpressionCodeGenerator::GenerateFind(Value *pString, Value *pSubstring)
+{
+    auto *pFind = m_context.GetBuiltinFunction(BuiltinFunction::FIND);
+    return m_builder.CreateCall(pFind, {GetStringData(m_builder, m_context, pString),
+                                        GetStringLength(m_builder, m_context, pString),
+                                        GetStringData(m_builder, m_context, pSubstring),
+                                        GetStringLength(m_builder, m_context, pSubstring)}, "found_at");
+}
+
+Value *CExpressionCodeGenerator::CreateMathIntrinsic(Intrinsic::ID id, ArrayRef<Value *> args)
+{
+    Function *pIntrinsic = Intrinsic::getDeclaration(&m_context.GetModule(), id,
+                                                     {Type::getDoubleTy(m_context.GetLLVMContext())});
+    return m_builder.CreateCall(pIntrinsic, args, "mathtmp");
+}
+
+// В LLVM 3.9 llvm.sqrt от отрицательного числа не определён, поэтому без флага nnan
+//  корень защищён выбором, который, как и сам llvm.sqrt, векторизуется:
+//   x < 0 ? NaN : llvm.sqrt(x)
+Value *CExpressionCodeGenerator::GenerateSqrt(Value *x)
+{
+    Value *root = CreateMathIntrinsic(Intrinsic::sqrt, {x});
+    if (m_fastMathFlags & FastMath::NoNaNs)
+    {
+        return root;
+    }
+    Value *isNegative = m_builder.CreateFCmpOLT(x, ConstantFP::get(x->getType(), 0.0), "is_negative");
+    return m_builder.CreateSelect(isNegative, ConstantFP::getNaN(x->getType()), root, "sqrttmp");
+}
+
+// Прочитанная строка, как и результат вызова функции, принадлежит выражению:
+//  длинная строка ввода - срез блока ввода, владеющий ссылкой на него,
+//  а текст файла - блок в куче или отображённый в память файл.
+Value *CExpressionCodeGenerator::GenerateReadString(BuiltinFunction id, ArrayRef<Value *> args)
+{
+    Function *pFunction = m_builder.GetInsertBlock()->getParent();
+    AllocaInst *pSlot = MakeLocalVariable(*pFunction, *GetStringType(m_context.GetLLVMContext()), "read_slot");
+    std::vector<Value *> callArgs = {m_context.GetBuiltinFunction(BuiltinFunction::MALLOC),
+                                     m_context.GetBuiltinFunction(BuiltinFunction::FREE)};
+    callArgs.insert(callArgs.end(), args.begin(), args.end());
+    callArgs.push_back(pSlot);
+    m_builder.CreateCall(m_context.GetBuiltinFunction(id), callArgs);
+    Value *pString = m_builder.CreateLoad(pSlot, "read_string");
+    m_context.GetExpressionStrings().Manage(pString);
+    return pString;
+}
+
+// Префикс-литерал сравнивается словами, как в GenerateLiteralEquals, остальные - memcmp:
+//   length(s) >= length(prefix) && memcmp(s.data, prefix.data, length(prefix)) == 0
+Value *CExpressionCodeGenerator::GenerateStartsWith(CCallAST &expr, Value *pString, Value *pPrefix)
+{
+    LLVMContext &context = m_context.GetLLVMContext();
+    Function *pFunction = m_builder.GetInsertBlock()->getParent();
+    BasicBlock *startBB = m_builder.GetInsertBlock();
+    BasicBlock *compareBB = BasicBlock::Create(context, "starts_with_bytes", pFunction);
+    BasicBlock *doneBB = BasicBlock::Create(context, "starts_with_done", pFunction);
+    Value *length = GetStringLength(m_builder, m_context, pString);
+    Value *prefixLength = GetStringLength(m_builder, m_context, pPrefix);
+    Value *isLongEnough = m_builder.CreateICmpUGE(length, prefixLength, "long_enough");
+    m_builder.CreateCondBr(isLongEnough, compareBB, doneBB);
+
+    m_builder.SetInsertPoint(compareBB);
+    Value *pData = GetStringData(m_builder, m_context, pString);
+    Value *isSamePrefix = nullptr;
+    if (const std::string *pLiteral = GetStringLiteral(*expr.GetArguments().at(1)))
+    {
+        isSamePrefix = CreateLiteralBytesEqual(m_builder, m_context, pData, *pLiteral);
+    }
+    else
+    {
+        auto *pMemcmp = m_context.GetBuiltinFunction(BuiltinFunction::MEMCMP);
+        Value *order = m_builder.CreateCall(pMemcmp, {pData, GetStringData(m_builder, m_context, pPrefix),
+                                                      prefixLength}, "prefix_cmp");
+        isSamePrefix = m_builder.CreateICmpEQ(order, AddInt32Literal(m_context, 0), "is_0");
+    }
+    BasicBlock *compareEndBB = m_builder.GetInsertBlock();
+    m_builder.CreateBr(doneBB);
+
+    m_builder.SetInsertPoint(doneBB);
+    PHINode *result = m_builder.CreatePHI(Type::getInt1Ty(context), 2, "starts_with");
+    result->addIncoming(ConstantInt::getFalse(context), startBB);
+    result->addIncoming(isSamePrefix, compareEndBB);
+    return result;
+}
+
 void CExpressionCodeGenerator::Visit(CVariableRefAST &expr)
 {
     AllocaInst *pVar = *m_context.GetVariables().GetSymbol(expr.GetNameId());
@@ -405,6 +1462,143 @@ void CExpressionCodeGenerator::Visit(CVariableRefAST &expr)
     m_values.push_back(pValue);
 }
 
+void CExpressionCodeGenerator::Visit(CConversionAST &expr)
+{
+    expr.GetOperand().Accept(*this);
+    Value *x = m_values.back();
+    m_values.pop_back();
+    const ExpressionType sourceType = expr.GetOperand().GetType();
+    Value *pValue = x;
+    if (expr.GetType() == ExpressionType::String && sourceType != ExpressionType::String)
+    {
+        pValue = GenerateToString(x, sourceType, IsTemporary(expr));
+    }
+    else if (sourceType == ExpressionType::Int && expr.GetType() == ExpressionType::Number)
+    {
+        pValue = m_builder.CreateSIToFP(x, Type::getDoubleTy(m_context.GetLLVMContext()), "itofp");
+    }
+    else if (sourceType == ExpressionType::Number && expr.GetType() == ExpressionType::Int)
+    {
+        // Суженное значение Number уже хранится в i64.
+        if (!x->getType()->isIntegerTy())
+        {
+            pValue = GenerateDoubleToInt(x);
+        }
+    }
+    else if (sourceType == ExpressionType::Number)
+    {
+        pValue = ConvertToDouble(x);
+    }
+    m_values.push_back(pValue);
+}
+
+// Как в Python, отрицательная граница среза `s[begin:end]` отсчитывается от конца строки,
+//  затем границы приводятся к 0 <= begin <= end <= length(s).
+// Пропущенное начало равно 0, пропущенный конец - длине строки.
+void CExpressionCodeGenerator::Visit(CSliceAST &expr)
+{
+    expr.GetOperand().Accept(*this);
+    Value *pString = m_values.back();
+    m_values.pop_back();
+    Value *length = GetStringLength(m_builder, m_context, pString);
+    auto codegenBound = [&](IExpressionAST *pBound, Value *min, Value *defaultValue) {
+        if (!pBound)
+        {
+            return defaultValue;
+        }
+        pBound->Accept(*this);
+        Value *bound = m_values.back();
+        m_values.pop_back();
+        Value *isFromEnd = m_builder.CreateICmpSLT(bound, AddSizeLiteral(m_context, 0), "is_from_end");
+        bound = m_builder.CreateSelect(isFromEnd, m_builder.CreateAdd(bound, length), bound, "bound");
+        bound = m_builder.CreateSelect(m_builder.CreateICmpSLT(bound, min), min, bound, "bound");
+        return m_builder.CreateSelect(m_builder.CreateICmpSGT(bound, length), length, bound, "bound");
+    };
+    Value *begin = codegenBound(expr.GetBegin(), AddSizeLiteral(m_context, 0), AddSizeLiteral(m_context, 0));
+    Value *end = codegenBound(expr.GetEnd(), begin, length);
+    m_values.push_back(GenerateSlice(pString, begin, end, IsTemporary(expr)));
+}
+
+// Короткий срез копируется в значение String, длинный ссылается на байты исходной строки:
+//   if (end - begin <= INLINE_STRING_CAPACITY)
+//       return <короткая строка из байт s.data + begin>;
+//   size_t offset = viewOffset(s) + begin;
+//   if (offset > VIEW_MAX_OFFSET || end - begin > VIEW_MAX_LENGTH)
+//       return <новая строка с копией байт, как у Copy(s)>;
+//   String view = { s.data + begin, VIEW_TAG | (offset << VIEW_OFFSET_SHIFT) | (end - begin) };
+//   return isTemporary ? view : str_retain(view);
+// Временный срез, как и исходная строка, живёт до конца оператора и не владеет ссылкой.
+// Сохраняемый срез временной строки str_retain копирует в кучу, у остальных строк увеличивает счётчик.
+// Копия среза, который не помещается в поле length, временна, если временен сам срез.
+Value *CExpressionCodeGenerator::GenerateSlice(Value *pString, Value *begin, Value *end, bool isTemporary)
+{
+    LLVMContext &context = m_context.GetLLVMContext();
+    Function *pFunction = m_builder.GetInsertBlock()->getParent();
+    BasicBlock *inlineBB = BasicBlock::Create(context, "slice_inline", pFunction);
+    BasicBlock *viewBB = BasicBlock::Create(context, "slice_view", pFunction);
+    BasicBlock *copyBB = BasicBlock::Create(context, "slice_copy", pFunction);
+    BasicBlock *refBB = BasicBlock::Create(context, "slice_ref", pFunction);
+    BasicBlock *doneBB = BasicBlock::Create(context, "slice_done", pFunction);
+    Value *pData = GetStringData(m_builder, m_context, pString);
+    Value *pSliceData = m_builder.CreateGEP(pData, begin, "slice_data");
+    Value *length = m_builder.CreateSub(end, begin, "slice_length");
+    Value *isInline = m_builder.CreateICmpULE(length, AddSizeLiteral(m_context, INLINE_STRING_CAPACITY), "is_inline");
+    m_builder.CreateCondBr(isInline, inlineBB, viewBB);
+
+    m_builder.SetInsertPoint(inlineBB);
+    Type *stringType = GetStringType(context);
+    AllocaInst *pInlineSlot = MakeLocalVariable(*pFunction, *stringType, "inline_slice");
+    m_builder.CreateStore(Constant::getNullValue(stringType), pInlineSlot);
+    Value *pInlineData = m_builder.CreateBitCast(pInlineSlot, m_builder.getInt8PtrTy(), "inline_data");
+    m_builder.CreateCall(m_context.GetBuiltinFunction(BuiltinFunction::MEMCPY), {pInlineData, pSliceData, length});
+    Value *inlineStr = LoadInlineString(m_builder, m_context, pInlineSlot, length);
+    m_builder.CreateBr(doneBB);
+
+    m_builder.SetInsertPoint(viewBB);
+    Value *lengthWord = m_builder.CreateExtractValue(pString, {1}, "length_word");
+    Value *parentOffset = m_builder.CreateAnd(m_builder.CreateLShr(lengthWord, VIEW_OFFSET_SHIFT),
+                                              AddSizeLiteral(m_context, VIEW_MAX_OFFSET), "parent_offset");
+    parentOffset = m_builder.CreateSelect(IsViewString(m_builder, m_context, pString), parentOffset,
+                                          AddSizeLiteral(m_context, 0), "parent_offset");
+    Value *offset = m_builder.CreateAdd(parentOffset, begin, "view_offset");
+    Value *isTooLong = m_builder.CreateOr(m_builder.CreateICmpUGT(offset, AddSizeLiteral(m_context, VIEW_MAX_OFFSET)),
+                                          m_builder.CreateICmpUGT(length, AddSizeLiteral(m_context, VIEW_MAX_LENGTH)),
+                                          "is_too_long");
+    m_builder.CreateCondBr(isTooLong, copyBB, refBB, MDBuilder(context).createBranchWeights(1, 1 << 20));
+    m_builder.SetInsertPoint(copyBB);
+    Value *copyStr = AllocateString(length, isTemporary);
+    Value *pCopyData = m_builder.CreateExtractValue(copyStr, {0}, "copy_data");
+    m_builder.CreateCall(m_context.GetBuiltinFunction(BuiltinFunction::MEMCPY), {pCopyData, pSliceData, length});
+    BasicBlock *copyEndBB = m_builder.GetInsertBlock();
+    m_builder.CreateBr(doneBB);
+
+    m_builder.SetInsertPoint(refBB);
+    Value *viewWord = m_builder.CreateOr(m_builder.CreateShl(offset, VIEW_OFFSET_SHIFT), length, "view_word");
+    viewWord = m_builder.CreateOr(viewWord, AddSizeLiteral(m_context, VIEW_TAG), "view_word");
+    Value *viewStr = m_context.CreateString(m_builder, pSliceData, viewWord);
+    if (!isTemporary)
+    {
+        viewStr = m_builder.CreateCall(m_context.GetBuiltinFunction(BuiltinFunction::STRING_RETAIN), {viewStr},
+                                       "owned_view");
+    }
+    m_builder.CreateBr(doneBB);
+
+    m_builder.SetInsertPoint(doneBB);
+    PHINode *result = m_builder.CreatePHI(stringType, 3, "slice");
+    result->addIncoming(inlineStr, inlineBB);
+    result->addIncoming(viewStr, refBB);
+    result->addIncoming(copyStr, copyEndBB);
+    if (isTemporary)
+    {
+        m_context.GetExpressionStrings().ManageTemporary(result);
+    }
+    else
+    {
+        m_context.GetExpressionStrings().Manage(result);
+    }
+    return result;
+}
+
 void CExpressionCodeGenerator::Visit(CParameterDeclAST &expr)
 {
     LLVMContext &context = m_context.GetLLVMContext();
@@ -418,6 +1612,10 @@ void CExpressionCodeGenerator::Visit(CParameterDeclAST &expr)
 
 Value *CExpressionCodeGenerator::GenerateNumericExpr(Value *a, BinaryOperation op, Value *b)
 {
+    if (Value *pFused = TryGenerateFMulAdd(a, op, b))
+    {
+        return pFused;
+    }
     switch (op)
     {
     case BinaryOperation::Add:
@@ -427,6 +1625,10 @@ Value *CExpressionCodeGenerator::GenerateNumericExpr(Value *a, BinaryOperation o
     case BinaryOperation::Multiply:
         return m_builder.CreateFMul(a, b, "multmp");
     case BinaryOperation::Divide:
+        if (Value *pProduct = TryGenerateReciprocalMul(a, b))
+        {
+            return pProduct;
+        }
         return m_builder.CreateFDiv(a, b, "divtmp");
     case BinaryOperation::Modulo:
         return m_builder.CreateFRem(a, b, "modtmp");
@@ -434,52 +1636,583 @@ Value *CExpressionCodeGenerator::GenerateNumericExpr(Value *a, BinaryOperation o
         return m_builder.CreateFCmpULT(a, b, "cmptmp");
     case BinaryOperation::Equals:
         return m_builder.CreateFCmpUEQ(a, b, "cmptmp");
+    // Как и `<` и `==`, сравнения с NaN истинны, а `!=` - отрицание `==`.
+    case BinaryOperation::NotEquals:
+        return m_builder.CreateFCmpONE(a, b, "cmptmp");
+    case BinaryOperation::Greater:
+        return m_builder.CreateFCmpUGT(a, b, "cmptmp");
+    case BinaryOperation::LessOrEquals:
+        return m_builder.CreateFCmpULE(a, b, "cmptmp");
+    case BinaryOperation::GreaterOrEquals:
+        return m_builder.CreateFCmpUGE(a, b, "cmptmp");
+    case BinaryOperation::And:
+    case BinaryOperation::Or:
+        // handled by GenerateLogicalExpr.
+        break;
+    case BinaryOperation::BitwiseAnd:
+    case BinaryOperation::BitwiseOr:
+    case BinaryOperation::BitwiseXor:
+    case BinaryOperation::ShiftLeft:
+    case BinaryOperation::ShiftRight:
+        // disallowed for Number.
+        break;
     }
     throw std::runtime_error("CExpressionCodeGenerator: unknown numeric binary operation");
 }
 
-Value *CExpressionCodeGenerator::GenerateStringExpr(Value *a, BinaryOperation op, Value *b)
+// При включённом флаге contract заменяет `x * y + z` и `x * y - z` на llvm.fmuladd,
+//  если результат умножения больше нигде не используется.
+Value *CExpressionCodeGenerator::TryGenerateFMulAdd(Value *a, BinaryOperation op, Value *b)
+{
+    if (!(m_fastMathFlags & FastMath::Contract)
+            || (op != BinaryOperation::Add && op != BinaryOperation::Substract))
+    {
+        return nullptr;
+    }
+    auto asFreeMul = [](Value *pValue) -> BinaryOperator * {
+        auto *pMul = dyn_cast<BinaryOperator>(pValue);
+        if (pMul && pMul->getOpcode() == Instruction::FMul && pMul->use_empty())
+        {
+            return pMul;
+        }
+        return nullptr;
+    };
+
+    BinaryOperator *pMul = asFreeMul(a);
+    const bool isMulLeft = (pMul != nullptr);
+    if (!pMul)
+    {
+        pMul = asFreeMul(b);
+    }
+    if (!pMul)
+    {
+        return nullptr;
+    }
+
+    Value *x = pMul->getOperand(0);
+    Value *y = pMul->getOperand(1);
+    Value *addend = isMulLeft ? b : a;
+    if (op == BinaryOperation::Substract)
+    {
+        // x * y - z = fmuladd(x, y, -z), z - x * y = fmuladd(-x, y, z)
+        if (isMulLeft)
+        {
+            addend = m_builder.CreateFNeg(addend, "negtmp");
+        }
+        else
+        {
+            x = m_builder.CreateFNeg(x, "negtmp");
+        }
+    }
+    Function *pFMulAdd = Intrinsic::getDeclaration(&m_context.GetModule(), Intrinsic::fmuladd,
+                                                   {Type::getDoubleTy(m_context.GetLLVMContext())});
+    Value *pValue = m_builder.CreateCall(pFMulAdd, {x, y, addend}, "fmuladdtmp");
+    pMul->eraseFromParent();
+
+    return pValue;
+}
+
+// Заменяет деление на константу умножением на обратное значение.
+// Если обратное значение представимо точно (степени двойки), замена не меняет
+//  результат и выполняется всегда, иначе только с флагом arcp.
+Value *CExpressionCodeGenerator::TryGenerateReciprocalMul(Value *a, Value *b)
+{
+    auto *pDivisor = dyn_cast<ConstantFP>(b);
+    if (!pDivisor)
+    {
+        return nullptr;
+    }
+    const APFloat &divisor = pDivisor->getValueAPF();
+    APFloat inverse(1.0);
+    if (!divisor.getExactInverse(&inverse))
+    {
+        if (!(m_fastMathFlags & FastMath::Reciprocal) || divisor.isZero() || !divisor.isFinite())
+        {
+            return nullptr;
+        }
+        inverse.divide(divisor, APFloat::rmNearestTiesToEven);
+    }
+    return m_builder.CreateFMul(a, ConstantFP::get(m_context.GetLLVMContext(), inverse), "multmp");
+}
+
+// Операции над Number, для которых анализ диапазонов доказал отсутствие
+//  дробей и переполнения, поэтому результат совпадает с вычислением в double.
+Value *CExpressionCodeGenerator::GenerateIntegerExpr(Value *a, BinaryOperation op, Value *b)
 {
     switch (op)
     {
     case BinaryOperation::Add:
+        return m_builder.CreateNSWAdd(a, b, "addtmp");
+    case BinaryOperation::Substract:
+        return m_builder.CreateNSWSub(a, b, "subtmp");
+    case BinaryOperation::Multiply:
+        return m_builder.CreateNSWMul(a, b, "multmp");
+    case BinaryOperation::Modulo:
+        return m_builder.CreateSRem(a, b, "modtmp");
+    case BinaryOperation::Less:
+        return m_builder.CreateICmpSLT(a, b, "cmptmp");
+    case BinaryOperation::Equals:
+        return m_builder.CreateICmpEQ(a, b, "cmptmp");
+    case BinaryOperation::NotEquals:
+        return m_builder.CreateICmpNE(a, b, "cmptmp");
+    case BinaryOperation::Greater:
+        return m_builder.CreateICmpSGT(a, b, "cmptmp");
+    case BinaryOperation::LessOrEquals:
+        return m_builder.CreateICmpSLE(a, b, "cmptmp");
+    case BinaryOperation::GreaterOrEquals:
+        return m_builder.CreateICmpSGE(a, b, "cmptmp");
+    case BinaryOperation::Divide:
+    case BinaryOperation::And:
+    case BinaryOperation::Or:
+    case BinaryOperation::BitwiseAnd:
+    case BinaryOperation::BitwiseOr:
+    case BinaryOperation::BitwiseXor:
+    case BinaryOperation::ShiftLeft:
+    case BinaryOperation::ShiftRight:
+        break;
+    }
+    throw std::runtime_error("CExpressionCodeGenerator: unknown integer binary operation");
+}
+
+// Операции над Int: арифметика по модулю 2^64, деление с отбрасыванием дробной части,
+//  величина сдвига берётся по модулю 64, `>>` - арифметический сдвиг.
+Value *CExpressionCodeGenerator::GenerateIntExpr(Value *a, BinaryOperation op, Value *b)
+{
+    switch (op)
     {
-        /*** the same code in C ***
-         * size_t lenA = strlen(a);
-         * size_t sum = lenA + strlen(b);
-         * char *newStr = malloc(sum);
-         * strcat(newStr, a);
-         * strcat(newStr + lenA, b);
-         * return newStr;
-         */
-        auto *pStrlen = m_context.GetBuiltinFunction(BuiltinFunction::STRLEN);
-        auto *pStrcpy = m_context.GetBuiltinFunction(BuiltinFunction::STRCPY);
-        auto *pMalloc = m_context.GetBuiltinFunction(BuiltinFunction::MALLOC);
-        Value *lenA = m_builder.CreateCall(pStrlen, {a}, "left_length");
-        Value *lenB = m_builder.CreateCall(pStrlen, {b}, "right_length");
-        Value *lenSum = m_builder.CreateAdd(lenA, lenB, "sum_length");
-        lenSum = m_builder.CreateAdd(lenSum, AddSizeLiteral(m_context, 1), "malloc_size");
-        Value *newStr = m_builder.CreateCall(pMalloc, {lenSum}, "new_str");
-        m_context.GetExpressionStrings().Manage(newStr);
-        m_builder.CreateCall(pStrcpy, {newStr, a}, "copy_left");
-        Value *nextDest = m_builder.CreateGEP(newStr, lenA, "dest_str");
-        m_builder.CreateCall(pStrcpy, {nextDest, b}, "copy_right");
-        return newStr;
+    case BinaryOperation::Add:
+        return m_builder.CreateAdd(a, b, "addtmp");
+    case BinaryOperation::Substract:
+        return m_builder.CreateSub(a, b, "subtmp");
+    case BinaryOperation::Multiply:
+        return m_builder.CreateMul(a, b, "multmp");
+    case BinaryOperation::Divide:
+    case BinaryOperation::Modulo:
+        return GenerateIntDivision(a, op, b);
+    case BinaryOperation::Less:
+        return m_builder.CreateICmpSLT(a, b, "cmptmp");
+    case BinaryOperation::Equals:
+        return m_builder.CreateICmpEQ(a, b, "cmptmp");
+    case BinaryOperation::NotEquals:
+        return m_builder.CreateICmpNE(a, b, "cmptmp");
+    case BinaryOperation::Greater:
+        return m_builder.CreateICmpSGT(a, b, "cmptmp");
+    case BinaryOperation::LessOrEquals:
+        return m_builder.CreateICmpSLE(a, b, "cmptmp");
+    case BinaryOperation::GreaterOrEquals:
+        return m_builder.CreateICmpSGE(a, b, "cmptmp");
+    case BinaryOperation::And:
+    case BinaryOperation::Or:
+        // handled by GenerateLogicalExpr.
+        break;
+    case BinaryOperation::BitwiseAnd:
+        return m_builder.CreateAnd(a, b, "andtmp");
+    case BinaryOperation::BitwiseOr:
+        return m_builder.CreateOr(a, b, "ortmp");
+    case BinaryOperation::BitwiseXor:
+        return m_builder.CreateXor(a, b, "xortmp");
+    case BinaryOperation::ShiftLeft:
+        return m_builder.CreateShl(a, m_builder.CreateAnd(b, AddInt64Literal(m_context, 63)), "shltmp");
+    case BinaryOperation::ShiftRight:
+        return m_builder.CreateAShr(a, m_builder.CreateAnd(b, AddInt64Literal(m_context, 63)), "shrtmp");
+    }
+    throw std::runtime_error("CExpressionCodeGenerator: unknown Int binary operation");
+}
+
+// Целочисленное деление на 0 аварийно завершает программу через llvm.trap.
+// Деление минимального Int на -1 по модулю 2^64 даёт минимальный Int, остаток - 0:
+//  sdiv для этого случая не определён, поэтому делитель -1 заменяется на 1.
+Value *CExpressionCodeGenerator::GenerateIntDivision(Value *a, BinaryOperation op, Value *b)
+{
+    LLVMContext &context = m_context.GetLLVMContext();
+    Function *pFunction = m_builder.GetInsertBlock()->getParent();
+    BasicBlock *trapBB = BasicBlock::Create(context, "div_by_zero", pFunction);
+    BasicBlock *divideBB = BasicBlock::Create(context, "divide", pFunction);
+
+    Value *isZero = m_builder.CreateICmpEQ(b, AddInt64Literal(m_context, 0), "is_zero_divisor");
+    m_builder.CreateCondBr(isZero, trapBB, divideBB, MDBuilder(context).createBranchWeights(1, 1 << 20));
+    m_builder.SetInsertPoint(trapBB);
+    m_builder.CreateCall(Intrinsic::getDeclaration(&m_context.GetModule(), Intrinsic::trap));
+    m_builder.CreateUnreachable();
+    m_builder.SetInsertPoint(divideBB);
+
+    Value *isMinusOne = m_builder.CreateICmpEQ(b, AddInt64Literal(m_context, -1), "is_minus_one");
+    Value *divisor = m_builder.CreateSelect(isMinusOne, AddInt64Literal(m_context, 1), b, "divisor");
+    if (op == BinaryOperation::Modulo)
+    {
+        return m_builder.CreateSRem(a, divisor, "modtmp");
     }
+    Value *quotient = m_builder.CreateSDiv(a, divisor, "divtmp");
+    return m_builder.CreateSelect(isMinusOne, m_builder.CreateNeg(a), quotient, "divtmp");
+}
+
+// Number -> Int: дробная часть отбрасывается, значения вне диапазона Int
+//  насыщаются до минимального или максимального Int, NaN даёт 0.
+Value *CExpressionCodeGenerator::GenerateDoubleToInt(Value *x)
+{
+    LLVMContext &context = m_context.GetLLVMContext();
+    Type *doubleType = Type::getDoubleTy(context);
+    const double limit = 9223372036854775808.0; // 2^63
+    Value *truncated = m_builder.CreateFPToSI(x, Type::getInt64Ty(context), "fptoi");
+    Value *isAboveMin = m_builder.CreateFCmpOGE(x, ConstantFP::get(doubleType, -limit));
+    Value *isBelowMax = m_builder.CreateFCmpOLT(x, ConstantFP::get(doubleType, limit));
+    Value *isInRange = m_builder.CreateAnd(isAboveMin, isBelowMax, "in_int_range");
+    Value *isNegative = m_builder.CreateFCmpOLT(x, ConstantFP::get(doubleType, 0.0));
+    Value *isNaN = m_builder.CreateFCmpUNO(x, x);
+    Value *saturated = m_builder.CreateSelect(isNegative, AddInt64Literal(m_context, INT64_MIN),
+                                              m_builder.CreateSelect(isNaN, AddInt64Literal(m_context, 0),
+                                                                     AddInt64Literal(m_context, INT64_MAX)));
+    return m_builder.CreateSelect(isInRange, truncated, saturated, "ftoi_sat");
+}
+
+Value *CExpressionCodeGenerator::GenerateStringExpr(Value *a, BinaryOperation op, Value *b)
+{
+    switch (op)
+    {
+    case BinaryOperation::Add:
+        // handled by GenerateConcatenation.
+        break;
     case BinaryOperation::Substract:
     case BinaryOperation::Multiply:
     case BinaryOperation::Divide:
     case BinaryOperation::Modulo:
+    case BinaryOperation::BitwiseAnd:
+    case BinaryOperation::BitwiseOr:
+    case BinaryOperation::BitwiseXor:
+    case BinaryOperation::ShiftLeft:
+    case BinaryOperation::ShiftRight:
+        // disallowed for String.
+        break;
+    case BinaryOperation::And:
+    case BinaryOperation::Or:
         // disallowed for String.
         break;
     case BinaryOperation::Less:
-        return m_builder.CreateICmpSLT(GenerateStrcmp(a, b), AddInt32Literal(m_context, 0), "less_than_0");
     case BinaryOperation::Equals:
-        return m_builder.CreateICmpEQ(GenerateStrcmp(a, b), AddInt32Literal(m_context, 0), "is_0");
+    case BinaryOperation::NotEquals:
+    case BinaryOperation::Greater:
+    case BinaryOperation::LessOrEquals:
+    case BinaryOperation::GreaterOrEquals:
+    {
+        ComparisonForm form;
+        GetComparisonForm(op, form);
+        Value *x = form.isSwapped ? b : a;
+        Value *y = form.isSwapped ? a : b;
+        Value *result = (form.base == BinaryOperation::Equals)
+                ? GenerateStringEquals(x, y)
+                : GenerateStringLess({GetStringData(m_builder, m_context, x), GetStringLength(m_builder, m_context, x)},
+                                     {GetStringData(m_builder, m_context, y), GetStringLength(m_builder, m_context, y)});
+        return form.isNegated ? m_builder.CreateNot(result, "nottmp") : result;
+    }
     }
     throw std::runtime_error("CExpressionCodeGenerator: unknown strings binary operation");
 }
 
+// Цепочка `a + b + ... + z` вычисляется одним выделением памяти:
+//  промежуточные суммы не создаются, каждый операнд копируется один раз.
+Value *CExpressionCodeGenerator::GenerateConcatenation(CBinaryExpressionAST &expr)
+{
+    std::vector<IExpressionAST *> operands;
+    CollectConcatOperands(expr, operands);
+    std::vector<StringPiece> pieces = CodegenConcatPieces(operands);
+    return CreateStringFromPieces(pieces, IsTemporary(expr));
+}
+
+// Создаёт строку, склеенную из кусков, и ставит её под контроль времени жизни.
+// Короткий результат собирается прямо в значении String и не требует памяти:
+//   size_t length = a.length + b.length + ... + z.length;
+//   char *data = (length <= INLINE_STRING_CAPACITY) ? inlineStr.bytes : <new string>.data;
+//   memcpy(data, a.data, a.length); data += a.length; ...
+Value *CExpressionCodeGenerator::CreateStringFromPieces(ArrayRef<StringPiece> pieces, bool isTemporary)
+{
+    Value *length = AddSizeLiteral(m_context, 0);
+    for (const StringPiece &piece : pieces)
+    {
+        length = m_builder.CreateAdd(length, piece.length, "sum_length");
+    }
+
+    LLVMContext &context = m_context.GetLLVMContext();
+    Function *pFunction = m_builder.GetInsertBlock()->getParent();
+    Type *stringType = GetStringType(context);
+    AllocaInst *pInlineSlot = MakeLocalVariable(*pFunction, *stringType, "inline_str");
+    m_builder.CreateStore(Constant::getNullValue(stringType), pInlineSlot);
+    Value *pInlineData = m_builder.CreateBitCast(pInlineSlot, m_builder.getInt8PtrTy(), "inline_data");
+
+    BasicBlock *inlineBB = m_builder.GetInsertBlock();
+    BasicBlock *allocBB = BasicBlock::Create(context, "str_alloc", pFunction);
+    BasicBlock *joinBB = BasicBlock::Create(context, "str_fill", pFunction);
+    Value *isInline = m_builder.CreateICmpULE(length, AddSizeLiteral(m_context, INLINE_STRING_CAPACITY), "is_inline");
+    m_builder.CreateCondBr(isInline, joinBB, allocBB);
+
+    m_builder.SetInsertPoint(allocBB);
+    Value *allocatedStr = AllocateString(length, isTemporary);
+    Value *pAllocatedData = m_builder.CreateExtractValue(allocatedStr, {0}, "allocated_data");
+    BasicBlock *allocatedBB = m_builder.GetInsertBlock();
+    m_builder.CreateBr(joinBB);
+
+    m_builder.SetInsertPoint(joinBB);
+    PHINode *pData = m_builder.CreatePHI(pInlineData->getType(), 2, "new_data");
+    pData->addIncoming(pInlineData, inlineBB);
+    pData->addIncoming(pAllocatedData, allocatedBB);
+    PHINode *pAllocated = m_builder.CreatePHI(stringType, 2, "allocated_str");
+    pAllocated->addIncoming(UndefValue::get(stringType), inlineBB);
+    pAllocated->addIncoming(allocatedStr, allocatedBB);
+    CopyConcatPieces(pData, AddSizeLiteral(m_context, 0), pieces);
+
+    Value *inlineStr = LoadInlineString(m_builder, m_context, pInlineSlot, length);
+    Value *newStr = m_builder.CreateSelect(isInline, inlineStr, pAllocated, "new_str");
+
+    if (isTemporary)
+    {
+        m_context.GetExpressionStrings().ManageTemporary(newStr);
+    }
+    else
+    {
+        m_context.GetExpressionStrings().Manage(newStr);
+    }
+    return newStr;
+}
+
+// Преобразует значение в строку так же, как его печатает print.
+// Число записывается библиотекой времени выполнения в буфер на стеке,
+//  откуда копируется в новую строку.
+Value *CExpressionCodeGenerator::GenerateToString(Value *x, ExpressionType type, bool isTemporary)
+{
+    if (type == ExpressionType::Boolean)
+    {
+        return m_builder.CreateSelect(x, m_context.AddStringLiteral("true"), m_context.AddStringLiteral("false"),
+                                      "bool_str");
+    }
+    return CreateStringFromPieces(GenerateText(x, type), isTemporary);
+}
+
+// Записывает текст значения Number, Int или Boolean, не создавая строку:
+//  число форматируется в буфер на стеке, Boolean ссылается на байты литерала.
+CExpressionCodeGenerator::StringPiece CExpressionCodeGenerator::GenerateText(Value *x, ExpressionType type)
+{
+    if (type == ExpressionType::Boolean)
+    {
+        Value *pText = m_builder.CreateSelect(x, m_context.AddCStringLiteral("true"),
+                                              m_context.AddCStringLiteral("false"), "bool_text");
+        Value *length = m_builder.CreateSelect(x, AddSizeLiteral(m_context, 4), AddSizeLiteral(m_context, 5),
+                                               "bool_text_length");
+        return {pText, length};
+    }
+    LLVMContext &context = m_context.GetLLVMContext();
+    Function *pFunction = m_builder.GetInsertBlock()->getParent();
+    Type *bufferType = ArrayType::get(Type::getInt8Ty(context), NUMBER_TEXT_CAPACITY);
+    AllocaInst *pBuffer = MakeLocalVariable(*pFunction, *bufferType, "number_text");
+    Value *pText = m_builder.CreateBitCast(pBuffer, m_builder.getInt8PtrTy(), "text_data");
+    Value *length = nullptr;
+    if (type == ExpressionType::Int)
+    {
+        length = m_builder.CreateCall(m_context.GetBuiltinFunction(BuiltinFunction::FORMAT_INT), {x, pText},
+                                      "text_length");
+    }
+    else
+    {
+        length = m_builder.CreateCall(m_context.GetBuiltinFunction(BuiltinFunction::FORMAT_NUMBER),
+                                      {ConvertToDouble(x), pText}, "text_length");
+    }
+    return {pText, length};
+}
+
+// Дописывание в переменную с запасом ёмкости, рост буфера вдвое даёт
+//  амортизированно линейное время построения строки в цикле:
+//   size_t length = x.length + a.length + ... + z.length;
+//   String old = x;
+//   bool mustGrow = isInline(x) || isView(x) || (length > capacity) || (refcount(x) != 1);
+//   if (mustGrow) {
+//       capacity = max(2 * length, MIN_APPEND_CAPACITY);
+//       x.data = <new block with refcount 1 and given capacity>;
+//       memcpy(x.data, old.data, old.length);
+//   }
+//   memcpy(x.data + old.length, a.data, a.length); ...
+//   if (mustGrow)
+//       str_release(old);
+//   x.length = length;
+// Дописывать на месте можно, только если переменная - единственный владелец буфера:
+//  срез делит буфер с исходной строкой, поэтому всегда переносится в новый.
+// Старая строка освобождается после копирования, так как операнды могут ссылаться на неё.
+void CExpressionCodeGenerator::GenerateAppend(CBinaryExpressionAST &expr, AllocaInst *pVar, AllocaInst *pCapacity)
+{
+    m_values.clear();
+    std::vector<IExpressionAST *> operands;
+    CollectConcatOperands(expr, operands);
+    operands.erase(operands.begin());
+    std::vector<StringPiece> pieces = CodegenConcatPieces(operands);
+
+    LLVMContext &context = m_context.GetLLVMContext();
+    Function *pFunction = m_builder.GetInsertBlock()->getParent();
+    Value *pString = m_builder.CreateLoad(pVar, "append_str");
+    Value *capacity = m_builder.CreateLoad(pCapacity, "capacity");
+    Value *pOldData = GetStringData(m_builder, m_context, pString);
+    Value *oldLength = GetStringLength(m_builder, m_context, pString);
+    Value *length = oldLength;
+    for (const StringPiece &piece : pieces)
+    {
+        length = m_builder.CreateAdd(length, piece.length, "sum_length");
+    }
+
+    BasicBlock *checkBB = BasicBlock::Create(context, "append_check", pFunction);
+    BasicBlock *growBB = BasicBlock::Create(context, "append_grow", pFunction);
+    BasicBlock *copyBB = BasicBlock::Create(context, "append_copy", pFunction);
+    BasicBlock *releaseBB = BasicBlock::Create(context, "append_release", pFunction);
+    BasicBlock *doneBB = BasicBlock::Create(context, "append_done", pFunction);
+    // У короткой строки нет заголовка, её всегда нужно перенести в буфер.
+    m_builder.CreateCondBr(IsInlineString(m_builder, m_context, pString), growBB, checkBB);
+
+    m_builder.SetInsertPoint(checkBB);
+    Value *pRefcount = GetBlockRefcountPtr(m_builder, m_context, pString);
+    Value *refcount = m_builder.CreateLoad(pRefcount, "refcount");
+    Value *isShared = m_builder.CreateOr(m_builder.CreateICmpNE(refcount, AddSizeLiteral(m_context, 1)),
+                                         IsViewString(m_builder, m_context, pString), "is_shared");
+    Value *isFull = m_builder.CreateICmpUGT(length, capacity, "is_full");
+    Value *isGrowing = m_builder.CreateOr(isFull, isShared, "is_growing");
+    m_builder.CreateCondBr(isGrowing, growBB, copyBB, MDBuilder(context).createBranchWeights(1, 16));
+
+    m_builder.SetInsertPoint(growBB);
+    Value *doubled = m_builder.CreateShl(length, 1, "doubled");
+    Value *minCapacity = AddSizeLiteral(m_context, MIN_APPEND_CAPACITY);
+    Value *isSmall = m_builder.CreateICmpULT(doubled, minCapacity, "is_small");
+    Value *newCapacity = m_builder.CreateSelect(isSmall, minCapacity, doubled, "new_capacity");
+    auto *pMemcpy = m_context.GetBuiltinFunction(BuiltinFunction::MEMCPY);
+    Value *pGrownData = CreateStringBlock(m_builder, m_context, newCapacity, 1, BuiltinFunction::MALLOC);
+    m_builder.CreateCall(pMemcpy, {pGrownData, pOldData, oldLength});
+    m_builder.CreateStore(newCapacity, pCapacity);
+    m_builder.CreateBr(copyBB);
+
+    m_builder.SetInsertPoint(copyBB);
+    PHINode *pData = m_builder.CreatePHI(pOldData->getType(), 2, "append_data");
+    pData->addIncoming(pOldData, checkBB);
+    pData->addIncoming(pGrownData, growBB);
+    PHINode *mustGrow = m_builder.CreatePHI(m_builder.getInt1Ty(), 2, "must_grow");
+    mustGrow->addIncoming(m_builder.getFalse(), checkBB);
+    mustGrow->addIncoming(m_builder.getTrue(), growBB);
+    CopyConcatPieces(pData, oldLength, pieces);
+    m_builder.CreateCondBr(mustGrow, releaseBB, doneBB);
+
+    m_builder.SetInsertPoint(releaseBB);
+    m_builder.CreateCall(m_context.GetBuiltinFunction(BuiltinFunction::STRING_RELEASE), {pString});
+    m_builder.CreateBr(doneBB);
+
+    m_builder.SetInsertPoint(doneBB);
+    m_builder.CreateStore(m_context.CreateString(m_builder, pData, length), pVar);
+}
+
+// Вычисляет операнды конкатенации и получает их байты и длины.
+// Текст операнда `String(x)` с числом или Boolean записывается на стек
+//  и копируется сразу в результат, минуя промежуточную строку.
+std::vector<CExpressionCodeGenerator::StringPiece> CExpressionCodeGenerator::CodegenConcatPieces(
+        const std::vector<IExpressionAST *> &operands)
+{
+    std::vector<StringPiece> pieces;
+    pieces.reserve(operands.size());
+    for (IExpressionAST *pOperand : operands)
+    {
+        auto *pConversion = dynamic_cast<CConversionAST *>(pOperand);
+        if (pConversion && pConversion->GetOperand().GetType() != ExpressionType::String)
+        {
+            pConversion->GetOperand().Accept(*this);
+            Value *x = m_values.back();
+            m_values.pop_back();
+            pieces.push_back(GenerateText(x, pConversion->GetOperand().GetType()));
+            continue;
+        }
+        pOperand->Accept(*this);
+        Value *pString = m_values.back();
+        m_values.pop_back();
+        pieces.push_back({GetStringData(m_builder, m_context, pString),
+                          GetStringLength(m_builder, m_context, pString)});
+    }
+    return pieces;
+}
+
+// Копирует строки друг за другом, начиная с pData + offset.
+void CExpressionCodeGenerator::CopyConcatPieces(Value *pData, Value *offset, ArrayRef<StringPiece> pieces)
+{
+    auto *pMemcpy = m_context.GetBuiltinFunction(BuiltinFunction::MEMCPY);
+    for (const StringPiece &piece : pieces)
+    {
+        Value *pDest = m_builder.CreateGEP(pData, offset, "dest_str");
+        m_builder.CreateCall(pMemcpy, {pDest, piece.pData, piece.length});
+        offset = m_builder.CreateAdd(offset, piece.length, "offset");
+    }
+}
+
+// Раскрывает вложенные конкатенации в плоский список операндов слева направо.
+void CExpressionCodeGenerator::CollectConcatOperands(IExpressionAST &expr, std::vector<IExpressionAST *> &operands)
+{
+    auto *pBinary = dynamic_cast<CBinaryExpressionAST *>(&expr);
+    if (pBinary && pBinary->GetType() == ExpressionType::String)
+    {
+        CollectConcatOperands(pBinary->GetLeft(), operands);
+        CollectConcatOperands(pBinary->GetRight(), operands);
+    }
+    else
+    {
+        operands.push_back(&expr);
+    }
+}
+
+// Выделяет память под новую строку заданной длины.
+// Строка, которая будет сохранена или возвращена, размещается в куче.
+// Временная строка, которая не покидает оператор, размещается в буфере на стеке,
+//  а если не умещается в него - в арене. Счётчик ссылок такой строки равен STRING_TEMPORARY:
+//   struct { size_t refcount; char data[STACK_STRING_CAPACITY]; } buffer = { STRING_TEMPORARY };
+//   char *arenaData = (length <= sizeof(buffer.data)) ? NULL : <arena block with STRING_TEMPORARY>;
+//   String newStr = { arenaData ? arenaData : buffer.data, length };
+// Каждое место конкатенации получает собственный буфер: временные строки одного
+//  оператора живут одновременно, а между операторами буфер переиспользуется.
+// Если буферы исчерпали свой лимит, временная строка сразу размещается в арене.
+Value *CExpressionCodeGenerator::AllocateString(Value *length, bool isTemporary)
+{
+    if (!isTemporary)
+    {
+        Value *pData = CreateStringBlock(m_builder, m_context, length, 1, BuiltinFunction::MALLOC);
+        return m_context.CreateString(m_builder, pData, length);
+    }
+    if (!m_pArenaMark)
+    {
+        // Отметка запоминается при входе в функцию: откат к ней в конце оператора
+        //  освобождает временные строки оператора, не затрагивая строки вызывающих функций.
+        BasicBlock &entry = m_builder.GetInsertBlock()->getParent()->getEntryBlock();
+        IRBuilder<> entryBuilder(&entry, entry.begin());
+        m_pArenaMark = entryBuilder.CreateCall(m_context.GetBuiltinFunction(BuiltinFunction::ARENA_MARK), {}, "arena_mark");
+    }
+    if (m_stackBuffersSize + STACK_STRING_CAPACITY > MAX_STACK_STRINGS_SIZE)
+    {
+        Value *pData = CreateStringBlock(m_builder, m_context, length, STRING_TEMPORARY, BuiltinFunction::ARENA_ALLOC);
+        return m_context.CreateString(m_builder, pData, length);
+    }
+    m_stackBuffersSize += STACK_STRING_CAPACITY;
+
+    LLVMContext &context = m_context.GetLLVMContext();
+    Function *pFunction = m_builder.GetInsertBlock()->getParent();
+    Type *bufferType = ArrayType::get(Type::getInt8Ty(context), STRING_HEADER_SIZE + STACK_STRING_CAPACITY);
+    AllocaInst *pBuffer = MakeLocalVariable(*pFunction, *bufferType, "str_buffer");
+    pBuffer->setAlignment(STRING_HEADER_SIZE);
+    Value *bufferData = m_builder.CreateConstInBoundsGEP2_32(bufferType, pBuffer, 0, STRING_HEADER_SIZE, "buffer_data");
+    m_builder.CreateStore(AddSizeLiteral(m_context, STRING_TEMPORARY), GetRefcountPtr(m_builder, m_context, bufferData));
+
+    BasicBlock *stackBB = m_builder.GetInsertBlock();
+    BasicBlock *arenaBB = BasicBlock::Create(context, "str_arena", pFunction);
+    BasicBlock *joinBB = BasicBlock::Create(context, "str_allocated", pFunction);
+    Value *fits = m_builder.CreateICmpULE(length, AddSizeLiteral(m_context, STACK_STRING_CAPACITY), "fits_buffer");
+    m_builder.CreateCondBr(fits, joinBB, arenaBB, MDBuilder(context).createBranchWeights(16, 1));
+
+    m_builder.SetInsertPoint(arenaBB);
+    Value *pArenaData = CreateStringBlock(m_builder, m_context, length, STRING_TEMPORARY, BuiltinFunction::ARENA_ALLOC);
+    m_builder.CreateBr(joinBB);
+
+    m_builder.SetInsertPoint(joinBB);
+    PHINode *pData = m_builder.CreatePHI(bufferData->getType(), 2, "new_data");
+    pData->addIncoming(bufferData, stackBB);
+    pData->addIncoming(pArenaData, arenaBB);
+
+    return m_context.CreateString(m_builder, pData, length);
+}
+
 Value *CExpressionCodeGenerator::GenerateBooleanExpr(Value *a, BinaryOperation op, Value *b)
 {
     switch (op)
@@ -489,26 +2222,284 @@ Value *CExpressionCodeGenerator::GenerateBooleanExpr(Value *a, BinaryOperation o
     case BinaryOperation::Multiply:
     case BinaryOperation::Divide:
     case BinaryOperation::Modulo:
+    case BinaryOperation::BitwiseAnd:
+    case BinaryOperation::BitwiseOr:
+    case BinaryOperation::BitwiseXor:
+    case BinaryOperation::ShiftLeft:
+    case BinaryOperation::ShiftRight:
         // disallowed for Boolean.
         break;
+    case BinaryOperation::And:
+    case BinaryOperation::Or:
+        // handled by GenerateLogicalExpr.
+        break;
+    // Сравнения беззнаковые: false < true, а в знаковом i1 true равно -1.
     case BinaryOperation::Less:
-        return m_builder.CreateICmpSLT(a, b);
+        return m_builder.CreateICmpULT(a, b);
     case BinaryOperation::Equals:
         return m_builder.CreateICmpEQ(a, b);
+    case BinaryOperation::NotEquals:
+        return m_builder.CreateICmpNE(a, b);
+    case BinaryOperation::Greater:
+        return m_builder.CreateICmpUGT(a, b);
+    case BinaryOperation::LessOrEquals:
+        return m_builder.CreateICmpULE(a, b);
+    case BinaryOperation::GreaterOrEquals:
+        return m_builder.CreateICmpUGE(a, b);
     }
     throw std::runtime_error("CExpressionCodeGenerator: unknown boolean binary operation");
 }
 
-Value *CExpressionCodeGenerator::GenerateStrcmp(Value *a, Value *b)
+// `a and b` и `a or b` вычисляют b, только если значение a не определяет результат:
+//   a and b = a ? b : false,  a or b = a ? true : b
+// Правый операнд, который можно вычислить всегда (см. IsSafeToSpeculate), не требует
+//  ветвления: результат выбирает select, и условие остаётся линейным кодом.
+// Строки, которые создал правый операнд, освобождаются в его ветви, до слияния ветвей.
+Value *CExpressionCodeGenerator::GenerateLogicalExpr(CBinaryExpressionAST &expr)
+{
+    LLVMContext &context = m_context.GetLLVMContext();
+    const bool isAnd = (expr.GetOperation() == BinaryOperation::And);
+    expr.GetLeft().Accept(*this);
+    Value *a = m_values.back();
+    m_values.pop_back();
+    if (IsSafeToSpeculate(expr.GetRight()))
+    {
+        expr.GetRight().Accept(*this);
+        Value *b = m_values.back();
+        m_values.pop_back();
+        return isAnd ? m_builder.CreateSelect(a, b, ConstantInt::getFalse(context), "andtmp")
+                     : m_builder.CreateSelect(a, ConstantInt::getTrue(context), b, "ortmp");
+    }
+
+    Function *pFunction = m_builder.GetInsertBlock()->getParent();
+    BasicBlock *leftBB = m_builder.GetInsertBlock();
+    BasicBlock *rightBB = BasicBlock::Create(context, isAnd ? "and_rhs" : "or_rhs", pFunction);
+    BasicBlock *doneBB = BasicBlock::Create(context, isAnd ? "and_done" : "or_done", pFunction);
+    if (isAnd)
+    {
+        m_builder.CreateCondBr(a, rightBB, doneBB);
+    }
+    else
+    {
+        m_builder.CreateCondBr(a, doneBB, rightBB);
+    }
+
+    m_builder.SetInsertPoint(rightBB);
+    CManagedStrings &strings = m_context.GetExpressionStrings();
+    const std::unordered_set<Value *> leftStrings = strings.GetPointers();
+    expr.GetRight().Accept(*this);
+    Value *b = m_values.back();
+    m_values.pop_back();
+    strings.FreeAllExcept(m_builder, leftStrings);
+    BasicBlock *rightEndBB = m_builder.GetInsertBlock();
+    m_builder.CreateBr(doneBB);
+
+    m_builder.SetInsertPoint(doneBB);
+    PHINode *result = m_builder.CreatePHI(Type::getInt1Ty(context), 2, isAnd ? "andtmp" : "ortmp");
+    result->addIncoming(isAnd ? ConstantInt::getFalse(context) : ConstantInt::getTrue(context), leftBB);
+    result->addIncoming(b, rightEndBB);
+    return result;
+}
+
+// Две короткие строки равны, если равны их значения: байты дополнены нулями.
+// Остальные строки разной длины не равны, байты сравниваются только при равных длинах.
+// Строки в куче с одним указателем равны, а две разные интернированные строки - не равны:
+//   a.length == b.length && (a.data == b.data
+//       || !(interned(a) && interned(b)) && memcmp(a.data, b.data, a.length) == 0)
+// Срез не имеет собственного заголовка, поэтому его байты всегда сравниваются memcmp.
+Value *CExpressionCodeGenerator::GenerateStringEquals(Value *a, Value *b)
+{
+    LLVMContext &context = m_context.GetLLVMContext();
+    Function *pFunction = m_builder.GetInsertBlock()->getParent();
+    BasicBlock *inlineBB = BasicBlock::Create(context, "str_eq_inline", pFunction);
+    BasicBlock *lengthBB = BasicBlock::Create(context, "str_eq_length", pFunction);
+    BasicBlock *heapBB = BasicBlock::Create(context, "str_eq_heap", pFunction);
+    BasicBlock *compareBB = BasicBlock::Create(context, "str_eq_bytes", pFunction);
+    BasicBlock *doneBB = BasicBlock::Create(context, "str_eq_done", pFunction);
+    Value *isInlineA = IsInlineString(m_builder, m_context, a);
+    Value *isInlineB = IsInlineString(m_builder, m_context, b);
+    m_builder.CreateCondBr(m_builder.CreateAnd(isInlineA, isInlineB, "both_inline"), inlineBB, lengthBB);
+
+    m_builder.SetInsertPoint(inlineBB);
+    Value *isSameFirst = m_builder.CreateICmpEQ(m_builder.CreateExtractValue(a, {0}),
+                                                m_builder.CreateExtractValue(b, {0}), "same_first");
+    Value *isSameSecond = m_builder.CreateICmpEQ(m_builder.CreateExtractValue(a, {1}),
+                                                 m_builder.CreateExtractValue(b, {1}), "same_second");
+    Value *isSameInline = m_builder.CreateAnd(isSameFirst, isSameSecond, "same_inline");
+    m_builder.CreateBr(doneBB);
+
+    m_builder.SetInsertPoint(lengthBB);
+    Value *lenA = GetStringLength(m_builder, m_context, a);
+    Value *lenB = GetStringLength(m_builder, m_context, b);
+    Value *isSameLength = m_builder.CreateICmpEQ(lenA, lenB, "same_length");
+    Value *viewTag = AddSizeLiteral(m_context, VIEW_TAG);
+    Value *isHeapPair = m_builder.CreateAnd(m_builder.CreateICmpULT(m_builder.CreateExtractValue(a, {1}), viewTag),
+                                            m_builder.CreateICmpULT(m_builder.CreateExtractValue(b, {1}), viewTag),
+                                            "both_heap");
+    BasicBlock *sameLengthBB = BasicBlock::Create(context, "str_eq_same_length", pFunction);
+    m_builder.CreateCondBr(isSameLength, sameLengthBB, doneBB);
+    m_builder.SetInsertPoint(sameLengthBB);
+    m_builder.CreateCondBr(isHeapPair, heapBB, compareBB);
+
+    m_builder.SetInsertPoint(heapBB);
+    Value *pDataA = m_builder.CreateExtractValue(a, {0}, "data_a");
+    Value *pDataB = m_builder.CreateExtractValue(b, {0}, "data_b");
+    Value *isSamePointer = m_builder.CreateICmpEQ(pDataA, pDataB, "same_pointer");
+    Value *pRefcountA = GetRefcountPtr(m_builder, m_context, pDataA);
+    Value *pRefcountB = GetRefcountPtr(m_builder, m_context, pDataB);
+    Value *refcountA = m_builder.CreateLoad(pRefcountA, "refcount_a");
+    Value *refcountB = m_builder.CreateLoad(pRefcountB, "refcount_b");
+    Value *interned = AddSizeLiteral(m_context, STRING_INTERNED);
+    Value *isInternedPair = m_builder.CreateAnd(m_builder.CreateICmpEQ(refcountA, interned),
+                                                m_builder.CreateICmpEQ(refcountB, interned), "both_interned");
+    m_builder.CreateCondBr(m_builder.CreateOr(isSamePointer, isInternedPair), doneBB, compareBB);
+
+    m_builder.SetInsertPoint(compareBB);
+    auto *pMemcmp = m_context.GetBuiltinFunction(BuiltinFunction::MEMCMP);
+    Value *order = m_builder.CreateCall(pMemcmp, {GetStringData(m_builder, m_context, a),
+                                                  GetStringData(m_builder, m_context, b), lenA}, "strings_cmp");
+    Value *isSameBytes = m_builder.CreateICmpEQ(order, AddInt32Literal(m_context, 0), "is_0");
+    m_builder.CreateBr(doneBB);
+
+    m_builder.SetInsertPoint(doneBB);
+    PHINode *result = m_builder.CreatePHI(Type::getInt1Ty(context), 4, "str_eq");
+    result->addIncoming(isSameInline, inlineBB);
+    result->addIncoming(ConstantInt::getFalse(context), lengthBB);
+    result->addIncoming(isSamePointer, heapBB);
+    result->addIncoming(isSameBytes, compareBB);
+    return result;
+}
+
+// Лексикографическое сравнение, более короткий префикс меньше:
+//   int order = memcmp(a.data, b.data, min(a.length, b.length));
+//   order < 0 || (order == 0 && a.length < b.length)
+// Сравнение со строковым литералом не требует ни вычисления литерала, ни чтения его длины:
+//  равенство проверяется сравнением слов с константами, порядок - memcmp с адресом литерала.
+bool CExpressionCodeGenerator::TryGenerateLiteralCompare(CBinaryExpressionAST &expr)
+{
+    ComparisonForm form;
+    const std::string *pLeftLiteral = GetStringLiteral(expr.GetLeft());
+    const std::string *pRightLiteral = GetStringLiteral(expr.GetRight());
+    if (!GetComparisonForm(expr.GetOperation(), form) || (!pLeftLiteral == !pRightLiteral))
+    {
+        return false;
+    }
+    const std::string &literal = pLeftLiteral ? *pLeftLiteral : *pRightLiteral;
+    IExpressionAST &other = pLeftLiteral ? expr.GetRight() : expr.GetLeft();
+    other.Accept(*this);
+    Value *pString = m_values.back();
+    m_values.pop_back();
+    Value *result = nullptr;
+    if (form.base == BinaryOperation::Equals)
+    {
+        result = GenerateLiteralEquals(pString, literal);
+    }
+    else
+    {
+        StringPiece literalPiece = {m_context.AddCStringLiteral(literal), AddSizeLiteral(m_context, literal.size())};
+        StringPiece stringPiece = {GetStringData(m_builder, m_context, pString),
+                                   GetStringLength(m_builder, m_context, pString)};
+        const bool isLiteralFirst = (pLeftLiteral != nullptr) != form.isSwapped;
+        result = isLiteralFirst ? GenerateStringLess(literalPiece, stringPiece)
+                                : GenerateStringLess(stringPiece, literalPiece);
+    }
+    m_values.push_back(form.isNegated ? m_builder.CreateNot(result, "nottmp") : result);
+    return true;
+}
+
+// Слово length строки однозначно определяет, с какой веткой её сравнивать:
+//   switch (s.length_word) {
+//   case <слово length литерала>: return s.data_word == <слово data литерала>; // короткая строка
+//   case <длина литерала>: return <байты s.data равны байтам литерала>;       // строка в куче
+//   default: return isView(s) && length(s) == <длина литерала> && <байты равны>;
+//   }
+// Строка в куче может быть короткой, например, после дописывания в буфер переменной.
+Value *CExpressionCodeGenerator::GenerateLiteralEquals(Value *pString, const std::string &literal)
+{
+    LLVMContext &context = m_context.GetLLVMContext();
+    Function *pFunction = m_builder.GetInsertBlock()->getParent();
+    BasicBlock *viewBB = BasicBlock::Create(context, "literal_eq_view", pFunction);
+    BasicBlock *heapBB = BasicBlock::Create(context, "literal_eq_heap", pFunction);
+    BasicBlock *doneBB = BasicBlock::Create(context, "literal_eq_done", pFunction);
+    Value *lengthWord = m_builder.CreateExtractValue(pString, {1}, "length_word");
+    SwitchInst *pSwitch = m_builder.CreateSwitch(lengthWord, viewBB, 2);
+    pSwitch->addCase(AddSizeLiteral(m_context, literal.size()), heapBB);
+
+    m_builder.SetInsertPoint(viewBB);
+    Value *viewLength = m_builder.CreateAnd(lengthWord, AddSizeLiteral(m_context, VIEW_MAX_LENGTH), "view_length");
+    Value *isSameView = m_builder.CreateAnd(IsViewString(m_builder, m_context, pString),
+                                            m_builder.CreateICmpEQ(viewLength, AddSizeLiteral(m_context, literal.size())),
+                                            "same_view_length");
+    m_builder.CreateCondBr(isSameView, heapBB, doneBB);
+
+    m_builder.SetInsertPoint(heapBB);
+    Value *pHeapData = m_builder.CreateExtractValue(pString, {0}, "heap_data");
+    Value *isSameHeap = CreateLiteralBytesEqual(m_builder, m_context, pHeapData, literal);
+    BasicBlock *heapEndBB = m_builder.GetInsertBlock();
+    m_builder.CreateBr(doneBB);
+
+    BasicBlock *inlineBB = nullptr;
+    Value *isSameInline = nullptr;
+    if (literal.size() <= INLINE_STRING_CAPACITY)
+    {
+        Constant *pLiteral = m_context.AddStringLiteral(literal);
+        inlineBB = BasicBlock::Create(context, "literal_eq_inline", pFunction);
+        pSwitch->addCase(cast<ConstantInt>(pLiteral->getAggregateElement(1u)), inlineBB);
+        m_builder.SetInsertPoint(inlineBB);
+        Value *dataWord = m_builder.CreatePtrToInt(m_builder.CreateExtractValue(pString, {0}),
+                                                   GetPointerSizeType(context), "data_word");
+        Value *literalWord = ConstantExpr::getPtrToInt(pLiteral->getAggregateElement(0u), GetPointerSizeType(context));
+        isSameInline = m_builder.CreateICmpEQ(dataWord, literalWord, "same_inline");
+        m_builder.CreateBr(doneBB);
+    }
+
+    m_builder.SetInsertPoint(doneBB);
+    PHINode *result = m_builder.CreatePHI(Type::getInt1Ty(context), 3, "literal_eq");
+    result->addIncoming(ConstantInt::getFalse(context), viewBB);
+    result->addIncoming(isSameHeap, heapEndBB);
+    if (inlineBB)
+    {
+        result->addIncoming(isSameInline, inlineBB);
+    }
+    return result;
+}
+
+Value *CExpressionCodeGenerator::GenerateStringLess(const StringPiece &a, const StringPiece &b)
 {
-    auto *pStrcmp = m_context.GetBuiltinFunction(BuiltinFunction::STRCMP);
-    return m_builder.CreateCall(pStrcmp, {a, b}, "strings_cmp");
+    auto *pMemcmp = m_context.GetBuiltinFunction(BuiltinFunction::MEMCMP);
+    Value *isShorter = m_builder.CreateICmpULT(a.length, b.length, "is_shorter");
+    Value *minLength = m_builder.CreateSelect(isShorter, a.length, b.length, "min_length");
+    Value *order = m_builder.CreateCall(pMemcmp, {a.pData, b.pData, minLength}, "strings_cmp");
+    Value *isLess = m_builder.CreateICmpSLT(order, AddInt32Literal(m_context, 0), "less_than_0");
+    Value *isPrefix = m_builder.CreateICmpEQ(order, AddInt32Literal(m_context, 0), "is_0");
+    return m_builder.CreateOr(isLess, m_builder.CreateAnd(isPrefix, isShorter), "str_less");
 }
 
-CFunctionCodeGenerator::CFunctionCodeGenerator(CCodegenContext &context)
+// Значение Number, вычисленное в i64, переводится обратно в double.
+Value *CExpressionCodeGenerator::ConvertToDouble(Value *pValue)
+{
+    if (pValue->getType()->isIntegerTy(64))
+    {
+        return m_builder.CreateSIToFP(pValue, Type::getDoubleTy(m_context.GetLLVMContext()), "itofp");
+    }
+    return pValue;
+}
+
+bool CExpressionCodeGenerator::IsIntegral(IExpressionAST &expr) const
+{
+    return m_analysis.narrowing.expressions.count(&expr) != 0;
+}
+
+bool CExpressionCodeGenerator::IsTemporary(IExpressionAST &expr) const
+{
+    return m_analysis.temporaryStrings.count(&expr) != 0;
+}
+
+CFunctionCodeGenerator::CFunctionCodeGenerator(CCodegenContext &context, const FunctionAnalysis &analysis)
     : m_context(context)
+    , m_analysis(analysis)
     , m_builder(m_context.GetLLVMContext())
-    , m_exprGen(m_builder, context)
+    , m_exprGen(m_builder, context, analysis)
 {
 }
 
@@ -519,9 +2510,11 @@ void CFunctionCodeGenerator::Codegen(const ParameterDeclList &parameters, const
     BasicBlock *bb = BasicBlock::Create(m_context.GetLLVMContext(), "entry", &fn);
     m_builder.SetInsertPoint(bb);
     LoadParameters(fn, parameters);
+    DefineStringVariables();
     for (const IStatementASTUniquePtr & pAst : block)
     {
         pAst->Accept(*this);
+        ReleaseDeadStrings(*pAst);
     }
     RemoveUnusedBlocks(fn);
 }
@@ -533,41 +2526,100 @@ void CFunctionCodeGenerator::AddExitMain()
     m_builder.CreateRet(exitCode);
 }
 
+void CFunctionCodeGenerator::SetFastMathFlags(unsigned flags)
+{
+    m_builder.setFastMathFlags(ConvertFastMathFlags(flags));
+    m_exprGen.SetFastMathFlags(flags);
+}
+
+// Печать выполняется типизированными функциями библиотеки времени выполнения,
+//  которые пишут значение в общий буфер вывода без разбора строки формата.
 void CFunctionCodeGenerator::Visit(CPrintAST &ast)
 {
-    ExpressionType type = ast.GetValue().GetType();
-    Value *pValue = m_exprGen.Codegen(ast.GetValue());
-    std::string format;
+    auto *pConcat = dynamic_cast<CBinaryExpressionAST *>(&ast.GetValue());
+    if (pConcat && pConcat->GetType() == ExpressionType::String)
+    {
+        PrintConcatenation(*pConcat);
+    }
+    else
+    {
+        Value *pValue = m_exprGen.Codegen(ast.GetValue());
+        CreatePrintCall(ast.GetValue().GetType(), pValue, true);
+    }
+    FreeExpressionAllocs();
+}
+
+// `print a + String(x) + b` выводит операнды по очереди, не собирая строку в памяти,
+//  а числа и Boolean под `String(...)` форматируются прямо в буфер вывода.
+// Все операнды вычисляются до начала вывода: функция, вызванная в операнде,
+//  может сама печатать, и её вывод должен предшествовать всей строке.
+void CFunctionCodeGenerator::PrintConcatenation(CBinaryExpressionAST &expr)
+{
+    std::vector<IExpressionAST *> operands;
+    CExpressionCodeGenerator::CollectConcatOperands(expr, operands);
+    std::vector<std::pair<ExpressionType, Value *>> values;
+    values.reserve(operands.size());
+    for (IExpressionAST *pOperand : operands)
+    {
+        auto *pConversion = dynamic_cast<CConversionAST *>(pOperand);
+        if (pConversion && pConversion->GetOperand().GetType() != ExpressionType::String)
+        {
+            pOperand = &pConversion->GetOperand();
+        }
+        Value *pValue = m_exprGen.Codegen(*pOperand);
+        if (!pValue)
+        {
+            return;
+        }
+        values.emplace_back(pOperand->GetType(), pValue);
+    }
+    for (const auto &value : values)
+    {
+        CreatePrintCall(value.first, value.second, false);
+    }
+    m_builder.CreateCall(m_context.GetBuiltinFunction(BuiltinFunction::END_LINE), {});
+}
+
+// Выводит значение, а если endsLine - то и перевод строки.
+void CFunctionCodeGenerator::CreatePrintCall(ExpressionType type, Value *pValue, bool endsLine)
+{
+    BuiltinFunction printFn = BuiltinFunction::PRINT_STRING;
+    std::vector<llvm::Value *> args;
     switch (type)
     {
     case ExpressionType::Boolean:
-    {
-        // Same as `printf("%s\n", x ? "true" : "false");`
-        Value *trueStr = m_context.AddStringLiteral("true");
-        Value *falseStr = m_context.AddStringLiteral("false");
-        pValue = m_builder.CreateSelect(pValue, trueStr, falseStr, "bool2string");
-        format = "%s\n";
+        printFn = endsLine ? BuiltinFunction::PRINT_BOOLEAN : BuiltinFunction::WRITE_BOOLEAN;
+        args = {m_builder.CreateZExt(pValue, Type::getInt32Ty(m_context.GetLLVMContext()), "bool_value")};
         break;
-    }
     case ExpressionType::Number:
-        format = "%lf\n";
+        printFn = endsLine ? BuiltinFunction::PRINT_NUMBER : BuiltinFunction::WRITE_NUMBER;
+        args = {pValue};
+        break;
+    case ExpressionType::Int:
+        printFn = endsLine ? BuiltinFunction::PRINT_INT : BuiltinFunction::WRITE_INT;
+        args = {pValue};
         break;
     case ExpressionType::String:
-        format = "%s\n";
+        printFn = endsLine ? BuiltinFunction::PRINT_STRING : BuiltinFunction::WRITE_STRING;
+        args = {GetStringData(m_builder, m_context, pValue), GetStringLength(m_builder, m_context, pValue)};
         break;
     }
-
-    Constant* pFormatAddress = m_context.AddStringLiteral(format);
-    Function *pFunction = m_context.GetBuiltinFunction(BuiltinFunction::PRINTF);
-    std::vector<llvm::Value *> args = {pFormatAddress, pValue};
-    m_builder.CreateCall(pFunction, args);
-    FreeExpressionAllocs();
+    m_builder.CreateCall(m_context.GetBuiltinFunction(printFn), args);
 }
 
 void CFunctionCodeGenerator::Visit(CAssignAST &ast)
 {
-    llvm::Value *pValue = m_exprGen.Codegen(ast.GetValue());
     unsigned nameId = ast.GetNameId();
+    if (ast.GetValue().GetType() == ExpressionType::String)
+    {
+        AssignString(ast, *m_context.GetVariables().GetSymbol(nameId));
+        FreeExpressionAllocs();
+        return;
+    }
+    // Суженная переменная хранится в i64.
+    llvm::Value *pValue = m_analysis.narrowing.variables.count(nameId)
+            ? m_exprGen.CodegenIntegral(ast.GetValue())
+            : m_exprGen.Codegen(ast.GetValue());
     AllocaInst *pVar = m_context.GetVariables().GetSymbol(nameId).get_value_or(nullptr);
     if (!pVar)
     {
@@ -575,16 +2627,77 @@ void CFunctionCodeGenerator::Visit(CAssignAST &ast)
         pVar = MakeLocalVariable(*pFunction, *pValue->getType(), m_context.GetString(nameId));
         m_context.GetVariables().DefineSymbol(nameId, pVar);
     }
-    m_builder.CreateStore(MakeValueCopy(pValue), pVar);
-    if (pValue->getType()->isPointerTy())
+    m_builder.CreateStore(pValue, pVar);
+    FreeExpressionAllocs();
+}
+
+// Строковая переменная владеет своим значением: новое значение копируется
+//  или забирается у выражения, а старое освобождается.
+void CFunctionCodeGenerator::AssignString(CAssignAST &ast, AllocaInst *pVar)
+{
+    auto capacityIt = m_capacities.find(ast.GetNameId());
+    if (capacityIt != m_capacities.end() && CStringVariablesAnalysis::IsSelfAppend(ast))
     {
-        m_context.GetFunctionStrings().Manage(pValue);
+        try
+        {
+            auto &concat = static_cast<CBinaryExpressionAST &>(ast.GetValue());
+            m_exprGen.GenerateAppend(concat, pVar, capacityIt->second);
+        }
+        catch (std::exception const& ex)
+        {
+            m_context.PrintError(ex.what());
+        }
+        return;
+    }
+
+    Value *pValue = m_exprGen.Codegen(ast.GetValue());
+    if (!pValue)
+    {
+        return;
+    }
+    Value *pCopy = MakeValueCopy(pValue);
+    Value *pOldValue = m_builder.CreateLoad(pVar, "old_str");
+    m_builder.CreateStore(pCopy, pVar);
+    m_builder.CreateCall(m_context.GetBuiltinFunction(BuiltinFunction::STRING_RELEASE), {pOldValue});
+    if (capacityIt != m_capacities.end())
+    {
+        m_builder.CreateStore(AddSizeLiteral(m_context, 0), capacityIt->second);
+    }
+}
+
+// Освобождает значения переменных, которые больше не читаются, и заменяет их пустой строкой:
+//  повторное освобождение, в том числе при выходе из функции, ничего не делает.
+// Память строки, перезаписываемой в цикле, возвращается в пул на каждой итерации.
+void CFunctionCodeGenerator::ReleaseDeadStrings(const IStatementAST &ast)
+{
+    auto it = m_analysis.deadStrings.find(&ast);
+    if (it == m_analysis.deadStrings.end() || m_builder.GetInsertBlock()->getTerminator())
+    {
+        return;
+    }
+    auto *pRelease = m_context.GetBuiltinFunction(BuiltinFunction::STRING_RELEASE);
+    for (unsigned nameId : it->second)
+    {
+        AllocaInst *pVar = *m_context.GetVariables().GetSymbol(nameId);
+        Value *pOldValue = m_builder.CreateLoad(pVar, "dead_str");
+        m_builder.CreateStore(m_context.AddStringLiteral(""), pVar);
+        m_builder.CreateCall(pRelease, {pOldValue});
+        auto capacityIt = m_capacities.find(nameId);
+        if (capacityIt != m_capacities.end())
+        {
+            m_builder.CreateStore(AddSizeLiteral(m_context, 0), capacityIt->second);
+        }
     }
-    FreeExpressionAllocs();
 }
 
 void CFunctionCodeGenerator::Visit(CReturnAST &ast)
 {
+    auto *pCall = dynamic_cast<CCallAST *>(&ast.GetValue());
+    if (pCall && m_context.GetFunctions().HasSymbol(pCall->GetFunctionNameId()))
+    {
+        CodegenReturnCall(*pCall);
+        return;
+    }
     if (auto *pValue = m_exprGen.Codegen(ast.GetValue()))
     {
         pValue = MakeValueCopy(pValue);
@@ -594,6 +2707,16 @@ void CFunctionCodeGenerator::Visit(CReturnAST &ast)
     }
 }
 
+// Переход освобождает строки, которые не живы в точке назначения,
+//  и ведёт прямо в after_loop или cond ближайшего цикла.
+void CFunctionCodeGenerator::Visit(CLoopJumpAST &ast)
+{
+    const LoopTargets &loop = m_loops.back();
+    FreeExpressionAllocs();
+    ReleaseDeadStrings(ast);
+    m_builder.CreateBr((ast.GetKind() == LoopJump::Break) ? loop.breakBlock : loop.continueBlock);
+}
+
 void CFunctionCodeGenerator::Visit(CWhileAst &ast)
 {
     CodegenLoop(ast, false);
@@ -606,6 +2729,10 @@ void CFunctionCodeGenerator::Visit(CRepeatAst &ast)
 
 void CFunctionCodeGenerator::Visit(CIfAst &ast)
 {
+    if (TryCodegenLiteralSwitch(ast))
+    {
+        return;
+    }
     auto & context = m_context.GetLLVMContext();
     Function *function = m_builder.GetInsertBlock()->getParent();
     BasicBlock *thenBB = BasicBlock::Create(context, "then", function);
@@ -619,6 +2746,158 @@ void CFunctionCodeGenerator::Visit(CIfAst &ast)
     m_builder.SetInsertPoint(mergeBB);
 }
 
+// Цепочка `if x == "a" ... else if x == "b" ... else ...` из нескольких сравнений
+//  одной переменной с литералами выполняется переходом по длине строки,
+//  а среди многих литералов одной длины - ещё и по первому байту.
+// Затем по порядку ветвей проверяются только литералы, которые могут совпасть.
+// Освобождение строк после вложенных if покрывается освобождением после внешнего.
+bool CFunctionCodeGenerator::TryCodegenLiteralSwitch(CIfAst &ast)
+{
+    struct Arm
+    {
+        const std::string *pLiteral;
+        const StatementsList *pBody;
+        BasicBlock *block;
+    };
+    std::vector<Arm> arms;
+    const std::string *pLiteral = nullptr;
+    CVariableRefAST *pSubject = MatchLiteralEquality(ast.GetCondition(), pLiteral);
+    if (!pSubject)
+    {
+        return false;
+    }
+    const StatementsList *pElseBody = nullptr;
+    for (CIfAst *pIf = &ast; pIf;)
+    {
+        arms.push_back({pLiteral, &pIf->GetThenBody(), nullptr});
+        pElseBody = &pIf->GetElseBody();
+        pIf = (pElseBody->size() == 1) ? dynamic_cast<CIfAst *>(pElseBody->front().get()) : nullptr;
+        CVariableRefAST *pVariable = pIf ? MatchLiteralEquality(pIf->GetCondition(), pLiteral) : nullptr;
+        if (!pVariable || pVariable->GetNameId() != pSubject->GetNameId())
+        {
+            pIf = nullptr;
+        }
+    }
+    if (arms.size() < MIN_LITERAL_SWITCH_ARMS)
+    {
+        return false;
+    }
+
+    auto & context = m_context.GetLLVMContext();
+    Function *function = m_builder.GetInsertBlock()->getParent();
+    Value *pString = m_exprGen.Codegen(*pSubject);
+    Value *length = GetStringLength(m_builder, m_context, pString);
+    Value *pData = GetStringData(m_builder, m_context, pString);
+    BasicBlock *elseBB = BasicBlock::Create(context, "else", function);
+    BasicBlock *mergeBB = BasicBlock::Create(context, "merge_if", function);
+
+    // Проверяет литералы группы по порядку ветвей, при несовпадении всех переходит в else.
+    auto createChecks = [&](const std::vector<const Arm *> &group) {
+        for (const Arm *pArm : group)
+        {
+            BasicBlock *nextBB = BasicBlock::Create(context, "next_literal", function);
+            Value *isSame = CreateLiteralBytesEqual(m_builder, m_context, pData, *pArm->pLiteral);
+            m_builder.CreateCondBr(isSame, pArm->block, nextBB);
+            m_builder.SetInsertPoint(nextBB);
+        }
+        m_builder.CreateBr(elseBB);
+    };
+
+    std::map<size_t, std::vector<const Arm *>> armsByLength;
+    for (Arm &arm : arms)
+    {
+        arm.block = BasicBlock::Create(context, "then", function);
+        armsByLength[arm.pLiteral->size()].push_back(&arm);
+    }
+    SwitchInst *pLengthSwitch = m_builder.CreateSwitch(length, elseBB, unsigned(armsByLength.size()));
+    for (const auto &group : armsByLength)
+    {
+        BasicBlock *lengthBB = BasicBlock::Create(context, "length_case", function);
+        pLengthSwitch->addCase(AddSizeLiteral(m_context, group.first), lengthBB);
+        m_builder.SetInsertPoint(lengthBB);
+        if (group.first == 0 || group.second.size() < MIN_LITERAL_SWITCH_ARMS)
+        {
+            createChecks(group.second);
+            continue;
+        }
+        std::map<unsigned char, std::vector<const Arm *>> armsByFirstByte;
+        for (const Arm *pArm : group.second)
+        {
+            armsByFirstByte[static_cast<unsigned char>(pArm->pLiteral->front())].push_back(pArm);
+        }
+        Value *firstByte = m_builder.CreateLoad(pData, "first_byte");
+        SwitchInst *pByteSwitch = m_builder.CreateSwitch(firstByte, elseBB, unsigned(armsByFirstByte.size()));
+        for (const auto &byteGroup : armsByFirstByte)
+        {
+            BasicBlock *byteBB = BasicBlock::Create(context, "first_byte_case", function);
+            pByteSwitch->addCase(m_builder.getInt8(byteGroup.first), byteBB);
+            m_builder.SetInsertPoint(byteBB);
+            createChecks(byteGroup.second);
+        }
+    }
+
+    for (const Arm &arm : arms)
+    {
+        FillBlockAndJump(*arm.pBody, arm.block, mergeBB);
+    }
+    FillBlockAndJump(*pElseBody, elseBB, mergeBB);
+    m_builder.SetInsertPoint(mergeBB);
+    return true;
+}
+
+// Генерирует `return f(...)`.
+// Если аргументы вызова не ссылаются на освобождаемые строки, то освобождение
+//  строк выполняется до вызова, и вызов становится хвостовым:
+//  рекурсия в хвостовой позиции выполняется в постоянном объёме стека.
+void CFunctionCodeGenerator::CodegenReturnCall(CCallAST &ast)
+{
+    std::vector<Value *> args = m_exprGen.CodegenArguments(ast);
+    Function *callee = *m_context.GetFunctions().GetSymbol(ast.GetFunctionNameId());
+    if (!CanTailCall(*callee, args))
+    {
+        // Результат вызова принадлежит нам, копировать его не нужно.
+        Value *pValue = m_exprGen.CreateCall(ast, args);
+        FreeExpressionAllocs();
+        FreeFunctionAllocs();
+        m_builder.CreateRet(pValue);
+        return;
+    }
+
+    FreeExpressionAllocs();
+    FreeFunctionAllocs();
+    CallInst *pCall = m_exprGen.CreateCall(ast, args);
+    Function *caller = m_builder.GetInsertBlock()->getParent();
+    // musttail требует совпадения прототипов, иначе хвостовой вызов
+    //  гарантирует соглашение fastcc в сочетании с GuaranteedTailCallOpt.
+    const bool isSamePrototype = (caller->getFunctionType() == callee->getFunctionType());
+    pCall->setTailCallKind(isSamePrototype ? CallInst::TCK_MustTail : CallInst::TCK_Tail);
+    m_builder.CreateRet(pCall);
+}
+
+bool CFunctionCodeGenerator::CanTailCall(Function &callee, ArrayRef<Value *> args)
+{
+    Function *caller = m_builder.GetInsertBlock()->getParent();
+    if (caller->getCallingConv() != CallingConv::Fast
+            || callee.getCallingConv() != CallingConv::Fast
+            || caller->getReturnType() != callee.getReturnType())
+    {
+        return false;
+    }
+    // Строка-аргумент не должна освобождаться до вызова.
+    // Значения строковых переменных освобождаются перед хвостовым вызовом,
+    //  поэтому при их наличии допускаются только строковые литералы.
+    // Временный срез ссылается на байты другой строки оператора,
+    //  поэтому кроме литералов допускаются только значения параметров.
+    const bool hasFunctionStrings = !m_stringVariables.empty();
+    return std::none_of(args.begin(), args.end(), [&](Value *pArg) {
+        if (!IsStringValue(pArg) || isa<Constant>(pArg))
+        {
+            return false;
+        }
+        return m_context.GetExpressionStrings().IsManaged(pArg) || hasFunctionStrings || !isa<LoadInst>(pArg);
+    });
+}
+
 void CFunctionCodeGenerator::LoadParameters(Function &fn, const ParameterDeclList &parameters)
 {
     std::vector<llvm::Value*> allocs;
@@ -630,11 +2909,45 @@ void CFunctionCodeGenerator::LoadParameters(Function &fn, const ParameterDeclLis
     size_t idx = 0;
     for (auto &arg : fn.args())
     {
-        m_builder.CreateStore(&arg, allocs[idx]);
+        Value *pValue = &arg;
+        // Строкой-аргументом владеет вызывающая сторона,
+        //  поэтому перед присваиванием параметру её нужно скопировать.
+        if (m_analysis.strings.assigned.count(parameters[idx]->GetName()))
+        {
+            pValue = m_context.GetExpressionStrings().TakeStringOrCopy(m_builder, pValue);
+            m_stringVariables.push_back(cast<AllocaInst>(allocs[idx]));
+        }
+        m_builder.CreateStore(pValue, allocs[idx]);
         ++idx;
     }
 }
 
+// Создаёт заранее все строковые переменные функции, чтобы при выходе из функции
+//  освободить их значения независимо от того, какие присваивания выполнились.
+void CFunctionCodeGenerator::DefineStringVariables()
+{
+    Function &fn = *m_builder.GetInsertBlock()->getParent();
+    Type *stringType = ConvertType(m_context.GetLLVMContext(), ExpressionType::String);
+    Type *sizeType = GetPointerSizeType(m_context.GetLLVMContext());
+    for (unsigned nameId : m_analysis.strings.assigned)
+    {
+        AllocaInst *pVar = m_context.GetVariables().GetSymbol(nameId).get_value_or(nullptr);
+        if (!pVar)
+        {
+            pVar = MakeLocalVariable(fn, *stringType, m_context.GetString(nameId));
+            m_builder.CreateStore(m_context.AddStringLiteral(""), pVar);
+            m_context.GetVariables().DefineSymbol(nameId, pVar);
+            m_stringVariables.push_back(pVar);
+        }
+        if (m_analysis.strings.appended.count(nameId))
+        {
+            AllocaInst *pCapacity = MakeLocalVariable(fn, *sizeType, m_context.GetString(nameId) + ".capacity");
+            m_builder.CreateStore(AddSizeLiteral(m_context, 0), pCapacity);
+            m_capacities[nameId] = pCapacity;
+        }
+    }
+}
+
 void CFunctionCodeGenerator::CodegenLoop(CAbstractLoopAst &ast, bool skipFirstCheck)
 {
     auto & context = m_context.GetLLVMContext();
@@ -647,7 +2960,9 @@ void CFunctionCodeGenerator::CodegenLoop(CAbstractLoopAst &ast, bool skipFirstCh
     m_builder.SetInsertPoint(conditionBB);
     Value *condition = m_exprGen.Codegen(ast.GetCondition());
     m_builder.CreateCondBr(condition, loopBB, nextBB);
+    m_loops.push_back({nextBB, conditionBB});
     FillBlockAndJump(ast.GetBody(), loopBB, conditionBB);
+    m_loops.pop_back();
     m_builder.SetInsertPoint(nextBB);
 }
 
@@ -656,9 +2971,17 @@ void CFunctionCodeGenerator::FillBlockAndJump(const StatementsList &statements,
     m_builder.SetInsertPoint(block);
     for (const IStatementASTUniquePtr & pAst : statements)
     {
+        // Операторы после return, break и continue недостижимы.
+        if (m_builder.GetInsertBlock()->getTerminator())
+        {
+            break;
+        }
         pAst->Accept(*this);
+        ReleaseDeadStrings(*pAst);
     }
-    if (nextBlock && (nullptr == block->getTerminator()))
+    // Вложенные if и циклы переносят точку вставки в другой блок,
+    //  поэтому проверяется текущий блок, а не начальный.
+    if (nextBlock && (nullptr == m_builder.GetInsertBlock()->getTerminator()))
     {
         m_builder.CreateBr(nextBlock);
     }
@@ -667,7 +2990,7 @@ void CFunctionCodeGenerator::FillBlockAndJump(const StatementsList &statements,
 Value *CFunctionCodeGenerator::MakeValueCopy(Value *pValue)
 {
     // Если значение строковое, забираем владение оригиналом или дублем строки.
-    if (pValue->getType()->isPointerTy())
+    if (IsStringValue(pValue))
     {
         return m_context.GetExpressionStrings().TakeStringOrCopy(m_builder, pValue);
     }
@@ -676,15 +2999,24 @@ Value *CFunctionCodeGenerator::MakeValueCopy(Value *pValue)
 
 void CFunctionCodeGenerator::FreeExpressionAllocs()
 {
+    if (m_context.GetExpressionStrings().HasTemporaries())
+    {
+        // Откат арены к отметке функции освобождает временные строки оператора разом.
+        auto *pRelease = m_context.GetBuiltinFunction(BuiltinFunction::ARENA_RELEASE);
+        m_builder.CreateCall(pRelease, {m_exprGen.GetArenaMark()});
+    }
     m_context.GetExpressionStrings().FreeAll(m_builder);
     m_context.GetExpressionStrings().Clear();
 }
 
 void CFunctionCodeGenerator::FreeFunctionAllocs()
 {
-    // Грубая очистка памяти строк, сохранённых в переменных функции.
-    // Не будет корректно работать при наличии более одной области видимости в функции.
-    m_context.GetFunctionStrings().FreeAll(m_builder);
+    // Освобождает ссылки на текущие значения строковых переменных функции.
+    auto *pRelease = m_context.GetBuiltinFunction(BuiltinFunction::STRING_RELEASE);
+    for (AllocaInst *pVar : m_stringVariables)
+    {
+        m_builder.CreateCall(pRelease, {m_builder.CreateLoad(pVar, "var_str")});
+    }
 }
 
 // Убирает неиспользуемые блоки.
@@ -719,10 +3051,21 @@ CCodeGenerator::CCodeGenerator(CCodegenContext &context)
 {
 }
 
-Function *CCodeGenerator::AcceptFunction(IFunctionAST &ast)
+Function *CCodeGenerator::AcceptDeclaration(IFunctionAST &ast)
 {
     Function *fn = GenerateDeclaration(ast, false);
     m_context.GetFunctions().DefineSymbol(ast.GetNameId(), fn);
+
+    return fn;
+}
+
+Function *CCodeGenerator::AcceptFunction(IFunctionAST &ast)
+{
+    Function *fn = m_context.GetFunctions().GetSymbol(ast.GetNameId()).get_value_or(nullptr);
+    if (!fn)
+    {
+        fn = AcceptDeclaration(ast);
+    }
     GenerateDefinition(*fn, ast, false);
 
     return fn;
@@ -736,6 +3079,11 @@ Function *CCodeGenerator::AcceptMainFunction(IFunctionAST &ast)
     return fn;
 }
 
+void CCodeGenerator::AcceptModuleEnd()
+{
+    m_context.FinishModule();
+}
+
 Function *CCodeGenerator::GenerateDeclaration(IFunctionAST &ast, bool isMain)
 {
     auto & context = m_context.GetLLVMContext();
@@ -750,6 +3098,12 @@ Function *CCodeGenerator::GenerateDeclaration(IFunctionAST &ast, bool isMain)
     FunctionType *fnType = FunctionType::get(returnType, args, false);
     std::string fnName = m_context.GetString(ast.GetNameId());
     Function *fn = Function::Create(fnType, Function::ExternalLinkage, fnName, &module);
+    // Соглашение fastcc позволяет гарантировать хвостовые вызовы
+    //  между функциями с разными прототипами, main вызывается из CRT.
+    if (!isMain)
+    {
+        fn->setCallingConv(CallingConv::Fast);
+    }
 
     auto argIt = fn->args().begin();
     for (const auto &pAst : ast.GetParameters())
@@ -764,7 +3118,20 @@ Function *CCodeGenerator::GenerateDeclaration(IFunctionAST &ast, bool isMain)
 bool CCodeGenerator::GenerateDefinition(Function &fn, IFunctionAST &ast, bool isMain)
 {
     CFunctionScopeLock scopedScope(m_context);
-    CFunctionCodeGenerator generator(m_context);
+    FunctionAnalysis analysis;
+    analysis.narrowing = CRangeAnalysis().Analyze(ast);
+    analysis.temporaryStrings = CEscapeAnalysis().Analyze(ast);
+    if (m_context.GetOptions().reportNarrowing)
+    {
+        ReportNarrowing(ast, analysis.narrowing);
+    }
+    analysis.strings = CStringVariablesAnalysis().Analyze(ast);
+    analysis.deadStrings = CStringLivenessAnalysis().Analyze(ast, analysis.strings.assigned);
+    CFunctionCodeGenerator generator(m_context, analysis);
+
+    const unsigned fastMathFlags = m_context.GetOptions().fastMathFlags | ast.GetFastMathFlags();
+    generator.SetFastMathFlags(fastMathFlags);
+    AddFastMathAttributes(fn, fastMathFlags);
 
     generator.Codegen(ast.GetParameters(), ast.GetBody(), fn);
     if (isMain)
@@ -784,3 +3151,18 @@ bool CCodeGenerator::GenerateDefinition(Function &fn, IFunctionAST &ast, bool is
     }
     return true;
 }
+
+void CCodeGenerator::ReportNarrowing(IFunctionAST &ast, const NumberNarrowing &narrowing)
+{
+    std::vector<std::string> names;
+    for (unsigned nameId : narrowing.variables)
+    {
+        names.push_back(m_context.GetString(nameId));
+    }
+    boost::sort(names);
+    const std::string fnName = m_context.GetString(ast.GetNameId());
+    for (const std::string &name : names)
+    {
+        m_context.PrintNote("in function " + fnName + ": Number variable " + name + " is stored as 64-bit integer");
+    }
+}
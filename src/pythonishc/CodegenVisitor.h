@@ -3,9 +3,16 @@
 #include <stdint.h>
 #include <vector>
 #include <unordered_set>
+#include <unordered_map>
 #include "ASTVisitor.h"
 #include "AST.h"
 #include "Utility.h"
+#include "CodegenOptions.h"
+#include "RangeAnalysis.h"
+#include "EscapeAnalysis.h"
+#include "StringVariablesAnalysis.h"
+#include "StringLivenessAnalysis.h"
+#include "Builtins.h"
 
 #include "begin_llvm.h"
 #include <llvm/IR/Value.h>
@@ -25,17 +32,48 @@ class Constant;
 
 enum class BuiltinFunction
 {
-    PRINTF,
-    STRCPY,
-    STRDUP,
-    STRLEN,
-    STRCMP,
+    MEMCPY,
+    MEMCMP,
+    // Пул библиотеки времени выполнения либо malloc/free при CodegenOptions::useLibCAllocator.
     MALLOC,
     FREE,
+    STRING_RETAIN,
+    STRING_RELEASE,
+    ARENA_ALLOC,
+    ARENA_MARK,
+    ARENA_RELEASE,
+    PRINT_STRING,
+    PRINT_NUMBER,
+    PRINT_INT,
+    PRINT_BOOLEAN,
+    WRITE_STRING,
+    WRITE_NUMBER,
+    WRITE_INT,
+    WRITE_BOOLEAN,
+    END_LINE,
+    FORMAT_NUMBER,
+    FORMAT_INT,
+    INTERN,
+    INTERN_LITERALS,
+    FIND,
+    READ_LINE,
+    READ_NUMBER,
+    END_OF_INPUT,
+    FILE_OPEN,
+    FILE_READ_ALL,
+    FILE_WRITE,
+    FILE_WRITE_LINE,
+    FILE_CLOSE,
 };
 
 /*
- * Хранит регистры с указателями на строки, которыми никто не владеет.
+ * Строка String передаётся по значению как структура {i8* data, size_t length}.
+ * Байты строки не завершаются нулём, длина всегда известна без сканирования.
+ * Перед байтами хранится счётчик ссылок: копирование строки увеличивает счётчик,
+ *  литералы в глобальных константах бессмертны, временные строки копируются при сохранении.
+ * Срез ссылается на байты исходной строки и владеет ссылкой на неё.
+ *
+ * Хранит регистры со строками, которыми никто не владеет.
  * Пока указателями никто не владеет, этот класс позволяет управлять их временем жизни.
  * Это один из элементов гарантии отсутствия утечек памяти.
  */
@@ -45,22 +83,39 @@ public:
     CManagedStrings(CCodegenContext &context);
     ~CManagedStrings();
 
-    // Вызывает free() для всех строк.
+    // Освобождает ссылки на все строки, кроме временных.
+    // Временные строки освобождаются откатом арены в конце оператора.
     void FreeAll(llvm::IRBuilder<> & builder);
 
+    // Возвращает строки под контролем, кроме временных.
+    std::unordered_set<llvm::Value *> GetPointers()const;
+    // Освобождает ссылки на строки под контролем, кроме временных и строк из kept,
+    //  и снимает их с контроля.
+    void FreeAllExcept(llvm::IRBuilder<> & builder, const std::unordered_set<llvm::Value *> &kept);
+
     // Сбрасывает список неудалённых строк.
     void Clear();
 
     // Если строкой никто не владеет, снимает её с контроля и возвращает.
-    // Иначе дублирует строку и возвращает дубликат.
+    // Иначе захватывает ещё одну ссылку на строку (временная строка копируется).
     llvm::Value *TakeStringOrCopy(llvm::IRBuilder<> & builder, llvm::Value *pString);
 
     // Добавляет строку под контроль времени жизни.
     void Manage(llvm::Value *pString);
 
+    // Добавляет под контроль временную строку из буфера на стеке или из арены.
+    // Такую строку нельзя забрать, TakeStringOrCopy вернёт её дубликат.
+    void ManageTemporary(llvm::Value *pString);
+
+    // Возвращает true, если строка находится под контролем.
+    bool IsManaged(llvm::Value *pString)const;
+    bool IsEmpty()const;
+    bool HasTemporaries()const;
+
 private:
     CCodegenContext &m_context;
     std::unordered_set<llvm::Value *> m_pointers;
+    std::unordered_set<llvm::Value *> m_temporaries;
 };
 
 class CCodegenContext
@@ -71,38 +126,83 @@ public:
 
     std::string GetString(unsigned stringId)const;
     void PrintError(std::string const& message) const;
+    void PrintNote(std::string const& message) const;
     llvm::LLVMContext &GetLLVMContext();
     llvm::Module &GetModule();
+    const CodegenOptions &GetOptions()const;
+    void SetOptions(const CodegenOptions &options);
     CScopeChain<llvm::AllocaInst*> &GetVariables();
     CScopeChain<llvm::Function*> &GetFunctions();
     std::unordered_map<std::string, llvm::Constant *> GetStrings();
+    // Возвращает константу типа String.
     llvm::Constant *AddStringLiteral(const std::string &value);
+    // Возвращает указатель на завершённую нулём строку, например, формат printf.
+    llvm::Constant *AddCStringLiteral(const std::string &value);
+    // Собирает значение String из указателя на байты и длины.
+    llvm::Value *CreateString(llvm::IRBuilder<> & builder, llvm::Value *data, llvm::Value *length);
 
     llvm::Function *GetBuiltinFunction(BuiltinFunction id)const;
     CManagedStrings &GetExpressionStrings();
-    CManagedStrings &GetFunctionStrings();
+    // Отмечает, что программа интернирует строки: тогда её литералы попадут в таблицу до вызова main.
+    void UseInterning();
+    // Дополняет модуль после генерации всех функций.
+    void FinishModule();
 
 private:
     void InitLibCBuiltins();
+    void InitStringBuiltins();
+    void InitRuntimeBuiltins();
 
     CFrontendContext &m_context;
+    CodegenOptions m_options;
     std::unique_ptr<llvm::LLVMContext> m_pLLVMContext;
     std::unique_ptr<llvm::Module> m_pModule;
     std::map<BuiltinFunction, llvm::Function*> m_builtinFunctions;
     CScopeChain<llvm::AllocaInst*> m_variables;
     CScopeChain<llvm::Function*> m_functions;
     std::unordered_map<std::string, llvm::Constant *> m_strings;
+    std::unordered_map<std::string, llvm::Constant *> m_stringLiterals;
     CManagedStrings m_expressionStrings;
-    CManagedStrings m_functionStrings;
+    bool m_usesInterning = false;
+};
+
+// Результаты анализа тела функции, которые использует кодогенератор.
+struct FunctionAnalysis
+{
+    NumberNarrowing narrowing;
+    // Строковые выражения, значения которых не покидают оператор.
+    std::unordered_set<const IExpressionAST *> temporaryStrings;
+    StringVariables strings;
+    DeadStrings deadStrings;
 };
 
 class CExpressionCodeGenerator : protected IExpressionVisitor
 {
 public:
-    CExpressionCodeGenerator(llvm::IRBuilder<> & builder, CCodegenContext & context);
+    CExpressionCodeGenerator(llvm::IRBuilder<> & builder, CCodegenContext & context,
+                             const FunctionAnalysis & analysis);
 
     // Can throw std::exception.
     llvm::Value *Codegen(IExpressionAST & ast);
+    // Генерирует код выражения, которое анализ диапазонов признал целочисленным,
+    //  и возвращает его значение в виде i64.
+    llvm::Value *CodegenIntegral(IExpressionAST & ast);
+
+    // Вычисляет аргументы вызова, не создавая саму инструкцию call.
+    std::vector<llvm::Value *> CodegenArguments(CCallAST & expr);
+    // Создаёт инструкцию call с заранее вычисленными аргументами.
+    llvm::CallInst *CreateCall(CCallAST & expr, llvm::ArrayRef<llvm::Value *> args);
+    // Дописывает операнды конкатенации `x = x + ...`, кроме первого, в буфер переменной x.
+    // Can throw std::exception.
+    void GenerateAppend(CBinaryExpressionAST & expr, llvm::AllocaInst *pVar, llvm::AllocaInst *pCapacity);
+    void SetFastMathFlags(unsigned flags);
+    // Сравнивает строку со строковым литералом.
+    llvm::Value *GenerateLiteralEquals(llvm::Value *pString, const std::string &literal);
+    // Собирает операнды цепочки конкатенаций `a + b + ... + z` слева направо.
+    static void CollectConcatOperands(IExpressionAST & expr, std::vector<IExpressionAST *> & operands);
+    // Отметка арены, полученная при входе в функцию, или nullptr,
+    //  если функция не размещает временные строки в арене.
+    llvm::Value *GetArenaMark()const;
 
 protected:
     void Visit(CBinaryExpressionAST &expr) override;
@@ -111,39 +211,92 @@ protected:
     void Visit(CCallAST &expr) override;
     void Visit(CVariableRefAST &expr) override;
     void Visit(CParameterDeclAST & expr) override;
+    void Visit(CConversionAST & expr) override;
+    void Visit(CSliceAST & expr) override;
 
 private:
     llvm::Value *GenerateNumericExpr(llvm::Value *a, BinaryOperation op, llvm::Value *b);
+    llvm::Value *GenerateIntegerExpr(llvm::Value *a, BinaryOperation op, llvm::Value *b);
+    llvm::Value *GenerateIntExpr(llvm::Value *a, BinaryOperation op, llvm::Value *b);
+    llvm::Value *GenerateIntDivision(llvm::Value *a, BinaryOperation op, llvm::Value *b);
+    llvm::Value *GenerateDoubleToInt(llvm::Value *x);
+    llvm::Value *TryGenerateFMulAdd(llvm::Value *a, BinaryOperation op, llvm::Value *b);
+    llvm::Value *TryGenerateReciprocalMul(llvm::Value *a, llvm::Value *b);
     llvm::Value *GenerateStringExpr(llvm::Value *a, BinaryOperation op, llvm::Value *b);
+    // Байты и длина строки-операнда конкатенации.
+    struct StringPiece
+    {
+        llvm::Value *pData;
+        llvm::Value *length;
+    };
+
+    llvm::Value *GenerateConcatenation(CBinaryExpressionAST & expr);
+    llvm::Value *CreateStringFromPieces(llvm::ArrayRef<StringPiece> pieces, bool isTemporary);
+    llvm::Value *GenerateToString(llvm::Value *x, ExpressionType type, bool isTemporary);
+    StringPiece GenerateText(llvm::Value *x, ExpressionType type);
+    std::vector<StringPiece> CodegenConcatPieces(const std::vector<IExpressionAST *> & operands);
+    void CopyConcatPieces(llvm::Value *pData, llvm::Value *offset, llvm::ArrayRef<StringPiece> pieces);
+    llvm::Value *AllocateString(llvm::Value *length, bool isTemporary);
     llvm::Value *GenerateBooleanExpr(llvm::Value *a, BinaryOperation op, llvm::Value *b);
-    llvm::Value *GenerateStrcmp(llvm::Value *a, llvm::Value *b);
+    llvm::Value *GenerateLogicalExpr(CBinaryExpressionAST & expr);
+    llvm::Value *GenerateStringEquals(llvm::Value *a, llvm::Value *b);
+    llvm::Value *GenerateSlice(llvm::Value *pString, llvm::Value *begin, llvm::Value *end, bool isTemporary);
+    llvm::Value *GenerateBuiltinCall(CCallAST & expr, BuiltinCall id, llvm::ArrayRef<llvm::Value *> args);
+    llvm::Value *GenerateIntern(llvm::Value *pString);
+    llvm::Value *GenerateFind(llvm::Value *pString, llvm::Value *pSubstring);
+    // Вызывает встроенную функцию LLVM над числами double.
+    llvm::Value *CreateMathIntrinsic(llvm::Intrinsic::ID id, llvm::ArrayRef<llvm::Value *> args);
+    llvm::Value *GenerateSqrt(llvm::Value *x);
+    // Вызывает функцию ввода, которая записывает строку в переданный последним аргументом слот.
+    llvm::Value *GenerateReadString(BuiltinFunction id, llvm::ArrayRef<llvm::Value *> args);
+    llvm::Value *GenerateStartsWith(CCallAST & expr, llvm::Value *pString, llvm::Value *pPrefix);
+    llvm::Value *GenerateStringLess(const StringPiece &a, const StringPiece &b);
+    bool TryGenerateLiteralCompare(CBinaryExpressionAST & expr);
+    llvm::Value *ConvertToDouble(llvm::Value *pValue);
+    bool IsIntegral(IExpressionAST & expr)const;
+    bool IsTemporary(IExpressionAST & expr)const;
 
     // Стек используется для временного хранения
     // по мере рекурсивного обхода дерева выражения.
     std::vector<llvm::Value *> m_values;
     CCodegenContext & m_context;
     llvm::IRBuilder<> & m_builder;
+    const FunctionAnalysis & m_analysis;
+    unsigned m_fastMathFlags = 0;
+    // Суммарный размер буферов на стеке для временных строк функции.
+    unsigned m_stackBuffersSize = 0;
+    llvm::Value *m_pArenaMark = nullptr;
 };
 
 class CFunctionCodeGenerator : protected IStatementVisitor
 {
 public:
-    CFunctionCodeGenerator(CCodegenContext & context);
+    CFunctionCodeGenerator(CCodegenContext & context, const FunctionAnalysis & analysis);
 
     void Codegen(const ParameterDeclList &parameters, const StatementsList &block, llvm::Function & fn);
     void AddExitMain();
+    void SetFastMathFlags(unsigned flags);
 
     // IStatementVisitor interface
 protected:
     void Visit(CPrintAST &ast) override;
     void Visit(CAssignAST &ast) override;
     void Visit(CReturnAST &ast) override;
+    void Visit(CLoopJumpAST &ast) override;
     void Visit(CWhileAst &ast) override;
     void Visit(CRepeatAst &ast) override;
     void Visit(CIfAst &ast) override;
 
 private:
+    void PrintConcatenation(CBinaryExpressionAST &expr);
+    void CreatePrintCall(ExpressionType type, llvm::Value *pValue, bool endsLine);
+    bool TryCodegenLiteralSwitch(CIfAst &ast);
+    void CodegenReturnCall(CCallAST &ast);
+    bool CanTailCall(llvm::Function &callee, llvm::ArrayRef<llvm::Value *> args);
     void LoadParameters(llvm::Function &fn, const ParameterDeclList &parameterNames);
+    void DefineStringVariables();
+    void AssignString(CAssignAST &ast, llvm::AllocaInst *pVar);
+    void ReleaseDeadStrings(const IStatementAST &ast);
     void CodegenLoop(CAbstractLoopAst &ast, bool skipFirstCheck);
     void FillBlockAndJump(const StatementsList &statements,
                           llvm::BasicBlock *block, llvm::BasicBlock *nextBlock);
@@ -153,20 +306,38 @@ private:
     void RemoveUnusedBlocks(llvm::Function &fn);
 
     CCodegenContext & m_context;
+    const FunctionAnalysis & m_analysis;
     llvm::IRBuilder<> m_builder;
     CExpressionCodeGenerator m_exprGen;
+    // Строковые переменные, которые владеют своим значением.
+    std::vector<llvm::AllocaInst *> m_stringVariables;
+    // Ёмкость буфера дописываемых переменных, 0 - буфер без запаса.
+    std::unordered_map<unsigned, llvm::AllocaInst *> m_capacities;
+    // Блоки, в которые переходят break и continue объемлющих циклов.
+    struct LoopTargets
+    {
+        llvm::BasicBlock *breakBlock;
+        llvm::BasicBlock *continueBlock;
+    };
+    std::vector<LoopTargets> m_loops;
 };
 
 class CCodeGenerator
 {
 public:
     CCodeGenerator(CCodegenContext & context);
+    // Объявляет функцию заранее, чтобы её можно было вызвать до определения,
+    //  например, при взаимной рекурсии.
+    llvm::Function *AcceptDeclaration(IFunctionAST & ast);
     llvm::Function *AcceptFunction(IFunctionAST & ast);
     llvm::Function *AcceptMainFunction(IFunctionAST & ast);
+    // Вызывается после генерации всех функций программы.
+    void AcceptModuleEnd();
 
 private:
     llvm::Function *GenerateDeclaration(IFunctionAST & ast, bool isMain);
     bool GenerateDefinition(llvm::Function &fn, IFunctionAST & ast, bool isMain);
+    void ReportNarrowing(IFunctionAST & ast, const NumberNarrowing & narrowing);
 
     CCodegenContext & m_context;
 };
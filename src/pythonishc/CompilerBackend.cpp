@@ -12,6 +12,9 @@
 #include <llvm/Support/TargetSelect.h>
 #include <llvm/IR/LegacyPassManager.h>
 #include <llvm/Analysis/TargetLibraryInfo.h>
+#include <llvm/Analysis/TargetTransformInfo.h>
+#include <llvm/Transforms/IPO.h>
+#include <llvm/Transforms/IPO/PassManagerBuilder.h>
 #include <llvm/ADT/STLExtras.h>
 #include <llvm/MC/SubtargetFeature.h>
 #include "end_llvm.h"
@@ -94,11 +97,44 @@ std::unique_ptr<TargetMachine> MakeTargetMachine(const Target *target, const Tri
     CodeGenOpt::Level optLevel = isDebug ? CodeGenOpt::None : CodeGenOpt::Default;
     TargetOptions options;
     options.MCOptions.AsmVerbose = isDebug;
+    // Хвостовые вызовы между fastcc-функциями выполняются всегда, а не только при возможности.
+    options.GuaranteedTailCallOpt = true;
 
     return std::unique_ptr<TargetMachine>(target->createTargetMachine(triple.getTriple(), cpuName, featuresStr,
                                                                       options, Reloc::PIC_, CodeModel::Default, optLevel));
 }
 
+// Запускает стандартный конвейер оптимизаций уровня -O2.
+// Без него флаги FastMath не влияют на код: переупорядочивание сумм
+//  и векторизацию циклов выполняют проходы оптимизатора IR.
+void OptimizeModule(Module &module, TargetMachine &targetMachine, const Triple &triple)
+{
+    PassManagerBuilder builder;
+    builder.OptLevel = 2;
+    builder.SizeLevel = 0;
+    builder.Inliner = createFunctionInliningPass();
+    builder.LoopVectorize = true;
+    builder.SLPVectorize = true;
+    // Объект удалит PassManagerBuilder.
+    builder.LibraryInfo = new TargetLibraryInfoImpl(triple);
+
+    legacy::FunctionPassManager functionPasses(&module);
+    functionPasses.add(createTargetTransformInfoWrapperPass(targetMachine.getTargetIRAnalysis()));
+    builder.populateFunctionPassManager(functionPasses);
+
+    legacy::PassManager modulePasses;
+    modulePasses.add(createTargetTransformInfoWrapperPass(targetMachine.getTargetIRAnalysis()));
+    builder.populateModulePassManager(modulePasses);
+
+    functionPasses.doInitialization();
+    for (Function &fn : module)
+    {
+        functionPasses.run(fn);
+    }
+    functionPasses.doFinalization();
+    modulePasses.run(module);
+}
+
 }
 
 CCompilerBackend::CCompilerBackend()
@@ -132,6 +168,11 @@ void CCompilerBackend::GenerateObjectFile(Module &module, bool isDebug, const st
     // Передаём в модуль IR-кода данные целевой платформы.
     module.setDataLayout(targetMachine->createDataLayout());
 
+    if (!isDebug)
+    {
+        OptimizeModule(module, *targetMachine, hostTriple);
+    }
+
     // Предлагаем целевой платформе добавить проходы кодогенератора.
     if (targetMachine->addPassesToEmitFile(passMananger, out->os(), TargetMachine::CGFT_ObjectFile,
                                            false, nullptr, nullptr, nullptr, nullptr))
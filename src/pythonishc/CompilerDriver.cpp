@@ -71,6 +71,15 @@ public:
 
             CCodeGenerator codegen(m_codegenContext);
             unsigned mainId = m_stringPool.Insert(C_MAIN_FUNC);
+            // Сначала объявляем все функции, чтобы функции могли вызывать друг друга
+            //  независимо от порядка определения.
+            for (const auto &pAst : pProgram->GetFunctions())
+            {
+                if (pAst->GetNameId() != mainId)
+                {
+                    codegen.AcceptDeclaration(*pAst);
+                }
+            }
             for (const auto &pAst : pProgram->GetFunctions())
             {
                 if (pAst->GetNameId() == mainId)
@@ -82,6 +91,7 @@ public:
                     codegen.AcceptFunction(*pAst);
                 }
             }
+            codegen.AcceptModuleEnd();
 
             ThrowIfCompileErrors();
 
@@ -128,6 +138,11 @@ public:
         }
     }
 
+    void SetCodegenOptions(const CodegenOptions &options)
+    {
+        m_codegenContext.SetOptions(options);
+    }
+
     void StartDebugTrace()
     {
 #ifndef NDEBUG
@@ -211,6 +226,11 @@ void CCompilerDriver::StartDebugTrace()
     m_pImpl->StartDebugTrace();
 }
 
+void CCompilerDriver::SetCodegenOptions(const CodegenOptions &options)
+{
+    m_pImpl->SetCodegenOptions(options);
+}
+
 bool CCompilerDriver::Compile(const std::string &inputPath, const std::string &outputPath)
 {
     return m_pImpl->Compile(inputPath, outputPath);
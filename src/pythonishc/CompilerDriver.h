@@ -2,6 +2,7 @@
 
 #include <iostream>
 #include <memory>
+#include "CodegenOptions.h"
 
 class CCompilerDriver
 {
@@ -10,6 +11,7 @@ public:
     ~CCompilerDriver();
 
     void StartDebugTrace();
+    void SetCodegenOptions(const CodegenOptions &options);
 
     /**
      * @param inputPath - input file path
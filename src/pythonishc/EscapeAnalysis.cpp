@@ -0,0 +1,119 @@
+#include "EscapeAnalysis.h"
+
+std::unordered_set<const IExpressionAST *> CEscapeAnalysis::Analyze(IFunctionAST &ast)
+{
+    m_temporaries.clear();
+    Execute(ast.GetBody());
+    return std::move(m_temporaries);
+}
+
+void CEscapeAnalysis::Visit(CPrintAST &ast)
+{
+    Walk(ast.GetValue(), false);
+}
+
+void CEscapeAnalysis::Visit(CAssignAST &ast)
+{
+    Walk(ast.GetValue(), true);
+}
+
+void CEscapeAnalysis::Visit(CReturnAST &ast)
+{
+    Walk(ast.GetValue(), true);
+}
+
+void CEscapeAnalysis::Visit(CLoopJumpAST &)
+{
+}
+
+void CEscapeAnalysis::Visit(CWhileAst &ast)
+{
+    Walk(ast.GetCondition(), false);
+    Execute(ast.GetBody());
+}
+
+void CEscapeAnalysis::Visit(CRepeatAst &ast)
+{
+    Execute(ast.GetBody());
+    Walk(ast.GetCondition(), false);
+}
+
+void CEscapeAnalysis::Visit(CIfAst &ast)
+{
+    Walk(ast.GetCondition(), false);
+    Execute(ast.GetThenBody());
+    Execute(ast.GetElseBody());
+}
+
+void CEscapeAnalysis::Visit(CBinaryExpressionAST &expr)
+{
+    WalkOperand(expr.GetLeft());
+    WalkOperand(expr.GetRight());
+}
+
+void CEscapeAnalysis::Visit(CUnaryExpressionAST &expr)
+{
+    WalkOperand(expr.GetOperand());
+}
+
+void CEscapeAnalysis::Visit(CLiteralAST &)
+{
+}
+
+void CEscapeAnalysis::Visit(CCallAST &expr)
+{
+    for (const auto &pArg : expr.GetArguments())
+    {
+        WalkOperand(*pArg);
+    }
+}
+
+void CEscapeAnalysis::Visit(CVariableRefAST &)
+{
+}
+
+void CEscapeAnalysis::Visit(CParameterDeclAST &)
+{
+}
+
+void CEscapeAnalysis::Visit(CConversionAST &expr)
+{
+    WalkOperand(expr.GetOperand());
+}
+
+// Срез, который покидает оператор, захватывает ссылку на исходную строку,
+//  поэтому исходная строка может быть временной.
+void CEscapeAnalysis::Visit(CSliceAST &expr)
+{
+    WalkOperand(expr.GetOperand());
+    for (IExpressionAST *pBound : {expr.GetBegin(), expr.GetEnd()})
+    {
+        if (pBound)
+        {
+            WalkOperand(*pBound);
+        }
+    }
+}
+
+void CEscapeAnalysis::Execute(const StatementsList &statements)
+{
+    for (const auto &pStmt : statements)
+    {
+        pStmt->Accept(*this);
+    }
+}
+
+void CEscapeAnalysis::Walk(IExpressionAST &expr, bool isEscaping)
+{
+    if (!isEscaping && expr.GetType() == ExpressionType::String)
+    {
+        m_temporaries.insert(&expr);
+    }
+    expr.Accept(*this);
+}
+
+// Операнд выражения используется только при вычислении этого выражения.
+void CEscapeAnalysis::WalkOperand(IExpressionAST &expr)
+{
+    Walk(expr, false);
+}
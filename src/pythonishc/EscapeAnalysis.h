@@ -0,0 +1,42 @@
+#pragma once
+
+#include <unordered_set>
+#include "ASTVisitor.h"
+#include "AST.h"
+
+// Находит строковые выражения, значения которых не покидают оператор:
+//  они печатаются, сравниваются, участвуют в конкатенации или передаются в функцию.
+// Вызываемая функция не сохраняет аргумент: присваивание и return копируют строку.
+// Покидают оператор только значения, которые присваиваются переменной или возвращаются.
+class CEscapeAnalysis
+        : protected IStatementVisitor
+        , protected IExpressionVisitor
+{
+public:
+    std::unordered_set<const IExpressionAST *> Analyze(IFunctionAST &ast);
+
+protected:
+    void Visit(CPrintAST &ast) override;
+    void Visit(CAssignAST &ast) override;
+    void Visit(CReturnAST &ast) override;
+    void Visit(CLoopJumpAST &ast) override;
+    void Visit(CWhileAst &ast) override;
+    void Visit(CRepeatAst &ast) override;
+    void Visit(CIfAst &ast) override;
+
+    void Visit(CBinaryExpressionAST &expr) override;
+    void Visit(CUnaryExpressionAST &expr) override;
+    void Visit(CLiteralAST &expr) override;
+    void Visit(CCallAST &expr) override;
+    void Visit(CVariableRefAST &expr) override;
+    void Visit(CParameterDeclAST &expr) override;
+    void Visit(CConversionAST &expr) override;
+    void Visit(CSliceAST &expr) override;
+
+private:
+    void Execute(const StatementsList &statements);
+    void Walk(IExpressionAST &expr, bool isEscaping);
+    void WalkOperand(IExpressionAST &expr);
+
+    std::unordered_set<const IExpressionAST *> m_temporaries;
+};
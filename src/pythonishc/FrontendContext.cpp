@@ -32,6 +32,11 @@ void CFrontendContext::PrintError(const std::string &message)const
     m_errors << "error: " << message << std::endl;
 }
 
+void CFrontendContext::PrintNote(const std::string &message) const
+{
+    m_errors << "note: " << message << std::endl;
+}
+
 unsigned CFrontendContext::GetErrorsCount() const
 {
     return m_errorsCount;
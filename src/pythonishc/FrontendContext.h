@@ -15,6 +15,7 @@ public:
 
     std::string GetString(unsigned stringId)const;
     void PrintError(std::string const& message) const;
+    void PrintNote(std::string const& message) const;
     unsigned GetErrorsCount()const;
 
 private:
@@ -64,21 +64,22 @@ using namespace parser_private;
 **                       defined, then do no error processing.
 */
 #define YYCODETYPE unsigned char
-#define YYNOCODE 44
+#define YYNOCODE 73
 #define YYACTIONTYPE unsigned char
 #define ParseGrammarTOKENTYPE Token
 typedef union {
   int yyinit;
   ParseGrammarTOKENTYPE yy0;
-  StatementListPtr yy2;
-  ParameterDeclPtr yy6;
-  ParameterDeclListPtr yy10;
-  StatementPtr yy16;
-  FunctionPtr yy55;
-  ExpressionListPtr yy63;
-  int yy64;
-  ExpressionPtr yy65;
-  int yy87;
+  StatementPtr yy12;
+  StatementListPtr yy13;
+  ParameterDeclPtr yy16;
+  ExpressionListPtr yy23;
+  unsigned yy46;
+  ExpressionPtr yy71;
+  int yy76;
+  FunctionPtr yy81;
+  ParameterDeclListPtr yy112;
+  int yy145;
 } YYMINORTYPE;
 #ifndef YYSTACKDEPTH
 #define YYSTACKDEPTH 100
@@ -87,10 +88,10 @@ typedef union {
 #define ParseGrammarARG_PDECL ,CParser *pParse
 #define ParseGrammarARG_FETCH CParser *pParse = yypParser->pParse
 #define ParseGrammarARG_STORE yypParser->pParse = pParse
-#define YYNSTATE 99
-#define YYNRULE 48
-#define YYERRORSYMBOL 28
-#define YYERRSYMDT yy87
+#define YYNSTATE 160
+#define YYNRULE 78
+#define YYERRORSYMBOL 54
+#define YYERRSYMDT yy145
 #define YY_NO_ACTION      (YYNSTATE+YYNRULE+2)
 #define YY_ACCEPT_ACTION  (YYNSTATE+YYNRULE+1)
 #define YY_ERROR_ACTION   (YYNSTATE+YYNRULE)
@@ -159,91 +160,190 @@ static const YYMINORTYPE yyzerominor = { 0 };
 **                     shifting non-terminals after a reduce.
 **  yy_default[]       Default action for each state.
 */
-#define YY_ACTTAB_COUNT (222)
+#define YY_ACTTAB_COUNT (653)
 static const YYACTIONTYPE yy_action[] = {
- /*     0 */    30,   29,   27,   26,   25,   24,   23,    1,   27,   26,
- /*    10 */    25,   24,   23,   73,   97,   30,   29,   27,   26,   25,
- /*    20 */    24,   23,    1,   58,   96,   59,   77,   10,   72,    5,
- /*    30 */    30,   29,   27,   26,   25,   24,   23,   30,   29,   27,
- /*    40 */    26,   25,   24,   23,    2,   86,   30,   29,   27,   26,
- /*    50 */    25,   24,   23,    1,   22,   21,   58,   35,   59,   77,
- /*    60 */     9,   44,   57,   76,   56,   53,   28,   78,   19,   18,
- /*    70 */    17,   55,   16,   54,   52,   65,   82,   81,   80,   30,
- /*    80 */    29,   27,   26,   25,   24,   23,   22,   21,   58,   88,
- /*    90 */    59,   77,   11,   57,   90,   31,   56,   87,   28,   19,
- /*   100 */    18,   17,    4,   16,   54,   25,   24,   23,   82,   81,
- /*   110 */    80,   12,   57,   75,   58,   62,   59,   89,   19,   18,
- /*   120 */    17,   94,   16,   54,   57,   74,  148,    6,   64,   63,
- /*   130 */    19,   18,   17,   99,   16,   54,   57,   70,   93,   92,
- /*   140 */    91,   95,   19,   18,   17,   61,   16,   54,   57,   71,
- /*   150 */    79,   20,   68,   34,   19,   18,   17,   57,   16,   54,
- /*   160 */    62,    3,   33,   19,   18,   17,   94,   15,   54,   57,
- /*   170 */    13,   32,  149,   98,   63,   19,   18,   17,   57,   16,
- /*   180 */    54,   60,   67,   45,   19,   18,   17,   32,   14,   54,
- /*   190 */    69,   46,   58,  149,   59,   77,    7,   58,   95,   59,
- /*   200 */    77,    8,   61,  149,   66,   47,   40,   51,   50,   85,
- /*   210 */    84,   83,   49,   48,   43,   42,   41,   39,   38,  149,
- /*   220 */    37,   36,
+ /*     0 */    37,   38,  158,   47,   45,   43,   41,   40,   39,   30,
+ /*    10 */    29,   31,   28,   27,   36,   35,   34,   33,   32,  157,
+ /*    20 */    14,    2,   30,   29,   31,   28,   27,   36,   35,   34,
+ /*    30 */    33,   32,  125,   14,   37,   38,   55,   47,   45,   43,
+ /*    40 */    41,   40,   39,   30,   29,   31,   28,   27,   36,   35,
+ /*    50 */    34,   33,   32,   54,   14,    2,    6,   29,   31,   28,
+ /*    60 */    27,   36,   35,   34,   33,   32,  124,   14,   37,   38,
+ /*    70 */   147,   47,   45,   43,   41,   40,   39,   30,   29,   31,
+ /*    80 */    28,   27,   36,   35,   34,   33,   32,   50,   14,  121,
+ /*    90 */    34,   33,   32,  145,   14,   37,   38,  146,   47,   45,
+ /*   100 */    43,   41,   40,   39,   30,   29,   31,   28,   27,   36,
+ /*   110 */    35,   34,   33,   32,  106,   14,  107,  129,   11,   48,
+ /*   120 */   144,    7,   37,   38,   44,   47,   45,   43,   41,   40,
+ /*   130 */    39,   30,   29,   31,   28,   27,   36,   35,   34,   33,
+ /*   140 */    32,   14,   14,   95,   37,   38,    5,   47,   45,   43,
+ /*   150 */    41,   40,   39,   30,   29,   31,   28,   27,   36,   35,
+ /*   160 */    34,   33,   32,    4,   14,   52,   37,   38,  141,   47,
+ /*   170 */    45,   43,   41,   40,   39,   30,   29,   31,   28,   27,
+ /*   180 */    36,   35,   34,   33,   32,   71,   14,  153,  152,  151,
+ /*   190 */   150,   13,  115,   37,   38,  103,   47,   45,   43,   41,
+ /*   200 */    40,   39,   30,   29,   31,   28,   27,   36,   35,   34,
+ /*   210 */    33,   32,   90,   14,  134,   37,   38,  154,   47,   45,
+ /*   220 */    43,   41,   40,   39,   30,   29,   31,   28,   27,   36,
+ /*   230 */    35,   34,   33,   32,  109,   14,    3,   51,  143,  142,
+ /*   240 */    42,  132,   49,   37,   38,  119,   47,   45,   43,   41,
+ /*   250 */    40,   39,   30,   29,   31,   28,   27,   36,   35,   34,
+ /*   260 */    33,   32,   50,   14,    2,   37,   38,   91,   47,   45,
+ /*   270 */    43,   41,   40,   39,   30,   29,   31,   28,   27,   36,
+ /*   280 */    35,   34,   33,   32,   38,   14,   47,   45,   43,   41,
+ /*   290 */    40,   39,   30,   29,   31,   28,   27,   36,   35,   34,
+ /*   300 */    33,   32,  114,   14,   47,   45,   43,   41,   40,   39,
+ /*   310 */    30,   29,   31,   28,   27,   36,   35,   34,   33,   32,
+ /*   320 */    23,   14,   31,   28,   27,   36,   35,   34,   33,   32,
+ /*   330 */   108,   14,   26,   25,   70,  136,   22,   24,   93,  118,
+ /*   340 */   105,  104,   46,  240,  103,  153,  152,  151,  150,  128,
+ /*   350 */   240,   20,   19,  131,  130,   18,   98,   17,   97,  106,
+ /*   360 */    56,  107,  129,   10,   23,   21,  111,  140,  139,  138,
+ /*   370 */   137,  240,  106,  155,  107,  148,   26,   25,  110,  120,
+ /*   380 */    53,   24,  159,  112,  160,  104,   46,   92,  117,  153,
+ /*   390 */   152,  151,  150,  116,   94,   28,   27,   36,   35,   34,
+ /*   400 */    33,   32,  240,   14,   56,   75,  156,   96,   23,  240,
+ /*   410 */   133,  140,  139,  138,  137,  103,  109,   66,  156,   96,
+ /*   420 */    26,   25,  240,  240,  240,   24,  105,  103,  109,  104,
+ /*   430 */    46,  135,   76,  153,  152,  151,  150,   20,   19,  131,
+ /*   440 */   130,   18,  103,   16,   97,  240,  240,  106,   56,  107,
+ /*   450 */   129,   12,   23,   65,  240,  140,  139,  138,  137,  240,
+ /*   460 */   240,  240,  240,  103,   26,   25,   77,  240,  106,   24,
+ /*   470 */   107,  129,    8,  104,   46,   64,  103,  153,  152,  151,
+ /*   480 */   150,  111,  240,  240,  240,  103,  240,  240,  155,  240,
+ /*   490 */   240,  240,   56,  110,  105,  239,    1,  113,  112,  140,
+ /*   500 */   139,  138,  137,  149,  105,   20,   19,  131,  130,   18,
+ /*   510 */   240,   17,   97,  127,  240,   20,   19,  131,  130,   18,
+ /*   520 */    80,   17,   97,  106,  105,  107,  129,    9,  240,  240,
+ /*   530 */   103,  240,  240,  126,  105,   20,   19,  131,  130,   18,
+ /*   540 */   240,   17,   97,  122,  105,   20,   19,  131,  130,   18,
+ /*   550 */   240,   17,   97,  123,  240,   20,   19,  131,  130,   18,
+ /*   560 */   105,   17,   97,   36,   35,   34,   33,   32,  105,   14,
+ /*   570 */   240,   20,   19,  131,  130,   18,  240,   17,   97,   20,
+ /*   580 */    19,  131,  130,   18,  240,   15,   97,  240,  240,   79,
+ /*   590 */    78,  240,   74,   72,   89,   88,  240,  102,  101,  103,
+ /*   600 */   103,  100,  103,  103,  103,  103,  240,  103,  103,   83,
+ /*   610 */   240,  103,   81,   82,   85,   84,   87,   86,   99,  103,
+ /*   620 */    73,   69,  103,  103,  103,  103,  103,  103,  103,   61,
+ /*   630 */   103,  103,  240,   68,   67,   60,   59,   58,   57,  103,
+ /*   640 */   240,   63,   62,  103,  103,  103,  103,  103,  103,  240,
+ /*   650 */   240,  103,  103,
 };
 static const YYCODETYPE yy_lookahead[] = {
- /*     0 */     1,    2,    3,    4,    5,    6,    7,    8,    3,    4,
- /*    10 */     5,    6,    7,   14,    8,    1,    2,    3,    4,    5,
- /*    20 */     6,    7,    8,   28,    8,   30,   31,   32,   14,    8,
- /*    30 */     1,    2,    3,    4,    5,    6,    7,    1,    2,    3,
- /*    40 */     4,    5,    6,    7,    8,   16,    1,    2,    3,    4,
- /*    50 */     5,    6,    7,    8,    3,    4,   28,   13,   30,   31,
- /*    60 */    32,   29,   13,   14,   13,   33,   15,   16,   19,   20,
- /*    70 */    21,   22,   23,   24,   36,   37,   25,   26,   27,    1,
- /*    80 */     2,    3,    4,    5,    6,    7,    3,    4,   28,    8,
- /*    90 */    30,   31,   32,   13,   14,   18,   13,    8,   15,   19,
- /*   100 */    20,   21,    8,   23,   24,    5,    6,    7,   25,   26,
- /*   110 */    27,   15,   13,   14,   28,   28,   30,   31,   19,   20,
- /*   120 */    21,   34,   23,   24,   13,   14,   39,   40,   41,   42,
- /*   130 */    19,   20,   21,    0,   23,   24,   13,   14,    9,   10,
- /*   140 */    11,    8,   19,   20,   21,   12,   23,   24,   13,   14,
- /*   150 */    16,   17,   16,   17,   19,   20,   21,   13,   23,   24,
- /*   160 */    28,    8,   35,   19,   20,   21,   34,   23,   24,   13,
- /*   170 */    15,   13,   43,   41,   42,   19,   20,   21,   13,   23,
- /*   180 */    24,   38,   37,   29,   19,   20,   21,   13,   23,   24,
- /*   190 */    16,   29,   28,   43,   30,   31,   32,   28,    8,   30,
- /*   200 */    31,   32,   12,   43,   38,   29,   29,   29,   29,   29,
- /*   210 */    29,   29,   29,   29,   29,   29,   29,   29,   29,   43,
- /*   220 */    29,   29,
+ /*     0 */     1,    2,   22,    4,    5,    6,    7,    8,    9,   10,
+ /*    10 */    11,   12,   13,   14,   15,   16,   17,   18,   19,   22,
+ /*    20 */    21,   22,   10,   11,   12,   13,   14,   15,   16,   17,
+ /*    30 */    18,   19,   33,   21,    1,    2,   22,    4,    5,    6,
+ /*    40 */     7,    8,    9,   10,   11,   12,   13,   14,   15,   16,
+ /*    50 */    17,   18,   19,   24,   21,   22,   22,   11,   12,   13,
+ /*    60 */    14,   15,   16,   17,   18,   19,   33,   21,    1,    2,
+ /*    70 */    22,    4,    5,    6,    7,    8,    9,   10,   11,   12,
+ /*    80 */    13,   14,   15,   16,   17,   18,   19,   24,   21,   26,
+ /*    90 */    17,   18,   19,   26,   21,    1,    2,   22,    4,    5,
+ /*   100 */     6,    7,    8,    9,   10,   11,   12,   13,   14,   15,
+ /*   110 */    16,   17,   18,   19,   54,   21,   56,   57,   58,   34,
+ /*   120 */    26,   25,    1,    2,   25,    4,    5,    6,    7,    8,
+ /*   130 */     9,   10,   11,   12,   13,   14,   15,   16,   17,   18,
+ /*   140 */    19,   21,   21,   24,    1,    2,   22,    4,    5,    6,
+ /*   150 */     7,    8,    9,   10,   11,   12,   13,   14,   15,   16,
+ /*   160 */    17,   18,   19,   22,   21,   25,    1,    2,   47,    4,
+ /*   170 */     5,    6,    7,    8,    9,   10,   11,   12,   13,   14,
+ /*   180 */    15,   16,   17,   18,   19,   55,   21,   28,   29,   30,
+ /*   190 */    31,   48,   24,    1,    2,   65,    4,    5,    6,    7,
+ /*   200 */     8,    9,   10,   11,   12,   13,   14,   15,   16,   17,
+ /*   210 */    18,   19,   60,   21,   49,    1,    2,   61,    4,    5,
+ /*   220 */     6,    7,    8,    9,   10,   11,   12,   13,   14,   15,
+ /*   230 */    16,   17,   18,   19,   32,   21,   22,   62,   44,   45,
+ /*   240 */    46,   49,   25,    1,    2,   64,    4,    5,    6,    7,
+ /*   250 */     8,    9,   10,   11,   12,   13,   14,   15,   16,   17,
+ /*   260 */    18,   19,   24,   21,   22,    1,    2,   67,    4,    5,
+ /*   270 */     6,    7,    8,    9,   10,   11,   12,   13,   14,   15,
+ /*   280 */    16,   17,   18,   19,    2,   21,    4,    5,    6,    7,
+ /*   290 */     8,    9,   10,   11,   12,   13,   14,   15,   16,   17,
+ /*   300 */    18,   19,   24,   21,    4,    5,    6,    7,    8,    9,
+ /*   310 */    10,   11,   12,   13,   14,   15,   16,   17,   18,   19,
+ /*   320 */     3,   21,   12,   13,   14,   15,   16,   17,   18,   19,
+ /*   330 */    65,   21,   15,   16,   55,   26,   27,   20,   59,   65,
+ /*   340 */    24,   24,   25,   72,   65,   28,   29,   30,   31,   33,
+ /*   350 */    72,   35,   36,   37,   38,   39,   40,   41,   42,   54,
+ /*   360 */    43,   56,   57,   58,    3,   48,   54,   50,   51,   52,
+ /*   370 */    53,   72,   54,   61,   56,   57,   15,   16,   66,   26,
+ /*   380 */    27,   20,   70,   71,    0,   24,   25,   63,   64,   28,
+ /*   390 */    29,   30,   31,   26,   27,   13,   14,   15,   16,   17,
+ /*   400 */    18,   19,   72,   21,   43,   55,   22,   23,    3,   72,
+ /*   410 */    49,   50,   51,   52,   53,   65,   32,   55,   22,   23,
+ /*   420 */    15,   16,   72,   72,   72,   20,   24,   65,   32,   24,
+ /*   430 */    25,   26,   55,   28,   29,   30,   31,   35,   36,   37,
+ /*   440 */    38,   39,   65,   41,   42,   72,   72,   54,   43,   56,
+ /*   450 */    57,   58,    3,   55,   72,   50,   51,   52,   53,   72,
+ /*   460 */    72,   72,   72,   65,   15,   16,   55,   72,   54,   20,
+ /*   470 */    56,   57,   58,   24,   25,   55,   65,   28,   29,   30,
+ /*   480 */    31,   54,   72,   72,   72,   65,   72,   72,   61,   72,
+ /*   490 */    72,   72,   43,   66,   24,   68,   69,   70,   71,   50,
+ /*   500 */    51,   52,   53,   33,   24,   35,   36,   37,   38,   39,
+ /*   510 */    72,   41,   42,   33,   72,   35,   36,   37,   38,   39,
+ /*   520 */    55,   41,   42,   54,   24,   56,   57,   58,   72,   72,
+ /*   530 */    65,   72,   72,   33,   24,   35,   36,   37,   38,   39,
+ /*   540 */    72,   41,   42,   33,   24,   35,   36,   37,   38,   39,
+ /*   550 */    72,   41,   42,   33,   72,   35,   36,   37,   38,   39,
+ /*   560 */    24,   41,   42,   15,   16,   17,   18,   19,   24,   21,
+ /*   570 */    72,   35,   36,   37,   38,   39,   72,   41,   42,   35,
+ /*   580 */    36,   37,   38,   39,   72,   41,   42,   72,   72,   55,
+ /*   590 */    55,   72,   55,   55,   55,   55,   72,   55,   55,   65,
+ /*   600 */    65,   55,   65,   65,   65,   65,   72,   65,   65,   55,
+ /*   610 */    72,   65,   55,   55,   55,   55,   55,   55,   55,   65,
+ /*   620 */    55,   55,   65,   65,   65,   65,   65,   65,   65,   55,
+ /*   630 */    65,   65,   72,   55,   55,   55,   55,   55,   55,   65,
+ /*   640 */    72,   55,   55,   65,   65,   65,   65,   65,   65,   72,
+ /*   650 */    72,   65,   65,
 };
-#define YY_SHIFT_USE_DFLT (-2)
-#define YY_SHIFT_COUNT (63)
-#define YY_SHIFT_MIN   (-1)
-#define YY_SHIFT_MAX   (190)
+#define YY_SHIFT_USE_DFLT (-21)
+#define YY_SHIFT_COUNT (112)
+#define YY_SHIFT_MIN   (-20)
+#define YY_SHIFT_MAX   (548)
 static const short yy_shift_ofst[] = {
- /*     0 */   190,  135,  123,  165,  156,  156,  133,   49,  111,   99,
- /*    10 */    80,  144,   51,  174,   83,   83,   83,   83,   83,   83,
- /*    20 */    83,   83,   83,   83,   83,   83,   83,   83,   83,   83,
- /*    30 */    83,   83,  129,  129,  158,  155,   14,   -1,   45,   36,
- /*    40 */    29,   78,   78,   78,   78,   78,    5,    5,  100,  100,
- /*    50 */   100,  100,  136,  134,  153,   94,   96,   77,   89,   81,
- /*    60 */    21,   44,   16,    6,
+ /*     0 */   396,  384,  520,  510,  544,  536,  536,  405,  316,  500,
+ /*    10 */   480,  470,  402,  361,  317,  449,  449,  449,  449,  449,
+ /*    20 */   449,  449,  449,  449,  449,  449,  449,  449,  449,  449,
+ /*    30 */   449,  449,  449,  449,  449,  449,  449,  449,  449,  449,
+ /*    40 */   449,  449,  449,  449,  449,  449,  449,  449,  449,   63,
+ /*    50 */   159,  159,  278,  238,  217,  202,  -21,   33,   -1,  242,
+ /*    60 */   214,  192,  165,  143,  121,   94,   67,  264,  264,  264,
+ /*    70 */   264,  264,  282,  300,  300,   12,   12,   12,   12,   12,
+ /*    80 */    12,   46,  310,  382,  548,  548,   73,   73,   73,   73,
+ /*    90 */   194,  367,  353,  309,  168,  140,  119,  141,  124,  120,
+ /*   100 */   120,  120,  120,   99,   96,   85,   75,   48,   34,   29,
+ /*   110 */    14,   -3,  -20,
 };
-#define YY_REDUCE_USE_DFLT (-6)
-#define YY_REDUCE_COUNT (35)
-#define YY_REDUCE_MIN   (-5)
-#define YY_REDUCE_MAX   (192)
+#define YY_REDUCE_USE_DFLT (-1)
+#define YY_REDUCE_COUNT (56)
+#define YY_REDUCE_MIN   (0)
+#define YY_REDUCE_MAX   (587)
 static const short yy_reduce_ofst[] = {
- /*     0 */    87,  169,  164,   60,   28,   -5,  132,   86,   86,   86,
- /*    10 */    86,   86,   32,   38,  192,  191,  189,  188,  187,  186,
- /*    20 */   185,  184,  183,  182,  181,  180,  179,  178,  177,  176,
- /*    30 */   162,  154,  166,  143,  145,  127,
+ /*     0 */   427,  312,  469,  414,  393,  305,   60,  279,  318,  318,
+ /*    10 */   318,  318,  318,  587,  586,  583,  582,  581,  580,  579,
+ /*    20 */   578,  574,  566,  565,  563,  562,  561,  560,  559,  558,
+ /*    30 */   557,  554,  546,  543,  542,  540,  539,  538,  537,  535,
+ /*    40 */   534,  465,  420,  411,  398,  377,  362,  350,  130,  324,
+ /*    50 */   274,  265,  200,  181,  175,  156,  152,
 };
 static const YYACTIONTYPE yy_default[] = {
- /*     0 */   147,  147,  147,  147,  147,  147,  147,  147,  147,  147,
- /*    10 */   147,  147,  147,  147,  147,  147,  147,  147,  147,  147,
- /*    20 */   147,  147,  147,  147,  147,  147,  147,  147,  147,  147,
- /*    30 */   147,  147,  147,  147,  147,  147,  147,  147,  147,  147,
- /*    40 */   147,  121,  120,  130,  129,  119,  134,  135,  142,  141,
- /*    50 */   137,  136,  147,  147,  147,  147,  146,  147,  147,  147,
- /*    60 */   147,  147,  147,  147,  100,  112,  114,  113,  111,  110,
- /*    70 */   122,  125,  127,  128,  126,  124,  123,  115,  131,  132,
- /*    80 */   145,  144,  143,  140,  139,  138,  133,  118,  117,  116,
- /*    90 */   109,  108,  107,  106,  105,  104,  103,  102,  101,
+ /*     0 */   238,  238,  238,  238,  238,  238,  238,  238,  238,  238,
+ /*    10 */   238,  238,  238,  238,  238,  238,  238,  238,  238,  238,
+ /*    20 */   238,  238,  238,  238,  238,  238,  238,  238,  238,  238,
+ /*    30 */   238,  238,  238,  238,  238,  238,  238,  238,  238,  238,
+ /*    40 */   238,  238,  238,  238,  238,  238,  238,  238,  238,  238,
+ /*    50 */   238,  238,  238,  238,  238,  238,  205,  238,  238,  238,
+ /*    60 */   238,  238,  238,  238,  238,  238,  238,  188,  187,  199,
+ /*    70 */   198,  186,  218,  232,  217,  211,  212,  213,  216,  215,
+ /*    80 */   214,  225,  226,  224,  228,  227,  230,  229,  220,  219,
+ /*    90 */   238,  238,  238,  238,  238,  168,  238,  238,  238,  231,
+ /*   100 */   223,  222,  221,  238,  237,  238,  238,  238,  238,  238,
+ /*   110 */   238,  238,  238,  161,  170,  171,  169,  179,  181,  180,
+ /*   120 */   178,  177,  191,  194,  196,  197,  195,  193,  192,  182,
+ /*   130 */   190,  189,  210,  209,  208,  200,  201,  236,  235,  234,
+ /*   140 */   233,  207,  206,  204,  203,  202,  185,  184,  183,  176,
+ /*   150 */   175,  174,  173,  172,  167,  166,  165,  164,  163,  162,
 };
 
 /* The next table maps tokens into fallback tokens.  If a construct
@@ -336,17 +436,24 @@ void ParseGrammarTrace(FILE *TraceFILE, char *zTracePrompt){
 /* For tracing shifts, the names of all terminals and nonterminals
 ** are required.  The following table supplies these names */
 static const char *const yyTokenName[] = { 
-  "$",             "LESS",          "EQUALS",        "PLUS",        
+  "$",             "OR",            "AND",           "NOT",         
+  "LESS",          "EQUALS",        "NOT_EQUALS",    "GREATER",     
+  "LESS_EQUALS",   "GREATER_EQUALS",  "PIPE",          "CARET",       
+  "AMPERSAND",     "SHL",           "SHR",           "PLUS",        
   "MINUS",         "STAR",          "SLASH",         "PERCENT",     
-  "NEWLINE",       "STRING_TYPE",   "NUMBER_TYPE",   "BOOLEAN_TYPE",
-  "FUNCTION",      "ID",            "END",           "LPAREN",      
-  "RPAREN",        "COMMA",         "ASSIGN",        "PRINT",       
-  "RETURN",        "IF",            "ELSE",          "WHILE",       
-  "DO",            "NUMBER_VALUE",  "STRING_VALUE",  "BOOLEAN_VALUE",
-  "error",         "expression",    "statement",     "statement_line",
-  "statement_list",  "expression_list",  "function_declaration",  "parenthesis_parameter_list",
-  "parameter_list",  "parameter_decl",  "type_reference",  "translation_unit",
-  "toplevel_list",  "toplevel_line",  "toplevel_statement",
+  "TILDE",         "LBRACKET",      "NEWLINE",       "AT",          
+  "ID",            "LPAREN",        "RPAREN",        "COMMA",       
+  "STRING_TYPE",   "NUMBER_TYPE",   "BOOLEAN_TYPE",  "INT_TYPE",    
+  "FUNCTION",      "END",           "ASSIGN",        "PRINT",       
+  "RETURN",        "BREAK",         "CONTINUE",      "IF",          
+  "ELSE",          "WHILE",         "DO",            "FORMAT_BEGIN",
+  "FORMAT_END",    "FORMAT_TEXT",   "LBRACE",        "RBRACE",      
+  "COLON",         "RBRACKET",      "NUMBER_VALUE",  "INTEGER_VALUE",
+  "STRING_VALUE",  "BOOLEAN_VALUE",  "error",         "expression",  
+  "statement",     "statement_line",  "statement_list",  "expression_list",
+  "format_parts",  "function_declaration",  "parenthesis_parameter_list",  "parameter_list",
+  "parameter_decl",  "type_reference",  "decorator",     "fastmath_flag_list",
+  "translation_unit",  "toplevel_list",  "toplevel_line",  "toplevel_statement",
 };
 #endif /* NDEBUG */
 
@@ -361,47 +468,77 @@ static const char *const yyRuleName[] = {
  /*   4 */ "toplevel_line ::= error NEWLINE",
  /*   5 */ "toplevel_line ::= NEWLINE",
  /*   6 */ "toplevel_statement ::= function_declaration",
- /*   7 */ "type_reference ::= STRING_TYPE",
- /*   8 */ "type_reference ::= NUMBER_TYPE",
- /*   9 */ "type_reference ::= BOOLEAN_TYPE",
- /*  10 */ "function_declaration ::= FUNCTION ID parenthesis_parameter_list type_reference NEWLINE statement_list END",
- /*  11 */ "parenthesis_parameter_list ::= LPAREN RPAREN",
- /*  12 */ "parenthesis_parameter_list ::= LPAREN parameter_list RPAREN",
- /*  13 */ "parameter_list ::= parameter_decl",
- /*  14 */ "parameter_list ::= parameter_list COMMA parameter_decl",
- /*  15 */ "parameter_decl ::= ID type_reference",
- /*  16 */ "statement_list ::= statement_line",
- /*  17 */ "statement_list ::= statement_list statement_line",
- /*  18 */ "statement_line ::= statement NEWLINE",
- /*  19 */ "statement_line ::= error NEWLINE",
- /*  20 */ "statement ::= ID ASSIGN expression",
- /*  21 */ "statement ::= PRINT expression",
- /*  22 */ "statement ::= RETURN expression",
- /*  23 */ "statement ::= IF expression NEWLINE END",
- /*  24 */ "statement ::= IF expression NEWLINE statement_list END",
- /*  25 */ "statement ::= IF expression NEWLINE statement_list ELSE NEWLINE statement_list END",
- /*  26 */ "statement ::= WHILE expression NEWLINE END",
- /*  27 */ "statement ::= WHILE expression NEWLINE statement_list END",
- /*  28 */ "statement ::= DO NEWLINE WHILE expression END",
- /*  29 */ "statement ::= DO NEWLINE statement_list WHILE expression END",
- /*  30 */ "expression_list ::= expression",
- /*  31 */ "expression_list ::= expression_list COMMA expression",
- /*  32 */ "expression ::= ID LPAREN RPAREN",
- /*  33 */ "expression ::= ID LPAREN expression_list RPAREN",
- /*  34 */ "expression ::= LPAREN expression RPAREN",
- /*  35 */ "expression ::= expression LESS expression",
- /*  36 */ "expression ::= expression EQUALS expression",
- /*  37 */ "expression ::= expression PLUS expression",
- /*  38 */ "expression ::= expression MINUS expression",
- /*  39 */ "expression ::= expression STAR expression",
- /*  40 */ "expression ::= expression SLASH expression",
- /*  41 */ "expression ::= expression PERCENT expression",
- /*  42 */ "expression ::= PLUS expression",
- /*  43 */ "expression ::= MINUS expression",
- /*  44 */ "expression ::= NUMBER_VALUE",
- /*  45 */ "expression ::= STRING_VALUE",
- /*  46 */ "expression ::= BOOLEAN_VALUE",
- /*  47 */ "expression ::= ID",
+ /*   7 */ "toplevel_statement ::= decorator NEWLINE function_declaration",
+ /*   8 */ "decorator ::= AT ID",
+ /*   9 */ "decorator ::= AT ID LPAREN fastmath_flag_list RPAREN",
+ /*  10 */ "fastmath_flag_list ::= ID",
+ /*  11 */ "fastmath_flag_list ::= fastmath_flag_list COMMA ID",
+ /*  12 */ "type_reference ::= STRING_TYPE",
+ /*  13 */ "type_reference ::= NUMBER_TYPE",
+ /*  14 */ "type_reference ::= BOOLEAN_TYPE",
+ /*  15 */ "type_reference ::= INT_TYPE",
+ /*  16 */ "function_declaration ::= FUNCTION ID parenthesis_parameter_list type_reference NEWLINE statement_list END",
+ /*  17 */ "parenthesis_parameter_list ::= LPAREN RPAREN",
+ /*  18 */ "parenthesis_parameter_list ::= LPAREN parameter_list RPAREN",
+ /*  19 */ "parameter_list ::= parameter_decl",
+ /*  20 */ "parameter_list ::= parameter_list COMMA parameter_decl",
+ /*  21 */ "parameter_decl ::= ID type_reference",
+ /*  22 */ "statement_list ::= statement_line",
+ /*  23 */ "statement_list ::= statement_list statement_line",
+ /*  24 */ "statement_line ::= statement NEWLINE",
+ /*  25 */ "statement_line ::= error NEWLINE",
+ /*  26 */ "statement ::= ID ASSIGN expression",
+ /*  27 */ "statement ::= PRINT expression",
+ /*  28 */ "statement ::= RETURN expression",
+ /*  29 */ "statement ::= BREAK",
+ /*  30 */ "statement ::= CONTINUE",
+ /*  31 */ "statement ::= IF expression NEWLINE END",
+ /*  32 */ "statement ::= IF expression NEWLINE statement_list END",
+ /*  33 */ "statement ::= IF expression NEWLINE statement_list ELSE NEWLINE statement_list END",
+ /*  34 */ "statement ::= WHILE expression NEWLINE END",
+ /*  35 */ "statement ::= WHILE expression NEWLINE statement_list END",
+ /*  36 */ "statement ::= DO NEWLINE WHILE expression END",
+ /*  37 */ "statement ::= DO NEWLINE statement_list WHILE expression END",
+ /*  38 */ "expression_list ::= expression",
+ /*  39 */ "expression_list ::= expression_list COMMA expression",
+ /*  40 */ "expression ::= ID LPAREN RPAREN",
+ /*  41 */ "expression ::= ID LPAREN expression_list RPAREN",
+ /*  42 */ "expression ::= LPAREN expression RPAREN",
+ /*  43 */ "expression ::= type_reference LPAREN expression RPAREN",
+ /*  44 */ "expression ::= FORMAT_BEGIN format_parts FORMAT_END",
+ /*  45 */ "format_parts ::=",
+ /*  46 */ "format_parts ::= format_parts FORMAT_TEXT",
+ /*  47 */ "format_parts ::= format_parts LBRACE expression RBRACE",
+ /*  48 */ "expression ::= expression LBRACKET expression COLON expression RBRACKET",
+ /*  49 */ "expression ::= expression LBRACKET expression COLON RBRACKET",
+ /*  50 */ "expression ::= expression LBRACKET COLON expression RBRACKET",
+ /*  51 */ "expression ::= expression LESS expression",
+ /*  52 */ "expression ::= expression EQUALS expression",
+ /*  53 */ "expression ::= expression NOT_EQUALS expression",
+ /*  54 */ "expression ::= expression GREATER expression",
+ /*  55 */ "expression ::= expression LESS_EQUALS expression",
+ /*  56 */ "expression ::= expression GREATER_EQUALS expression",
+ /*  57 */ "expression ::= expression AND expression",
+ /*  58 */ "expression ::= expression OR expression",
+ /*  59 */ "expression ::= expression PLUS expression",
+ /*  60 */ "expression ::= expression MINUS expression",
+ /*  61 */ "expression ::= expression STAR expression",
+ /*  62 */ "expression ::= expression SLASH expression",
+ /*  63 */ "expression ::= expression PERCENT expression",
+ /*  64 */ "expression ::= expression AMPERSAND expression",
+ /*  65 */ "expression ::= expression PIPE expression",
+ /*  66 */ "expression ::= expression CARET expression",
+ /*  67 */ "expression ::= expression SHL expression",
+ /*  68 */ "expression ::= expression SHR expression",
+ /*  69 */ "expression ::= PLUS expression",
+ /*  70 */ "expression ::= MINUS expression",
+ /*  71 */ "expression ::= TILDE expression",
+ /*  72 */ "expression ::= NOT expression",
+ /*  73 */ "expression ::= NUMBER_VALUE",
+ /*  74 */ "expression ::= INTEGER_VALUE",
+ /*  75 */ "expression ::= STRING_VALUE",
+ /*  76 */ "expression ::= BOOLEAN_VALUE",
+ /*  77 */ "expression ::= ID",
 };
 #endif /* NDEBUG */
 
@@ -481,33 +618,59 @@ static void yy_destructor(
     ** inside the C code.
     */
       /* TERMINAL Destructor */
-    case 1: /* LESS */
-    case 2: /* EQUALS */
-    case 3: /* PLUS */
-    case 4: /* MINUS */
-    case 5: /* STAR */
-    case 6: /* SLASH */
-    case 7: /* PERCENT */
-    case 8: /* NEWLINE */
-    case 9: /* STRING_TYPE */
-    case 10: /* NUMBER_TYPE */
-    case 11: /* BOOLEAN_TYPE */
-    case 12: /* FUNCTION */
-    case 13: /* ID */
-    case 14: /* END */
-    case 15: /* LPAREN */
-    case 16: /* RPAREN */
-    case 17: /* COMMA */
-    case 18: /* ASSIGN */
-    case 19: /* PRINT */
-    case 20: /* RETURN */
-    case 21: /* IF */
-    case 22: /* ELSE */
-    case 23: /* WHILE */
-    case 24: /* DO */
-    case 25: /* NUMBER_VALUE */
-    case 26: /* STRING_VALUE */
-    case 27: /* BOOLEAN_VALUE */
+    case 1: /* OR */
+    case 2: /* AND */
+    case 3: /* NOT */
+    case 4: /* LESS */
+    case 5: /* EQUALS */
+    case 6: /* NOT_EQUALS */
+    case 7: /* GREATER */
+    case 8: /* LESS_EQUALS */
+    case 9: /* GREATER_EQUALS */
+    case 10: /* PIPE */
+    case 11: /* CARET */
+    case 12: /* AMPERSAND */
+    case 13: /* SHL */
+    case 14: /* SHR */
+    case 15: /* PLUS */
+    case 16: /* MINUS */
+    case 17: /* STAR */
+    case 18: /* SLASH */
+    case 19: /* PERCENT */
+    case 20: /* TILDE */
+    case 21: /* LBRACKET */
+    case 22: /* NEWLINE */
+    case 23: /* AT */
+    case 24: /* ID */
+    case 25: /* LPAREN */
+    case 26: /* RPAREN */
+    case 27: /* COMMA */
+    case 28: /* STRING_TYPE */
+    case 29: /* NUMBER_TYPE */
+    case 30: /* BOOLEAN_TYPE */
+    case 31: /* INT_TYPE */
+    case 32: /* FUNCTION */
+    case 33: /* END */
+    case 34: /* ASSIGN */
+    case 35: /* PRINT */
+    case 36: /* RETURN */
+    case 37: /* BREAK */
+    case 38: /* CONTINUE */
+    case 39: /* IF */
+    case 40: /* ELSE */
+    case 41: /* WHILE */
+    case 42: /* DO */
+    case 43: /* FORMAT_BEGIN */
+    case 44: /* FORMAT_END */
+    case 45: /* FORMAT_TEXT */
+    case 46: /* LBRACE */
+    case 47: /* RBRACE */
+    case 48: /* COLON */
+    case 49: /* RBRACKET */
+    case 50: /* NUMBER_VALUE */
+    case 51: /* INTEGER_VALUE */
+    case 52: /* STRING_VALUE */
+    case 53: /* BOOLEAN_VALUE */
 {
 
     (void)yypParser;
@@ -516,41 +679,42 @@ static void yy_destructor(
 
 }
       break;
-    case 29: /* expression */
+    case 55: /* expression */
 {
- Destroy((yypminor->yy65)); 
+ Destroy((yypminor->yy71)); 
 }
       break;
-    case 30: /* statement */
-    case 31: /* statement_line */
+    case 56: /* statement */
+    case 57: /* statement_line */
 {
- Destroy((yypminor->yy16)); 
+ Destroy((yypminor->yy12)); 
 }
       break;
-    case 32: /* statement_list */
+    case 58: /* statement_list */
 {
- Destroy((yypminor->yy2)); 
+ Destroy((yypminor->yy13)); 
 }
       break;
-    case 33: /* expression_list */
+    case 59: /* expression_list */
+    case 60: /* format_parts */
 {
- Destroy((yypminor->yy63)); 
+ Destroy((yypminor->yy23)); 
 }
       break;
-    case 34: /* function_declaration */
+    case 61: /* function_declaration */
 {
- Destroy((yypminor->yy55)); 
+ Destroy((yypminor->yy81)); 
 }
       break;
-    case 35: /* parenthesis_parameter_list */
-    case 36: /* parameter_list */
+    case 62: /* parenthesis_parameter_list */
+    case 63: /* parameter_list */
 {
- Destroy((yypminor->yy10)); 
+ Destroy((yypminor->yy112)); 
 }
       break;
-    case 37: /* parameter_decl */
+    case 64: /* parameter_decl */
 {
- Destroy((yypminor->yy6)); 
+ Destroy((yypminor->yy16)); 
 }
       break;
     default:  break;   /* If no destructor action specified: do nothing */
@@ -791,54 +955,84 @@ static const struct {
   YYCODETYPE lhs;         /* Symbol on the left-hand side of the rule */
   unsigned char nrhs;     /* Number of right-hand side symbols in the rule */
 } yyRuleInfo[] = {
-  { 39, 1 },
-  { 40, 1 },
-  { 40, 2 },
-  { 41, 2 },
-  { 41, 2 },
-  { 41, 1 },
-  { 42, 1 },
-  { 38, 1 },
-  { 38, 1 },
-  { 38, 1 },
-  { 34, 7 },
-  { 35, 2 },
-  { 35, 3 },
-  { 36, 1 },
-  { 36, 3 },
-  { 37, 2 },
-  { 32, 1 },
-  { 32, 2 },
-  { 31, 2 },
-  { 31, 2 },
-  { 30, 3 },
-  { 30, 2 },
-  { 30, 2 },
-  { 30, 4 },
-  { 30, 5 },
-  { 30, 8 },
-  { 30, 4 },
-  { 30, 5 },
-  { 30, 5 },
-  { 30, 6 },
-  { 33, 1 },
-  { 33, 3 },
-  { 29, 3 },
-  { 29, 4 },
-  { 29, 3 },
-  { 29, 3 },
-  { 29, 3 },
-  { 29, 3 },
-  { 29, 3 },
-  { 29, 3 },
-  { 29, 3 },
-  { 29, 3 },
-  { 29, 2 },
-  { 29, 2 },
-  { 29, 1 },
-  { 29, 1 },
-  { 29, 1 },
-  { 29, 1 },
+  { 68, 1 },
+  { 69, 1 },
+  { 69, 2 },
+  { 70, 2 },
+  { 70, 2 },
+  { 70, 1 },
+  { 71, 1 },
+  { 71, 3 },
+  { 66, 2 },
+  { 66, 5 },
+  { 67, 1 },
+  { 67, 3 },
+  { 65, 1 },
+  { 65, 1 },
+  { 65, 1 },
+  { 65, 1 },
+  { 61, 7 },
+  { 62, 2 },
+  { 62, 3 },
+  { 63, 1 },
+  { 63, 3 },
+  { 64, 2 },
+  { 58, 1 },
+  { 58, 2 },
+  { 57, 2 },
+  { 57, 2 },
+  { 56, 3 },
+  { 56, 2 },
+  { 56, 2 },
+  { 56, 1 },
+  { 56, 1 },
+  { 56, 4 },
+  { 56, 5 },
+  { 56, 8 },
+  { 56, 4 },
+  { 56, 5 },
+  { 56, 5 },
+  { 56, 6 },
+  { 59, 1 },
+  { 59, 3 },
+  { 55, 3 },
+  { 55, 4 },
+  { 55, 3 },
+  { 55, 4 },
+  { 55, 3 },
+  { 60, 0 },
+  { 60, 2 },
+  { 60, 4 },
+  { 55, 6 },
+  { 55, 5 },
+  { 55, 5 },
+  { 55, 3 },
+  { 55, 3 },
+  { 55, 3 },
+  { 55, 3 },
+  { 55, 3 },
+  { 55, 3 },
+  { 55, 3 },
+  { 55, 3 },
+  { 55, 3 },
+  { 55, 3 },
+  { 55, 3 },
+  { 55, 3 },
+  { 55, 3 },
+  { 55, 3 },
+  { 55, 3 },
+  { 55, 3 },
+  { 55, 3 },
+  { 55, 3 },
+  { 55, 2 },
+  { 55, 2 },
+  { 55, 2 },
+  { 55, 2 },
+  { 55, 1 },
+  { 55, 1 },
+  { 55, 1 },
+  { 55, 1 },
+  { 55, 1 },
 };
 
 static void yy_accept(yyParser*);  /* Forward Declaration */
@@ -897,283 +1091,480 @@ static void yy_reduce(
       case 4: /* toplevel_line ::= error NEWLINE */ yytestcase(yyruleno==4);
       case 5: /* toplevel_line ::= NEWLINE */ yytestcase(yyruleno==5);
 {
-  yy_destructor(yypParser,8,&yymsp[0].minor);
+  yy_destructor(yypParser,22,&yymsp[0].minor);
 }
         break;
       case 6: /* toplevel_statement ::= function_declaration */
 {
-    pParse->AddFunction(Take(yymsp[0].minor.yy55));
+    pParse->AddFunction(Take(yymsp[0].minor.yy81));
 }
         break;
-      case 7: /* type_reference ::= STRING_TYPE */
+      case 7: /* toplevel_statement ::= decorator NEWLINE function_declaration */
 {
-    yygotominor.yy64 = static_cast<int>(ExpressionType::String);
-  yy_destructor(yypParser,9,&yymsp[0].minor);
+    auto pFunction = Take(yymsp[0].minor.yy81);
+    if (pFunction)
+    {
+        pFunction->SetFastMathFlags(yymsp[-2].minor.yy46);
+    }
+    pParse->AddFunction(std::move(pFunction));
+  yy_destructor(yypParser,22,&yymsp[-1].minor);
 }
         break;
-      case 8: /* type_reference ::= NUMBER_TYPE */
+      case 8: /* decorator ::= AT ID */
 {
-    yygotominor.yy64 = static_cast<int>(ExpressionType::Number);
-  yy_destructor(yypParser,10,&yymsp[0].minor);
+    yygotominor.yy46 = pParse->GetDecoratorFlags(yymsp[0].minor.yy0, FastMath::All);
+  yy_destructor(yypParser,23,&yymsp[-1].minor);
 }
         break;
-      case 9: /* type_reference ::= BOOLEAN_TYPE */
+      case 9: /* decorator ::= AT ID LPAREN fastmath_flag_list RPAREN */
 {
-    yygotominor.yy64 = static_cast<int>(ExpressionType::Boolean);
-  yy_destructor(yypParser,11,&yymsp[0].minor);
+    yygotominor.yy46 = pParse->GetDecoratorFlags(yymsp[-3].minor.yy0, yymsp[-1].minor.yy46);
+  yy_destructor(yypParser,23,&yymsp[-4].minor);
+  yy_destructor(yypParser,25,&yymsp[-2].minor);
+  yy_destructor(yypParser,26,&yymsp[0].minor);
 }
         break;
-      case 10: /* function_declaration ::= FUNCTION ID parenthesis_parameter_list type_reference NEWLINE statement_list END */
+      case 10: /* fastmath_flag_list ::= ID */
 {
-    auto pParameters = Take(yymsp[-4].minor.yy10);
-    auto pBody = Take(yymsp[-1].minor.yy2);
-    ExpressionType returnType = static_cast<ExpressionType>(yymsp[-3].minor.yy64);
-    EmplaceAST<CFunctionAST>(yygotominor.yy55, yymsp[-5].minor.yy0.stringId, returnType, std::move(*pParameters), std::move(*pBody));
-  yy_destructor(yypParser,12,&yymsp[-6].minor);
-  yy_destructor(yypParser,8,&yymsp[-2].minor);
-  yy_destructor(yypParser,14,&yymsp[0].minor);
+    yygotominor.yy46 = pParse->GetFastMathFlag(yymsp[0].minor.yy0);
 }
         break;
-      case 11: /* parenthesis_parameter_list ::= LPAREN RPAREN */
+      case 11: /* fastmath_flag_list ::= fastmath_flag_list COMMA ID */
 {
-    yygotominor.yy10 = Make<ParameterDeclList>().release();
-  yy_destructor(yypParser,15,&yymsp[-1].minor);
-  yy_destructor(yypParser,16,&yymsp[0].minor);
+    yygotominor.yy46 = yymsp[-2].minor.yy46 | pParse->GetFastMathFlag(yymsp[0].minor.yy0);
+  yy_destructor(yypParser,27,&yymsp[-1].minor);
 }
         break;
-      case 12: /* parenthesis_parameter_list ::= LPAREN parameter_list RPAREN */
+      case 12: /* type_reference ::= STRING_TYPE */
 {
-    MovePointer(yymsp[-1].minor.yy10, yygotominor.yy10);
-  yy_destructor(yypParser,15,&yymsp[-2].minor);
-  yy_destructor(yypParser,16,&yymsp[0].minor);
+    yygotominor.yy76 = static_cast<int>(ExpressionType::String);
+  yy_destructor(yypParser,28,&yymsp[0].minor);
 }
         break;
-      case 13: /* parameter_list ::= parameter_decl */
+      case 13: /* type_reference ::= NUMBER_TYPE */
 {
-    CreateList(yygotominor.yy10, yymsp[0].minor.yy6);
+    yygotominor.yy76 = static_cast<int>(ExpressionType::Number);
+  yy_destructor(yypParser,29,&yymsp[0].minor);
 }
         break;
-      case 14: /* parameter_list ::= parameter_list COMMA parameter_decl */
+      case 14: /* type_reference ::= BOOLEAN_TYPE */
 {
-    ConcatList(yygotominor.yy10, yymsp[-2].minor.yy10, yymsp[0].minor.yy6);
-  yy_destructor(yypParser,17,&yymsp[-1].minor);
+    yygotominor.yy76 = static_cast<int>(ExpressionType::Boolean);
+  yy_destructor(yypParser,30,&yymsp[0].minor);
 }
         break;
-      case 15: /* parameter_decl ::= ID type_reference */
+      case 15: /* type_reference ::= INT_TYPE */
 {
-    EmplaceAST<CParameterDeclAST>(yygotominor.yy6, yymsp[-1].minor.yy0.stringId, static_cast<ExpressionType>(yymsp[0].minor.yy64));
+    yygotominor.yy76 = static_cast<int>(ExpressionType::Int);
+  yy_destructor(yypParser,31,&yymsp[0].minor);
 }
         break;
-      case 16: /* statement_list ::= statement_line */
+      case 16: /* function_declaration ::= FUNCTION ID parenthesis_parameter_list type_reference NEWLINE statement_list END */
 {
-    CreateList(yygotominor.yy2, yymsp[0].minor.yy16);
+    auto pParameters = Take(yymsp[-4].minor.yy112);
+    auto pBody = Take(yymsp[-1].minor.yy13);
+    ExpressionType returnType = static_cast<ExpressionType>(yymsp[-3].minor.yy76);
+    EmplaceAST<CFunctionAST>(yygotominor.yy81, yymsp[-5].minor.yy0.stringId, returnType, std::move(*pParameters), std::move(*pBody));
+  yy_destructor(yypParser,32,&yymsp[-6].minor);
+  yy_destructor(yypParser,22,&yymsp[-2].minor);
+  yy_destructor(yypParser,33,&yymsp[0].minor);
 }
         break;
-      case 17: /* statement_list ::= statement_list statement_line */
+      case 17: /* parenthesis_parameter_list ::= LPAREN RPAREN */
 {
-    ConcatList(yygotominor.yy2, yymsp[-1].minor.yy2, yymsp[0].minor.yy16);
+    yygotominor.yy112 = Make<ParameterDeclList>().release();
+  yy_destructor(yypParser,25,&yymsp[-1].minor);
+  yy_destructor(yypParser,26,&yymsp[0].minor);
 }
         break;
-      case 18: /* statement_line ::= statement NEWLINE */
+      case 18: /* parenthesis_parameter_list ::= LPAREN parameter_list RPAREN */
 {
-    MovePointer(yymsp[-1].minor.yy16, yygotominor.yy16);
-  yy_destructor(yypParser,8,&yymsp[0].minor);
+    MovePointer(yymsp[-1].minor.yy112, yygotominor.yy112);
+  yy_destructor(yypParser,25,&yymsp[-2].minor);
+  yy_destructor(yypParser,26,&yymsp[0].minor);
 }
         break;
-      case 19: /* statement_line ::= error NEWLINE */
+      case 19: /* parameter_list ::= parameter_decl */
 {
-    yygotominor.yy16 = nullptr;
-  yy_destructor(yypParser,8,&yymsp[0].minor);
+    CreateList(yygotominor.yy112, yymsp[0].minor.yy16);
 }
         break;
-      case 20: /* statement ::= ID ASSIGN expression */
+      case 20: /* parameter_list ::= parameter_list COMMA parameter_decl */
 {
-    EmplaceAST<CAssignAST>(yygotominor.yy16, yymsp[-2].minor.yy0.stringId, Take(yymsp[0].minor.yy65));
-  yy_destructor(yypParser,18,&yymsp[-1].minor);
+    ConcatList(yygotominor.yy112, yymsp[-2].minor.yy112, yymsp[0].minor.yy16);
+  yy_destructor(yypParser,27,&yymsp[-1].minor);
 }
         break;
-      case 21: /* statement ::= PRINT expression */
+      case 21: /* parameter_decl ::= ID type_reference */
 {
-    EmplaceAST<CPrintAST>(yygotominor.yy16, Take(yymsp[0].minor.yy65));
-  yy_destructor(yypParser,19,&yymsp[-1].minor);
+    EmplaceAST<CParameterDeclAST>(yygotominor.yy16, yymsp[-1].minor.yy0.stringId, static_cast<ExpressionType>(yymsp[0].minor.yy76));
 }
         break;
-      case 22: /* statement ::= RETURN expression */
+      case 22: /* statement_list ::= statement_line */
 {
-    EmplaceAST<CReturnAST>(yygotominor.yy16, Take(yymsp[0].minor.yy65));
-  yy_destructor(yypParser,20,&yymsp[-1].minor);
+    CreateList(yygotominor.yy13, yymsp[0].minor.yy12);
 }
         break;
-      case 23: /* statement ::= IF expression NEWLINE END */
+      case 23: /* statement_list ::= statement_list statement_line */
 {
-    EmplaceAST<CIfAst>(yygotominor.yy16, Take(yymsp[-2].minor.yy65));
-  yy_destructor(yypParser,21,&yymsp[-3].minor);
-  yy_destructor(yypParser,8,&yymsp[-1].minor);
-  yy_destructor(yypParser,14,&yymsp[0].minor);
+    ConcatList(yygotominor.yy13, yymsp[-1].minor.yy13, yymsp[0].minor.yy12);
 }
         break;
-      case 24: /* statement ::= IF expression NEWLINE statement_list END */
+      case 24: /* statement_line ::= statement NEWLINE */
 {
-    auto pThenBody = Take(yymsp[-1].minor.yy2);
-    EmplaceAST<CIfAst>(yygotominor.yy16, Take(yymsp[-3].minor.yy65), std::move(*pThenBody));
-  yy_destructor(yypParser,21,&yymsp[-4].minor);
-  yy_destructor(yypParser,8,&yymsp[-2].minor);
-  yy_destructor(yypParser,14,&yymsp[0].minor);
+    MovePointer(yymsp[-1].minor.yy12, yygotominor.yy12);
+  yy_destructor(yypParser,22,&yymsp[0].minor);
+}
+        break;
+      case 25: /* statement_line ::= error NEWLINE */
+{
+    yygotominor.yy12 = nullptr;
+  yy_destructor(yypParser,22,&yymsp[0].minor);
+}
+        break;
+      case 26: /* statement ::= ID ASSIGN expression */
+{
+    EmplaceAST<CAssignAST>(yygotominor.yy12, yymsp[-2].minor.yy0.stringId, Take(yymsp[0].minor.yy71));
+  yy_destructor(yypParser,34,&yymsp[-1].minor);
+}
+        break;
+      case 27: /* statement ::= PRINT expression */
+{
+    EmplaceAST<CPrintAST>(yygotominor.yy12, Take(yymsp[0].minor.yy71));
+  yy_destructor(yypParser,35,&yymsp[-1].minor);
+}
+        break;
+      case 28: /* statement ::= RETURN expression */
+{
+    EmplaceAST<CReturnAST>(yygotominor.yy12, Take(yymsp[0].minor.yy71));
+  yy_destructor(yypParser,36,&yymsp[-1].minor);
+}
+        break;
+      case 29: /* statement ::= BREAK */
+{
+    EmplaceAST<CLoopJumpAST>(yygotominor.yy12, LoopJump::Break);
+  yy_destructor(yypParser,37,&yymsp[0].minor);
+}
+        break;
+      case 30: /* statement ::= CONTINUE */
+{
+    EmplaceAST<CLoopJumpAST>(yygotominor.yy12, LoopJump::Continue);
+  yy_destructor(yypParser,38,&yymsp[0].minor);
 }
         break;
-      case 25: /* statement ::= IF expression NEWLINE statement_list ELSE NEWLINE statement_list END */
+      case 31: /* statement ::= IF expression NEWLINE END */
 {
-    auto pThenBody = Take(yymsp[-4].minor.yy2);
-    auto pElseBody = Take(yymsp[-1].minor.yy2);
-    EmplaceAST<CIfAst>(yygotominor.yy16, Take(yymsp[-6].minor.yy65), std::move(*pThenBody), std::move(*pElseBody));
-  yy_destructor(yypParser,21,&yymsp[-7].minor);
-  yy_destructor(yypParser,8,&yymsp[-5].minor);
+    EmplaceAST<CIfAst>(yygotominor.yy12, Take(yymsp[-2].minor.yy71));
+  yy_destructor(yypParser,39,&yymsp[-3].minor);
+  yy_destructor(yypParser,22,&yymsp[-1].minor);
+  yy_destructor(yypParser,33,&yymsp[0].minor);
+}
+        break;
+      case 32: /* statement ::= IF expression NEWLINE statement_list END */
+{
+    auto pThenBody = Take(yymsp[-1].minor.yy13);
+    EmplaceAST<CIfAst>(yygotominor.yy12, Take(yymsp[-3].minor.yy71), std::move(*pThenBody));
+  yy_destructor(yypParser,39,&yymsp[-4].minor);
+  yy_destructor(yypParser,22,&yymsp[-2].minor);
+  yy_destructor(yypParser,33,&yymsp[0].minor);
+}
+        break;
+      case 33: /* statement ::= IF expression NEWLINE statement_list ELSE NEWLINE statement_list END */
+{
+    auto pThenBody = Take(yymsp[-4].minor.yy13);
+    auto pElseBody = Take(yymsp[-1].minor.yy13);
+    EmplaceAST<CIfAst>(yygotominor.yy12, Take(yymsp[-6].minor.yy71), std::move(*pThenBody), std::move(*pElseBody));
+  yy_destructor(yypParser,39,&yymsp[-7].minor);
+  yy_destructor(yypParser,22,&yymsp[-5].minor);
+  yy_destructor(yypParser,40,&yymsp[-3].minor);
+  yy_destructor(yypParser,22,&yymsp[-2].minor);
+  yy_destructor(yypParser,33,&yymsp[0].minor);
+}
+        break;
+      case 34: /* statement ::= WHILE expression NEWLINE END */
+{
+    EmplaceAST<CWhileAst>(yygotominor.yy12, Take(yymsp[-2].minor.yy71));
+  yy_destructor(yypParser,41,&yymsp[-3].minor);
+  yy_destructor(yypParser,22,&yymsp[-1].minor);
+  yy_destructor(yypParser,33,&yymsp[0].minor);
+}
+        break;
+      case 35: /* statement ::= WHILE expression NEWLINE statement_list END */
+{
+    auto pBody = Take(yymsp[-1].minor.yy13);
+    EmplaceAST<CWhileAst>(yygotominor.yy12, Take(yymsp[-3].minor.yy71), std::move(*pBody));
+  yy_destructor(yypParser,41,&yymsp[-4].minor);
+  yy_destructor(yypParser,22,&yymsp[-2].minor);
+  yy_destructor(yypParser,33,&yymsp[0].minor);
+}
+        break;
+      case 36: /* statement ::= DO NEWLINE WHILE expression END */
+{
+    EmplaceAST<CRepeatAst>(yygotominor.yy12, Take(yymsp[-1].minor.yy71));
+  yy_destructor(yypParser,42,&yymsp[-4].minor);
   yy_destructor(yypParser,22,&yymsp[-3].minor);
-  yy_destructor(yypParser,8,&yymsp[-2].minor);
-  yy_destructor(yypParser,14,&yymsp[0].minor);
+  yy_destructor(yypParser,41,&yymsp[-2].minor);
+  yy_destructor(yypParser,33,&yymsp[0].minor);
 }
         break;
-      case 26: /* statement ::= WHILE expression NEWLINE END */
+      case 37: /* statement ::= DO NEWLINE statement_list WHILE expression END */
 {
-    EmplaceAST<CWhileAst>(yygotominor.yy16, Take(yymsp[-2].minor.yy65));
-  yy_destructor(yypParser,23,&yymsp[-3].minor);
-  yy_destructor(yypParser,8,&yymsp[-1].minor);
-  yy_destructor(yypParser,14,&yymsp[0].minor);
+    auto pBody = Take(yymsp[-3].minor.yy13);
+    EmplaceAST<CRepeatAst>(yygotominor.yy12, Take(yymsp[-1].minor.yy71), std::move(*pBody));
+  yy_destructor(yypParser,42,&yymsp[-5].minor);
+  yy_destructor(yypParser,22,&yymsp[-4].minor);
+  yy_destructor(yypParser,41,&yymsp[-2].minor);
+  yy_destructor(yypParser,33,&yymsp[0].minor);
 }
         break;
-      case 27: /* statement ::= WHILE expression NEWLINE statement_list END */
+      case 38: /* expression_list ::= expression */
 {
-    auto pBody = Take(yymsp[-1].minor.yy2);
-    EmplaceAST<CWhileAst>(yygotominor.yy16, Take(yymsp[-3].minor.yy65), std::move(*pBody));
-  yy_destructor(yypParser,23,&yymsp[-4].minor);
-  yy_destructor(yypParser,8,&yymsp[-2].minor);
-  yy_destructor(yypParser,14,&yymsp[0].minor);
+    CreateList(yygotominor.yy23, yymsp[0].minor.yy71);
 }
         break;
-      case 28: /* statement ::= DO NEWLINE WHILE expression END */
+      case 39: /* expression_list ::= expression_list COMMA expression */
 {
-    EmplaceAST<CRepeatAst>(yygotominor.yy16, Take(yymsp[-1].minor.yy65));
-  yy_destructor(yypParser,24,&yymsp[-4].minor);
-  yy_destructor(yypParser,8,&yymsp[-3].minor);
-  yy_destructor(yypParser,23,&yymsp[-2].minor);
-  yy_destructor(yypParser,14,&yymsp[0].minor);
+    ConcatList(yygotominor.yy23, yymsp[-2].minor.yy23, yymsp[0].minor.yy71);
+  yy_destructor(yypParser,27,&yymsp[-1].minor);
 }
         break;
-      case 29: /* statement ::= DO NEWLINE statement_list WHILE expression END */
+      case 40: /* expression ::= ID LPAREN RPAREN */
 {
-    auto pBody = Take(yymsp[-3].minor.yy2);
-    EmplaceAST<CRepeatAst>(yygotominor.yy16, Take(yymsp[-1].minor.yy65), std::move(*pBody));
-  yy_destructor(yypParser,24,&yymsp[-5].minor);
-  yy_destructor(yypParser,8,&yymsp[-4].minor);
-  yy_destructor(yypParser,23,&yymsp[-2].minor);
-  yy_destructor(yypParser,14,&yymsp[0].minor);
+    EmplaceAST<CCallAST>(yygotominor.yy71, yymsp[-2].minor.yy0.stringId, ExpressionList());
+  yy_destructor(yypParser,25,&yymsp[-1].minor);
+  yy_destructor(yypParser,26,&yymsp[0].minor);
 }
         break;
-      case 30: /* expression_list ::= expression */
+      case 41: /* expression ::= ID LPAREN expression_list RPAREN */
 {
-    CreateList(yygotominor.yy63, yymsp[0].minor.yy65);
+    auto pList = Take(yymsp[-1].minor.yy23);
+    EmplaceAST<CCallAST>(yygotominor.yy71, yymsp[-3].minor.yy0.stringId, std::move(*pList));
+  yy_destructor(yypParser,25,&yymsp[-2].minor);
+  yy_destructor(yypParser,26,&yymsp[0].minor);
 }
         break;
-      case 31: /* expression_list ::= expression_list COMMA expression */
+      case 42: /* expression ::= LPAREN expression RPAREN */
 {
-    ConcatList(yygotominor.yy63, yymsp[-2].minor.yy63, yymsp[0].minor.yy65);
-  yy_destructor(yypParser,17,&yymsp[-1].minor);
+    MovePointer(yymsp[-1].minor.yy71, yygotominor.yy71);
+  yy_destructor(yypParser,25,&yymsp[-2].minor);
+  yy_destructor(yypParser,26,&yymsp[0].minor);
 }
         break;
-      case 32: /* expression ::= ID LPAREN RPAREN */
+      case 43: /* expression ::= type_reference LPAREN expression RPAREN */
 {
-    EmplaceAST<CCallAST>(yygotominor.yy65, yymsp[-2].minor.yy0.stringId, ExpressionList());
-  yy_destructor(yypParser,15,&yymsp[-1].minor);
-  yy_destructor(yypParser,16,&yymsp[0].minor);
+    EmplaceAST<CConversionAST>(yygotominor.yy71, static_cast<ExpressionType>(yymsp[-3].minor.yy76), Take(yymsp[-1].minor.yy71));
+  yy_destructor(yypParser,25,&yymsp[-2].minor);
+  yy_destructor(yypParser,26,&yymsp[0].minor);
 }
         break;
-      case 33: /* expression ::= ID LPAREN expression_list RPAREN */
+      case 44: /* expression ::= FORMAT_BEGIN format_parts FORMAT_END */
 {
-    auto pList = Take(yymsp[-1].minor.yy63);
-    EmplaceAST<CCallAST>(yygotominor.yy65, yymsp[-3].minor.yy0.stringId, std::move(*pList));
-  yy_destructor(yypParser,15,&yymsp[-2].minor);
-  yy_destructor(yypParser,16,&yymsp[0].minor);
+    auto pParts = Take(yymsp[-1].minor.yy23);
+    yygotominor.yy71 = pParse->JoinFormatParts(std::move(*pParts)).release();
+  yy_destructor(yypParser,43,&yymsp[-2].minor);
+  yy_destructor(yypParser,44,&yymsp[0].minor);
 }
         break;
-      case 34: /* expression ::= LPAREN expression RPAREN */
+      case 45: /* format_parts ::= */
 {
-    MovePointer(yymsp[-1].minor.yy65, yygotominor.yy65);
-  yy_destructor(yypParser,15,&yymsp[-2].minor);
-  yy_destructor(yypParser,16,&yymsp[0].minor);
+    yygotominor.yy23 = Make<ExpressionList>().release();
 }
         break;
-      case 35: /* expression ::= expression LESS expression */
+      case 46: /* format_parts ::= format_parts FORMAT_TEXT */
 {
-    EmplaceAST<CBinaryExpressionAST>(yygotominor.yy65, Take(yymsp[-2].minor.yy65), BinaryOperation::Less, Take(yymsp[0].minor.yy65));
-  yy_destructor(yypParser,1,&yymsp[-1].minor);
+    ExpressionPtr pText = nullptr;
+    EmplaceAST<CLiteralAST>(pText, pParse->GetStringLiteral(yymsp[0].minor.yy0.stringId));
+    ConcatList(yygotominor.yy23, yymsp[-1].minor.yy23, pText);
 }
         break;
-      case 36: /* expression ::= expression EQUALS expression */
+      case 47: /* format_parts ::= format_parts LBRACE expression RBRACE */
 {
-    EmplaceAST<CBinaryExpressionAST>(yygotominor.yy65, Take(yymsp[-2].minor.yy65), BinaryOperation::Equals, Take(yymsp[0].minor.yy65));
-  yy_destructor(yypParser,2,&yymsp[-1].minor);
+    ExpressionPtr pField = nullptr;
+    EmplaceAST<CConversionAST>(pField, ExpressionType::String, Take(yymsp[-1].minor.yy71));
+    ConcatList(yygotominor.yy23, yymsp[-3].minor.yy23, pField);
+  yy_destructor(yypParser,46,&yymsp[-2].minor);
+  yy_destructor(yypParser,47,&yymsp[0].minor);
 }
         break;
-      case 37: /* expression ::= expression PLUS expression */
+      case 48: /* expression ::= expression LBRACKET expression COLON expression RBRACKET */
 {
-    EmplaceAST<CBinaryExpressionAST>(yygotominor.yy65, Take(yymsp[-2].minor.yy65), BinaryOperation::Add, Take(yymsp[0].minor.yy65));
-  yy_destructor(yypParser,3,&yymsp[-1].minor);
+    EmplaceAST<CSliceAST>(yygotominor.yy71, Take(yymsp[-5].minor.yy71), Take(yymsp[-3].minor.yy71), Take(yymsp[-1].minor.yy71));
+  yy_destructor(yypParser,21,&yymsp[-4].minor);
+  yy_destructor(yypParser,48,&yymsp[-2].minor);
+  yy_destructor(yypParser,49,&yymsp[0].minor);
+}
+        break;
+      case 49: /* expression ::= expression LBRACKET expression COLON RBRACKET */
+{
+    EmplaceAST<CSliceAST>(yygotominor.yy71, Take(yymsp[-4].minor.yy71), Take(yymsp[-2].minor.yy71), nullptr);
+  yy_destructor(yypParser,21,&yymsp[-3].minor);
+  yy_destructor(yypParser,48,&yymsp[-1].minor);
+  yy_destructor(yypParser,49,&yymsp[0].minor);
+}
+        break;
+      case 50: /* expression ::= expression LBRACKET COLON expression RBRACKET */
+{
+    EmplaceAST<CSliceAST>(yygotominor.yy71, Take(yymsp[-4].minor.yy71), nullptr, Take(yymsp[-1].minor.yy71));
+  yy_destructor(yypParser,21,&yymsp[-3].minor);
+  yy_destructor(yypParser,48,&yymsp[-2].minor);
+  yy_destructor(yypParser,49,&yymsp[0].minor);
 }
         break;
-      case 38: /* expression ::= expression MINUS expression */
+      case 51: /* expression ::= expression LESS expression */
 {
-    EmplaceAST<CBinaryExpressionAST>(yygotominor.yy65, Take(yymsp[-2].minor.yy65), BinaryOperation::Substract, Take(yymsp[0].minor.yy65));
+    EmplaceAST<CBinaryExpressionAST>(yygotominor.yy71, Take(yymsp[-2].minor.yy71), BinaryOperation::Less, Take(yymsp[0].minor.yy71));
   yy_destructor(yypParser,4,&yymsp[-1].minor);
 }
         break;
-      case 39: /* expression ::= expression STAR expression */
+      case 52: /* expression ::= expression EQUALS expression */
 {
-    EmplaceAST<CBinaryExpressionAST>(yygotominor.yy65, Take(yymsp[-2].minor.yy65), BinaryOperation::Multiply, Take(yymsp[0].minor.yy65));
+    EmplaceAST<CBinaryExpressionAST>(yygotominor.yy71, Take(yymsp[-2].minor.yy71), BinaryOperation::Equals, Take(yymsp[0].minor.yy71));
   yy_destructor(yypParser,5,&yymsp[-1].minor);
 }
         break;
-      case 40: /* expression ::= expression SLASH expression */
+      case 53: /* expression ::= expression NOT_EQUALS expression */
 {
-    EmplaceAST<CBinaryExpressionAST>(yygotominor.yy65, Take(yymsp[-2].minor.yy65), BinaryOperation::Divide, Take(yymsp[0].minor.yy65));
+    EmplaceAST<CBinaryExpressionAST>(yygotominor.yy71, Take(yymsp[-2].minor.yy71), BinaryOperation::NotEquals, Take(yymsp[0].minor.yy71));
   yy_destructor(yypParser,6,&yymsp[-1].minor);
 }
         break;
-      case 41: /* expression ::= expression PERCENT expression */
+      case 54: /* expression ::= expression GREATER expression */
 {
-    EmplaceAST<CBinaryExpressionAST>(yygotominor.yy65, Take(yymsp[-2].minor.yy65), BinaryOperation::Modulo, Take(yymsp[0].minor.yy65));
+    EmplaceAST<CBinaryExpressionAST>(yygotominor.yy71, Take(yymsp[-2].minor.yy71), BinaryOperation::Greater, Take(yymsp[0].minor.yy71));
   yy_destructor(yypParser,7,&yymsp[-1].minor);
 }
         break;
-      case 42: /* expression ::= PLUS expression */
+      case 55: /* expression ::= expression LESS_EQUALS expression */
 {
-    EmplaceAST<CUnaryExpressionAST>(yygotominor.yy65, UnaryOperation::Plus, Take(yymsp[0].minor.yy65));
+    EmplaceAST<CBinaryExpressionAST>(yygotominor.yy71, Take(yymsp[-2].minor.yy71), BinaryOperation::LessOrEquals, Take(yymsp[0].minor.yy71));
+  yy_destructor(yypParser,8,&yymsp[-1].minor);
+}
+        break;
+      case 56: /* expression ::= expression GREATER_EQUALS expression */
+{
+    EmplaceAST<CBinaryExpressionAST>(yygotominor.yy71, Take(yymsp[-2].minor.yy71), BinaryOperation::GreaterOrEquals, Take(yymsp[0].minor.yy71));
+  yy_destructor(yypParser,9,&yymsp[-1].minor);
+}
+        break;
+      case 57: /* expression ::= expression AND expression */
+{
+    EmplaceAST<CBinaryExpressionAST>(yygotominor.yy71, Take(yymsp[-2].minor.yy71), BinaryOperation::And, Take(yymsp[0].minor.yy71));
+  yy_destructor(yypParser,2,&yymsp[-1].minor);
+}
+        break;
+      case 58: /* expression ::= expression OR expression */
+{
+    EmplaceAST<CBinaryExpressionAST>(yygotominor.yy71, Take(yymsp[-2].minor.yy71), BinaryOperation::Or, Take(yymsp[0].minor.yy71));
+  yy_destructor(yypParser,1,&yymsp[-1].minor);
+}
+        break;
+      case 59: /* expression ::= expression PLUS expression */
+{
+    EmplaceAST<CBinaryExpressionAST>(yygotominor.yy71, Take(yymsp[-2].minor.yy71), BinaryOperation::Add, Take(yymsp[0].minor.yy71));
+  yy_destructor(yypParser,15,&yymsp[-1].minor);
+}
+        break;
+      case 60: /* expression ::= expression MINUS expression */
+{
+    EmplaceAST<CBinaryExpressionAST>(yygotominor.yy71, Take(yymsp[-2].minor.yy71), BinaryOperation::Substract, Take(yymsp[0].minor.yy71));
+  yy_destructor(yypParser,16,&yymsp[-1].minor);
+}
+        break;
+      case 61: /* expression ::= expression STAR expression */
+{
+    EmplaceAST<CBinaryExpressionAST>(yygotominor.yy71, Take(yymsp[-2].minor.yy71), BinaryOperation::Multiply, Take(yymsp[0].minor.yy71));
+  yy_destructor(yypParser,17,&yymsp[-1].minor);
+}
+        break;
+      case 62: /* expression ::= expression SLASH expression */
+{
+    EmplaceAST<CBinaryExpressionAST>(yygotominor.yy71, Take(yymsp[-2].minor.yy71), BinaryOperation::Divide, Take(yymsp[0].minor.yy71));
+  yy_destructor(yypParser,18,&yymsp[-1].minor);
+}
+        break;
+      case 63: /* expression ::= expression PERCENT expression */
+{
+    EmplaceAST<CBinaryExpressionAST>(yygotominor.yy71, Take(yymsp[-2].minor.yy71), BinaryOperation::Modulo, Take(yymsp[0].minor.yy71));
+  yy_destructor(yypParser,19,&yymsp[-1].minor);
+}
+        break;
+      case 64: /* expression ::= expression AMPERSAND expression */
+{
+    EmplaceAST<CBinaryExpressionAST>(yygotominor.yy71, Take(yymsp[-2].minor.yy71), BinaryOperation::BitwiseAnd, Take(yymsp[0].minor.yy71));
+  yy_destructor(yypParser,12,&yymsp[-1].minor);
+}
+        break;
+      case 65: /* expression ::= expression PIPE expression */
+{
+    EmplaceAST<CBinaryExpressionAST>(yygotominor.yy71, Take(yymsp[-2].minor.yy71), BinaryOperation::BitwiseOr, Take(yymsp[0].minor.yy71));
+  yy_destructor(yypParser,10,&yymsp[-1].minor);
+}
+        break;
+      case 66: /* expression ::= expression CARET expression */
+{
+    EmplaceAST<CBinaryExpressionAST>(yygotominor.yy71, Take(yymsp[-2].minor.yy71), BinaryOperation::BitwiseXor, Take(yymsp[0].minor.yy71));
+  yy_destructor(yypParser,11,&yymsp[-1].minor);
+}
+        break;
+      case 67: /* expression ::= expression SHL expression */
+{
+    EmplaceAST<CBinaryExpressionAST>(yygotominor.yy71, Take(yymsp[-2].minor.yy71), BinaryOperation::ShiftLeft, Take(yymsp[0].minor.yy71));
+  yy_destructor(yypParser,13,&yymsp[-1].minor);
+}
+        break;
+      case 68: /* expression ::= expression SHR expression */
+{
+    EmplaceAST<CBinaryExpressionAST>(yygotominor.yy71, Take(yymsp[-2].minor.yy71), BinaryOperation::ShiftRight, Take(yymsp[0].minor.yy71));
+  yy_destructor(yypParser,14,&yymsp[-1].minor);
+}
+        break;
+      case 69: /* expression ::= PLUS expression */
+{
+    EmplaceAST<CUnaryExpressionAST>(yygotominor.yy71, UnaryOperation::Plus, Take(yymsp[0].minor.yy71));
+  yy_destructor(yypParser,15,&yymsp[-1].minor);
+}
+        break;
+      case 70: /* expression ::= MINUS expression */
+{
+    EmplaceAST<CUnaryExpressionAST>(yygotominor.yy71, UnaryOperation::Minus, Take(yymsp[0].minor.yy71));
+  yy_destructor(yypParser,16,&yymsp[-1].minor);
+}
+        break;
+      case 71: /* expression ::= TILDE expression */
+{
+    EmplaceAST<CUnaryExpressionAST>(yygotominor.yy71, UnaryOperation::BitwiseNot, Take(yymsp[0].minor.yy71));
+  yy_destructor(yypParser,20,&yymsp[-1].minor);
+}
+        break;
+      case 72: /* expression ::= NOT expression */
+{
+    EmplaceAST<CUnaryExpressionAST>(yygotominor.yy71, UnaryOperation::LogicalNot, Take(yymsp[0].minor.yy71));
   yy_destructor(yypParser,3,&yymsp[-1].minor);
 }
         break;
-      case 43: /* expression ::= MINUS expression */
+      case 73: /* expression ::= NUMBER_VALUE */
 {
-    EmplaceAST<CUnaryExpressionAST>(yygotominor.yy65, UnaryOperation::Minus, Take(yymsp[0].minor.yy65));
-  yy_destructor(yypParser,4,&yymsp[-1].minor);
+    EmplaceAST<CLiteralAST>(yygotominor.yy71, CLiteralAST::Value(yymsp[0].minor.yy0.value));
 }
         break;
-      case 44: /* expression ::= NUMBER_VALUE */
+      case 74: /* expression ::= INTEGER_VALUE */
 {
-    EmplaceAST<CLiteralAST>(yygotominor.yy65, CLiteralAST::Value(yymsp[0].minor.yy0.value));
+    EmplaceAST<CLiteralAST>(yygotominor.yy71, CLiteralAST::Value(yymsp[0].minor.yy0.intValue));
 }
         break;
-      case 45: /* expression ::= STRING_VALUE */
+      case 75: /* expression ::= STRING_VALUE */
 {
-    EmplaceAST<CLiteralAST>(yygotominor.yy65, pParse->GetStringLiteral(yymsp[0].minor.yy0.stringId));
+    EmplaceAST<CLiteralAST>(yygotominor.yy71, pParse->GetStringLiteral(yymsp[0].minor.yy0.stringId));
 }
         break;
-      case 46: /* expression ::= BOOLEAN_VALUE */
+      case 76: /* expression ::= BOOLEAN_VALUE */
 {
-    EmplaceAST<CLiteralAST>(yygotominor.yy65, CLiteralAST::Value(yymsp[0].minor.yy0.boolValue));
+    EmplaceAST<CLiteralAST>(yygotominor.yy71, CLiteralAST::Value(yymsp[0].minor.yy0.boolValue));
 }
         break;
-      case 47: /* expression ::= ID */
+      case 77: /* expression ::= ID */
 {
-    EmplaceAST<CVariableRefAST>(yygotominor.yy65, yymsp[0].minor.yy0.stringId);
+    EmplaceAST<CVariableRefAST>(yygotominor.yy71, yymsp[0].minor.yy0.stringId);
 }
         break;
       default:
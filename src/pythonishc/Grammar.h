@@ -1,27 +1,53 @@
-#define TK_LESS                            1
-#define TK_EQUALS                          2
-#define TK_PLUS                            3
-#define TK_MINUS                           4
-#define TK_STAR                            5
-#define TK_SLASH                           6
-#define TK_PERCENT                         7
-#define TK_NEWLINE                         8
-#define TK_STRING_TYPE                     9
-#define TK_NUMBER_TYPE                    10
-#define TK_BOOLEAN_TYPE                   11
-#define TK_FUNCTION                       12
-#define TK_ID                             13
-#define TK_END                            14
-#define TK_LPAREN                         15
-#define TK_RPAREN                         16
-#define TK_COMMA                          17
-#define TK_ASSIGN                         18
-#define TK_PRINT                          19
-#define TK_RETURN                         20
-#define TK_IF                             21
-#define TK_ELSE                           22
-#define TK_WHILE                          23
-#define TK_DO                             24
-#define TK_NUMBER_VALUE                   25
-#define TK_STRING_VALUE                   26
-#define TK_BOOLEAN_VALUE                  27
+#define TK_OR                              1
+#define TK_AND                             2
+#define TK_NOT                             3
+#define TK_LESS                            4
+#define TK_EQUALS                          5
+#define TK_NOT_EQUALS                      6
+#define TK_GREATER                         7
+#define TK_LESS_EQUALS                     8
+#define TK_GREATER_EQUALS                  9
+#define TK_PIPE                           10
+#define TK_CARET                          11
+#define TK_AMPERSAND                      12
+#define TK_SHL                            13
+#define TK_SHR                            14
+#define TK_PLUS                           15
+#define TK_MINUS                          16
+#define TK_STAR                           17
+#define TK_SLASH                          18
+#define TK_PERCENT                        19
+#define TK_TILDE                          20
+#define TK_LBRACKET                       21
+#define TK_NEWLINE                        22
+#define TK_AT                             23
+#define TK_ID                             24
+#define TK_LPAREN                         25
+#define TK_RPAREN                         26
+#define TK_COMMA                          27
+#define TK_STRING_TYPE                    28
+#define TK_NUMBER_TYPE                    29
+#define TK_BOOLEAN_TYPE                   30
+#define TK_INT_TYPE                       31
+#define TK_FUNCTION                       32
+#define TK_END                            33
+#define TK_ASSIGN                         34
+#define TK_PRINT                          35
+#define TK_RETURN                         36
+#define TK_BREAK                          37
+#define TK_CONTINUE                       38
+#define TK_IF                             39
+#define TK_ELSE                           40
+#define TK_WHILE                          41
+#define TK_DO                             42
+#define TK_FORMAT_BEGIN                   43
+#define TK_FORMAT_END                     44
+#define TK_FORMAT_TEXT                    45
+#define TK_LBRACE                         46
+#define TK_RBRACE                         47
+#define TK_COLON                          48
+#define TK_RBRACKET                       49
+#define TK_NUMBER_VALUE                   50
+#define TK_INTEGER_VALUE                  51
+#define TK_STRING_VALUE                   52
+#define TK_BOOLEAN_VALUE                  53
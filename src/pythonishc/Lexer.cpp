@@ -3,6 +3,8 @@
 #include <iostream>
 #include <sstream>
 #include <cmath>
+#include <cerrno>
+#include <cstdlib>
 
 CLexer::CLexer(unsigned lineNo, std::string const& line, CStringPool &pool, const ErrorHandler &handler)
     : m_lineNo(lineNo)
@@ -17,10 +19,16 @@ CLexer::CLexer(unsigned lineNo, std::string const& line, CStringPool &pool, cons
         { "else",   TK_ELSE },
         { "while",  TK_WHILE },
         { "print",  TK_PRINT },
+        { "and",    TK_AND },
+        { "or",     TK_OR },
+        { "not",    TK_NOT },
         { "return", TK_RETURN },
+        { "break",  TK_BREAK },
+        { "continue", TK_CONTINUE },
         { "function", TK_FUNCTION },
         { "String", TK_STRING_TYPE },
         { "Number", TK_NUMBER_TYPE },
+        { "Int",    TK_INT_TYPE },
         { "Boolean",TK_BOOLEAN_TYPE },
       })
 {
@@ -28,6 +36,12 @@ CLexer::CLexer(unsigned lineNo, std::string const& line, CStringPool &pool, cons
 
 int CLexer::Scan(Token &data)
 {
+    if (m_formatState == FormatState::Text)
+    {
+        data.line = m_lineNo;
+        data.column = 1 + unsigned(m_peep.data() - m_sources.c_str());
+        return ScanFormatText(data);
+    }
     SkipSpaces();
     data.line = m_lineNo;
     data.column = 1 + unsigned(m_peep.data() - m_sources.c_str());
@@ -36,11 +50,19 @@ int CLexer::Scan(Token &data)
     {
         return 0;
     }
-    double value = ParseDouble();
-    if (!std::isnan(value))
+    if (m_formatState == FormatState::Field && m_peep[0] == '}')
+    {
+        m_peep.remove_prefix(1);
+        m_formatState = FormatState::Text;
+        return TK_RBRACE;
+    }
+    if (ParseFormatBegin())
     {
-        data.value = value;
-        return TK_NUMBER_VALUE;
+        return TK_FORMAT_BEGIN;
+    }
+    if (int numberToken = ParseNumber(data))
+    {
+        return numberToken;
     }
     if (ParseString(data))
     {
@@ -49,8 +71,38 @@ int CLexer::Scan(Token &data)
     switch (m_peep[0])
     {
     case '<':
+        if (m_peep.length() >= 2 && (m_peep[1] == '<'))
+        {
+            m_peep.remove_prefix(2);
+            return TK_SHL;
+        }
+        if (m_peep.length() >= 2 && (m_peep[1] == '='))
+        {
+            m_peep.remove_prefix(2);
+            return TK_LESS_EQUALS;
+        }
         m_peep.remove_prefix(1);
         return TK_LESS;
+    case '>':
+        if (m_peep.length() >= 2 && (m_peep[1] == '>'))
+        {
+            m_peep.remove_prefix(2);
+            return TK_SHR;
+        }
+        if (m_peep.length() >= 2 && (m_peep[1] == '='))
+        {
+            m_peep.remove_prefix(2);
+            return TK_GREATER_EQUALS;
+        }
+        m_peep.remove_prefix(1);
+        return TK_GREATER;
+    case '!':
+        if (m_peep.length() >= 2 && (m_peep[1] == '='))
+        {
+            m_peep.remove_prefix(2);
+            return TK_NOT_EQUALS;
+        }
+        break;
     case '+':
         m_peep.remove_prefix(1);
         return TK_PLUS;
@@ -66,15 +118,39 @@ int CLexer::Scan(Token &data)
     case ',':
         m_peep.remove_prefix(1);
         return TK_COMMA;
+    case '@':
+        m_peep.remove_prefix(1);
+        return TK_AT;
     case '%':
         m_peep.remove_prefix(1);
         return TK_PERCENT;
+    case '&':
+        m_peep.remove_prefix(1);
+        return TK_AMPERSAND;
+    case '|':
+        m_peep.remove_prefix(1);
+        return TK_PIPE;
+    case '^':
+        m_peep.remove_prefix(1);
+        return TK_CARET;
+    case '~':
+        m_peep.remove_prefix(1);
+        return TK_TILDE;
     case '(':
         m_peep.remove_prefix(1);
         return TK_LPAREN;
     case ')':
         m_peep.remove_prefix(1);
         return TK_RPAREN;
+    case '[':
+        m_peep.remove_prefix(1);
+        return TK_LBRACKET;
+    case ']':
+        m_peep.remove_prefix(1);
+        return TK_RBRACKET;
+    case ':':
+        m_peep.remove_prefix(1);
+        return TK_COLON;
     case '=':
         if (m_peep.length() >= 2 && (m_peep[1] == '='))
         {
@@ -95,37 +171,45 @@ int CLexer::Scan(Token &data)
     return 0;
 }
 
-// returns NaN if cannot parse double.
-double CLexer::ParseDouble()
+// Returns TK_INTEGER_VALUE for literal without fractional part which fits into Int,
+//  TK_NUMBER_VALUE for other numbers and 0 if cannot parse number.
+int CLexer::ParseNumber(Token &data)
 {
-    double value = 0;
-    bool parsedAny = false;
-    while (!m_peep.empty() && std::isdigit(m_peep[0]))
+    size_t size = 0;
+    while (size < m_peep.size() && std::isdigit(m_peep[size]))
     {
-        parsedAny = true;
-        const int digit = m_peep[0] - '0';
-        value = value * 10.0f + double(digit);
-        m_peep.remove_prefix(1);
+        ++size;
     }
-    if (!parsedAny)
+    if (size == 0)
     {
-        return std::numeric_limits<double>::quiet_NaN();
+        return 0;
     }
-    if (m_peep.empty() || (m_peep[0] != '.'))
+    bool hasFraction = false;
+    if (size < m_peep.size() && (m_peep[size] == '.'))
     {
-        return value;
+        hasFraction = true;
+        ++size;
+        while (size < m_peep.size() && std::isdigit(m_peep[size]))
+        {
+            ++size;
+        }
     }
-    m_peep.remove_prefix(1);
-    double factor = 1.f;
-    while (!m_peep.empty() && std::isdigit(m_peep[0]))
+    const std::string text = m_peep.substr(0, size).to_string();
+    m_peep.remove_prefix(size);
+
+    if (!hasFraction)
     {
-        const int digit = m_peep[0] - '0';
-        factor *= 0.1f;
-        value += factor * double(digit);
-        m_peep.remove_prefix(1);
+        errno = 0;
+        const long long value = std::strtoll(text.c_str(), nullptr, 10);
+        if (errno != ERANGE)
+        {
+            data.intValue = value;
+            return TK_INTEGER_VALUE;
+        }
     }
-
-    return value;
+    // strtod rounds correctly, unlike accumulating digits with factors.
+    data.value = std::strtod(text.c_str(), nullptr);
+    return TK_NUMBER_VALUE;
 }
 
 std::string CLexer::ParseIdentifier()
@@ -174,6 +258,66 @@ bool CLexer::ParseString(Token &data)
     return true;
 }
 
+// Recognizes f-string start `f"`, the rest of f-string is scanned by ScanFormatText.
+bool CLexer::ParseFormatBegin()
+{
+    if (m_formatState != FormatState::None || !m_peep.starts_with("f\""))
+    {
+        return false;
+    }
+    m_peep.remove_prefix(2);
+    m_formatState = FormatState::Text;
+    return true;
+}
+
+// Splits f-string text into TK_FORMAT_TEXT pieces and TK_LBRACE before each expression field.
+// `{{` and `}}` in the text stand for single braces, closing quote gives TK_FORMAT_END.
+int CLexer::ScanFormatText(Token &data)
+{
+    if (m_peep.empty())
+    {
+        OnError("missed end quote", data);
+        m_formatState = FormatState::None;
+        return TK_FORMAT_END;
+    }
+    if (m_peep[0] == '\"')
+    {
+        m_peep.remove_prefix(1);
+        m_formatState = FormatState::None;
+        return TK_FORMAT_END;
+    }
+    if (m_peep.starts_with("{") && !m_peep.starts_with("{{"))
+    {
+        m_peep.remove_prefix(1);
+        m_formatState = FormatState::Field;
+        return TK_LBRACE;
+    }
+    std::string text;
+    while (!m_peep.empty() && m_peep[0] != '\"')
+    {
+        const char ch = m_peep[0];
+        if (ch == '{' || ch == '}')
+        {
+            if (m_peep.size() < 2 || m_peep[1] != ch)
+            {
+                if (ch == '{')
+                {
+                    break;
+                }
+                OnError("single '}' in f-string", data);
+            }
+            else
+            {
+                m_peep.remove_prefix(1);
+            }
+        }
+        text.push_back(ch);
+        m_peep.remove_prefix(1);
+    }
+    data.stringId = m_stringPool.Insert(text);
+    return TK_FORMAT_TEXT;
+}
+
 int CLexer::AcceptIdOrKeyword(Token &data, std::string && id)
 {
     if (id == "true")
@@ -20,10 +20,20 @@ public:
     int Scan(Token &data);
 
 private:
-    double ParseDouble();
+    // Position inside f-string: its text or an expression in braces.
+    enum class FormatState
+    {
+        None,
+        Text,
+        Field,
+    };
+
+    int ParseNumber(Token &data);
     std::string ParseIdentifier();
     void SkipSpaces();
     bool ParseString(Token &data);
+    bool ParseFormatBegin();
+    int ScanFormatText(Token &data);
     int AcceptIdOrKeyword(Token &data, std::string && id);
     void OnError(const char message[], Token &data);
 
@@ -33,4 +43,5 @@ private:
     CStringPool & m_stringPool;
     ErrorHandler m_onError;
     const std::map<std::string, int> m_keywords;
+    FormatState m_formatState = FormatState::None;
 };
@@ -1,6 +1,7 @@
 #include "Parser.h"
 #include "Token.h"
 #include "FrontendContext.h"
+#include "CodegenOptions.h"
 #include <cstdlib>
 #include <new>
 #include <iostream>
@@ -80,6 +81,49 @@ std::string CParser::GetStringLiteral(unsigned stringId) const
     return m_context.GetString(stringId);
 }
 
+// Единственный поддерживаемый декоратор функции - @fastmath.
+unsigned CParser::GetDecoratorFlags(const Token &name, unsigned flags)
+{
+    if (m_context.GetString(name.stringId) != "fastmath")
+    {
+        std::stringstream message;
+        message << "Unknown decorator '" << m_context.GetString(name.stringId)
+                << "' at (" << name.line << "," << name.column << ")";
+        m_context.PrintError(message.str());
+        return FastMath::None;
+    }
+    return flags;
+}
+
+unsigned CParser::GetFastMathFlag(const Token &name)
+{
+    unsigned flag = FastMath::ParseFlag(m_context.GetString(name.stringId));
+    if (flag == FastMath::None)
+    {
+        std::stringstream message;
+        message << "Unknown fastmath flag '" << m_context.GetString(name.stringId)
+                << "' at (" << name.line << "," << name.column << ")";
+        m_context.PrintError(message.str());
+    }
+    return flag;
+}
+
+// f"a{x}b" превращается в `"a" + String(x) + "b"`: кодогенератор собирает такую цепочку
+//  одним выделением памяти, а под print выводит операнды по очереди.
+IExpressionASTUniquePtr CParser::JoinFormatParts(ExpressionList &&parts) const
+{
+    if (parts.empty())
+    {
+        return std::make_unique<CLiteralAST>(std::string());
+    }
+    IExpressionASTUniquePtr pJoined = std::move(parts.front());
+    for (auto it = parts.begin() + 1; it != parts.end(); ++it)
+    {
+        pJoined = std::make_unique<CBinaryExpressionAST>(std::move(pJoined), BinaryOperation::Add, std::move(*it));
+    }
+    return pJoined;
+}
+
 void CParser::AddFunction(IFunctionASTUniquePtr &&function)
 {
     if (function)
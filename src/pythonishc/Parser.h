@@ -28,6 +28,10 @@ public:
     void OnFatalError();
 
     std::string GetStringLiteral(unsigned stringId)const;
+    unsigned GetDecoratorFlags(Token const& name, unsigned flags);
+    unsigned GetFastMathFlag(Token const& name);
+    // Собирает f-строку из литералов и полей `String(...)` в цепочку конкатенаций.
+    IExpressionASTUniquePtr JoinFormatParts(ExpressionList && parts)const;
     void AddFunction(IFunctionASTUniquePtr && function);
 
 private:
@@ -7,6 +7,7 @@
 #include "Token.h"
 #include "Parser.h"
 #include "AST.h"
+#include "CodegenOptions.h"
 
 namespace parser_private
 {
@@ -84,7 +85,7 @@ using StatementListPtr = StatementsList*;
 using ParameterDeclListPtr = ParameterDeclList*;
 using StatementPtr = IStatementAST*;
 using ExpressionPtr = IExpressionAST*;
-using FunctionPtr = IFunctionAST*;
+using FunctionPtr = CFunctionAST*;
 using ParameterDeclPtr = CParameterDeclAST*;
 
 }
@@ -0,0 +1,860 @@
+#include "RangeAnalysis.h"
+#include <cmath>
+#include <limits>
+#include <algorithm>
+
+namespace
+{
+// Целые числа по модулю меньше 2^53 точно представимы в double,
+//  поэтому вычисления над ними в i64 дают тот же результат, что и в double.
+const double MAX_EXACT_INTEGER = 9007199254740992.0;
+const double INF = std::numeric_limits<double>::infinity();
+
+// Число итераций цикла до расширения границ до бесконечности.
+const unsigned WIDENING_DELAY = 2;
+
+// Нижняя граница, вышедшая за пределы точного диапазона, заменяется на -INF
+//  либо на ближайшую точную границу, что не сужает множество значений.
+double NormalizeLow(double value)
+{
+    if (value <= -MAX_EXACT_INTEGER)
+    {
+        return -INF;
+    }
+    return std::min(value, MAX_EXACT_INTEGER);
+}
+
+double NormalizeHigh(double value)
+{
+    if (value >= MAX_EXACT_INTEGER)
+    {
+        return INF;
+    }
+    return std::max(value, -MAX_EXACT_INTEGER);
+}
+
+IntegerRange MakeRange(double low, double high)
+{
+    return IntegerRange::Interval(NormalizeLow(low), NormalizeHigh(high));
+}
+
+double MultiplyBounds(double a, double b)
+{
+    // Произведение бесконечной границы на 0 равно 0, а не NaN.
+    if (a == 0 || b == 0)
+    {
+        return 0;
+    }
+    return a * b;
+}
+
+IntegerRange JoinRanges(const IntegerRange &a, const IntegerRange &b)
+{
+    if (a.IsBottom())
+    {
+        return b;
+    }
+    if (b.IsBottom())
+    {
+        return a;
+    }
+    if (a.IsTop() || b.IsTop())
+    {
+        return IntegerRange::Top();
+    }
+    return IntegerRange::Interval(std::min(a.low, b.low), std::max(a.high, b.high));
+}
+
+IntegerRange WidenRange(const IntegerRange &previous, const IntegerRange &next)
+{
+    if (previous.IsBottom() || next.IsBottom() || next.IsTop())
+    {
+        return next;
+    }
+    double low = (next.low < previous.low) ? -INF : previous.low;
+    double high = (next.high > previous.high) ? INF : previous.high;
+    return IntegerRange::Interval(low, high);
+}
+
+// Вычисляет диапазон результата бинарной операции над Number.
+// Операции, которые могут дать -0, дробь или NaN, дают top.
+IntegerRange EvaluateBinaryRange(BinaryOperation op, const IntegerRange &a, const IntegerRange &b)
+{
+    if (a.IsBottom() || b.IsBottom())
+    {
+        return IntegerRange::Bottom();
+    }
+    if (a.IsTop() || b.IsTop())
+    {
+        return IntegerRange::Top();
+    }
+    switch (op)
+    {
+    case BinaryOperation::Add:
+        return MakeRange(a.low + b.low, a.high + b.high);
+    case BinaryOperation::Substract:
+        return MakeRange(a.low - b.high, a.high - b.low);
+    case BinaryOperation::Multiply:
+    {
+        // 0 * -5 даёт -0, который нельзя представить в i64.
+        if ((a.Contains(0) && b.low < 0) || (b.Contains(0) && a.low < 0))
+        {
+            return IntegerRange::Top();
+        }
+        const double products[] = {
+            MultiplyBounds(a.low, b.low),
+            MultiplyBounds(a.low, b.high),
+            MultiplyBounds(a.high, b.low),
+            MultiplyBounds(a.high, b.high),
+        };
+        return MakeRange(*std::min_element(std::begin(products), std::end(products)),
+                         *std::max_element(std::begin(products), std::end(products)));
+    }
+    case BinaryOperation::Modulo:
+    {
+        // fmod(x, 0) даёт NaN, а fmod(-4, 2) даёт -0.
+        if (b.Contains(0) || a.low < 0)
+        {
+            return IntegerRange::Top();
+        }
+        const double maxRemainder = std::max(std::fabs(b.low), std::fabs(b.high)) - 1;
+        return MakeRange(0, std::min(a.high, maxRemainder));
+    }
+    case BinaryOperation::Divide:
+        return IntegerRange::Top();
+    case BinaryOperation::Less:
+    case BinaryOperation::Equals:
+    case BinaryOperation::NotEquals:
+    case BinaryOperation::Greater:
+    case BinaryOperation::LessOrEquals:
+    case BinaryOperation::GreaterOrEquals:
+    case BinaryOperation::And:
+    case BinaryOperation::Or:
+    case BinaryOperation::BitwiseAnd:
+    case BinaryOperation::BitwiseOr:
+    case BinaryOperation::BitwiseXor:
+    case BinaryOperation::ShiftLeft:
+    case BinaryOperation::ShiftRight:
+        break;
+    }
+    return IntegerRange::Top();
+}
+
+// Находит выражения, которые можно вычислить в i64: целочисленные литералы,
+//  суженные переменные и арифметику над ними, если диапазон результата ограничен.
+class CIntegralExpressionFinder
+        : protected IStatementVisitor
+        , protected IExpressionVisitor
+{
+public:
+    CIntegralExpressionFinder(const std::unordered_map<const IExpressionAST *, IntegerRange> &ranges,
+                              const std::unordered_set<unsigned> &variables)
+        : m_ranges(ranges)
+        , m_variables(variables)
+    {
+    }
+
+    void Run(const StatementsList &statements)
+    {
+        for (const auto &pStmt : statements)
+        {
+            pStmt->Accept(*this);
+        }
+    }
+
+    const std::unordered_set<const IExpressionAST *> &GetExpressions()const
+    {
+        return m_expressions;
+    }
+
+    // Переменные типа Number, которым присваиваются значения.
+    const std::unordered_set<unsigned> &GetAssignedVariables()const
+    {
+        return m_assigned;
+    }
+
+    // Переменные, которым присваиваются только целочисленные выражения.
+    std::unordered_set<unsigned> GetIntegralVariables()const
+    {
+        std::unordered_set<unsigned> result;
+        for (unsigned nameId : m_variables)
+        {
+            if (!m_nonIntegral.count(nameId))
+            {
+                result.insert(nameId);
+            }
+        }
+        return result;
+    }
+
+protected:
+    void Visit(CPrintAST &ast) override
+    {
+        Check(ast.GetValue());
+    }
+
+    void Visit(CAssignAST &ast) override
+    {
+        if (ast.GetValue().GetType() != ExpressionType::Number)
+        {
+            Check(ast.GetValue());
+            return;
+        }
+        m_assigned.insert(ast.GetNameId());
+        if (!Check(ast.GetValue()))
+        {
+            m_nonIntegral.insert(ast.GetNameId());
+        }
+    }
+
+    void Visit(CReturnAST &ast) override
+    {
+        Check(ast.GetValue());
+    }
+
+    void Visit(CLoopJumpAST &) override
+    {
+    }
+
+    void Visit(CWhileAst &ast) override
+    {
+        Check(ast.GetCondition());
+        Run(ast.GetBody());
+    }
+
+    void Visit(CRepeatAst &ast) override
+    {
+        Run(ast.GetBody());
+        Check(ast.GetCondition());
+    }
+
+    void Visit(CIfAst &ast) override
+    {
+        Check(ast.GetCondition());
+        Run(ast.GetThenBody());
+        Run(ast.GetElseBody());
+    }
+
+    void Visit(CBinaryExpressionAST &expr) override
+    {
+        const bool isLeftIntegral = Check(expr.GetLeft());
+        const bool isRightIntegral = Check(expr.GetRight());
+        switch (expr.GetOperation())
+        {
+        case BinaryOperation::Add:
+        case BinaryOperation::Substract:
+        case BinaryOperation::Multiply:
+        case BinaryOperation::Modulo:
+            m_isIntegral = isLeftIntegral && isRightIntegral && IsBounded(expr);
+            break;
+        default:
+            m_isIntegral = false;
+            break;
+        }
+    }
+
+    void Visit(CUnaryExpressionAST &expr) override
+    {
+        m_isIntegral = Check(expr.GetOperand()) && IsBounded(expr);
+    }
+
+    void Visit(CLiteralAST &expr) override
+    {
+        m_isIntegral = (expr.GetType() == ExpressionType::Number) && IsBounded(expr);
+    }
+
+    void Visit(CCallAST &expr) override
+    {
+        for (const auto &pArg : expr.GetArguments())
+        {
+            Check(*pArg);
+        }
+        m_isIntegral = false;
+    }
+
+    void Visit(CVariableRefAST &expr) override
+    {
+        m_isIntegral = m_variables.count(expr.GetNameId()) && IsBounded(expr);
+    }
+
+    void Visit(CParameterDeclAST &) override
+    {
+        m_isIntegral = false;
+    }
+
+    void Visit(CConversionAST &expr) override
+    {
+        Check(expr.GetOperand());
+        m_isIntegral = false;
+    }
+
+    void Visit(CSliceAST &expr) override
+    {
+        Check(expr.GetOperand());
+        for (IExpressionAST *pBound : {expr.GetBegin(), expr.GetEnd()})
+        {
+            if (pBound)
+            {
+                Check(*pBound);
+            }
+        }
+        m_isIntegral = false;
+    }
+
+private:
+    bool Check(IExpressionAST &expr)
+    {
+        expr.Accept(*this);
+        if (m_isIntegral)
+        {
+            m_expressions.insert(&expr);
+        }
+        return m_isIntegral;
+    }
+
+    bool IsBounded(IExpressionAST &expr)const
+    {
+        auto it = m_ranges.find(&expr);
+        return (it != m_ranges.end()) && it->second.IsBounded();
+    }
+
+    const std::unordered_map<const IExpressionAST *, IntegerRange> &m_ranges;
+    const std::unordered_set<unsigned> &m_variables;
+    std::unordered_set<const IExpressionAST *> m_expressions;
+    std::unordered_set<unsigned> m_assigned;
+    std::unordered_set<unsigned> m_nonIntegral;
+    bool m_isIntegral = false;
+};
+}
+
+IntegerRange IntegerRange::Bottom()
+{
+    return IntegerRange();
+}
+
+IntegerRange IntegerRange::Top()
+{
+    IntegerRange result;
+    result.isBottom = false;
+    result.isTop = true;
+    return result;
+}
+
+IntegerRange IntegerRange::Interval(double low, double high)
+{
+    if (low > high)
+    {
+        return Bottom();
+    }
+    IntegerRange result;
+    result.isBottom = false;
+    result.low = low;
+    result.high = high;
+    return result;
+}
+
+bool IntegerRange::IsBottom() const
+{
+    return isBottom;
+}
+
+bool IntegerRange::IsTop() const
+{
+    return isTop;
+}
+
+bool IntegerRange::IsBounded() const
+{
+    return !isBottom && !isTop && (low > -MAX_EXACT_INTEGER) && (high < MAX_EXACT_INTEGER);
+}
+
+bool IntegerRange::Contains(double value) const
+{
+    return !isBottom && !isTop && (low <= value) && (value <= high);
+}
+
+bool IntegerRange::operator ==(const IntegerRange &other) const
+{
+    if (isBottom || other.isBottom || isTop || other.isTop)
+    {
+        return (isBottom == other.isBottom) && (isTop == other.isTop);
+    }
+    return (low == other.low) && (high == other.high);
+}
+
+bool IntegerRange::operator !=(const IntegerRange &other) const
+{
+    return !(*this == other);
+}
+
+bool CRangeAnalysis::State::operator ==(const State &other) const
+{
+    if (isReachable != other.isReachable)
+    {
+        return false;
+    }
+    // Отсутствующая переменная равносильна переменной со значением bottom.
+    auto isSubset = [](const State &a, const State &b) {
+        return std::all_of(a.variables.begin(), a.variables.end(), [&](const auto &pair) {
+            auto it = b.variables.find(pair.first);
+            return (it != b.variables.end()) ? (it->second == pair.second) : pair.second.IsBottom();
+        });
+    };
+    return isSubset(*this, other) && isSubset(other, *this);
+}
+
+NumberNarrowing CRangeAnalysis::Analyze(IFunctionAST &ast)
+{
+    // Кандидаты - локальные переменные типа Number, параметры могут принимать любые значения.
+    {
+        CIntegralExpressionFinder finder(m_ranges, m_candidates);
+        finder.Run(ast.GetBody());
+        m_candidates = finder.GetAssignedVariables();
+    }
+    for (const auto &pParam : ast.GetParameters())
+    {
+        m_candidates.erase(pParam->GetName());
+    }
+
+    // Каждый проход исключает переменные, которым присваиваются нецелые значения,
+    //  пока множество кандидатов не перестанет меняться.
+    while (true)
+    {
+        m_ranges.clear();
+        m_state = State();
+        Execute(ast.GetBody());
+
+        CIntegralExpressionFinder finder(m_ranges, m_candidates);
+        finder.Run(ast.GetBody());
+        std::unordered_set<unsigned> integralVariables = finder.GetIntegralVariables();
+        if (integralVariables.size() == m_candidates.size())
+        {
+            NumberNarrowing result;
+            result.variables = m_candidates;
+            result.expressions = finder.GetExpressions();
+            return result;
+        }
+        m_candidates = std::move(integralVariables);
+    }
+}
+
+void CRangeAnalysis::Visit(CPrintAST &ast)
+{
+    Evaluate(ast.GetValue());
+}
+
+void CRangeAnalysis::Visit(CAssignAST &ast)
+{
+    IntegerRange value = Evaluate(ast.GetValue());
+    if (m_state.isReachable && m_candidates.count(ast.GetNameId()))
+    {
+        m_state.variables[ast.GetNameId()] = value;
+    }
+}
+
+void CRangeAnalysis::Visit(CReturnAST &ast)
+{
+    Evaluate(ast.GetValue());
+    m_state.isReachable = false;
+}
+
+// Состояние перед break попадает в состояние после цикла, перед continue - в конец итерации.
+void CRangeAnalysis::Visit(CLoopJumpAST &ast)
+{
+    LoopExits &loop = m_loops.back();
+    State &target = (ast.GetKind() == LoopJump::Break) ? loop.breakState : loop.continueState;
+    target = Join(target, m_state);
+    m_state.isReachable = false;
+}
+
+void CRangeAnalysis::Visit(CWhileAst &ast)
+{
+    const State entry = m_state;
+    State head = entry;
+    m_loops.emplace_back();
+
+    ++m_silenceDepth;
+    for (unsigned iteration = 0; ; ++iteration)
+    {
+        State next = Join(entry, ExecuteLoopBody(Refine(head, ast.GetCondition(), true), ast.GetBody()));
+        if (iteration >= WIDENING_DELAY)
+        {
+            next = Widen(head, next);
+        }
+        if (next == head)
+        {
+            break;
+        }
+        head = next;
+    }
+    // Сужение: ещё одна итерация уточняет расширенные границы условием цикла.
+    head = Join(entry, ExecuteLoopBody(Refine(head, ast.GetCondition(), true), ast.GetBody()));
+    --m_silenceDepth;
+
+    m_state = head;
+    Evaluate(ast.GetCondition());
+    ExecuteLoopBody(Refine(head, ast.GetCondition(), true), ast.GetBody());
+    m_state = Join(Refine(head, ast.GetCondition(), false), m_loops.back().breakState);
+    m_loops.pop_back();
+}
+
+void CRangeAnalysis::Visit(CRepeatAst &ast)
+{
+    const State entry = m_state;
+    State head = entry;
+    m_loops.emplace_back();
+
+    ++m_silenceDepth;
+    for (unsigned iteration = 0; ; ++iteration)
+    {
+        State next = Join(entry, Refine(ExecuteLoopBody(head, ast.GetBody()), ast.GetCondition(), true));
+        if (iteration >= WIDENING_DELAY)
+        {
+            next = Widen(head, next);
+        }
+        if (next == head)
+        {
+            break;
+        }
+        head = next;
+    }
+    head = Join(entry, Refine(ExecuteLoopBody(head, ast.GetBody()), ast.GetCondition(), true));
+    --m_silenceDepth;
+
+    m_state = ExecuteLoopBody(head, ast.GetBody());
+    Evaluate(ast.GetCondition());
+    m_state = Join(Refine(m_state, ast.GetCondition(), false), m_loops.back().breakState);
+    m_loops.pop_back();
+}
+
+void CRangeAnalysis::Visit(CIfAst &ast)
+{
+    const State entry = m_state;
+    Evaluate(ast.GetCondition());
+
+    m_state = Refine(entry, ast.GetCondition(), true);
+    Execute(ast.GetThenBody());
+    const State thenState = m_state;
+
+    m_state = Refine(entry, ast.GetCondition(), false);
+    Execute(ast.GetElseBody());
+    m_state = Join(thenState, m_state);
+}
+
+void CRangeAnalysis::Visit(CBinaryExpressionAST &expr)
+{
+    IntegerRange a = Evaluate(expr.GetLeft());
+    IntegerRange b = Evaluate(expr.GetRight());
+    if (expr.GetType() == ExpressionType::Number)
+    {
+        m_values.push_back(EvaluateBinaryRange(expr.GetOperation(), a, b));
+    }
+    else
+    {
+        m_values.push_back(IntegerRange::Top());
+    }
+}
+
+void CRangeAnalysis::Visit(CUnaryExpressionAST &expr)
+{
+    IntegerRange x = Evaluate(expr.GetOperand());
+    if (expr.GetType() != ExpressionType::Number)
+    {
+        m_values.push_back(IntegerRange::Top());
+    }
+    else if (x.IsBottom() || x.IsTop() || expr.GetOperation() == UnaryOperation::Plus)
+    {
+        m_values.push_back(x);
+    }
+    else if (x.Contains(0))
+    {
+        // -(+0) даёт -0.
+        m_values.push_back(IntegerRange::Top());
+    }
+    else
+    {
+        m_values.push_back(MakeRange(-x.high, -x.low));
+    }
+}
+
+void CRangeAnalysis::Visit(CLiteralAST &expr)
+{
+    double value = std::numeric_limits<double>::quiet_NaN();
+    if (const double *pValue = boost::get<double>(&expr.GetValue()))
+    {
+        value = *pValue;
+    }
+    else if (const int64_t *pValue = boost::get<int64_t>(&expr.GetValue()))
+    {
+        value = static_cast<double>(*pValue);
+    }
+    const bool isNumber = (expr.GetType() == ExpressionType::Number);
+    if (isNumber && std::trunc(value) == value && std::fabs(value) < MAX_EXACT_INTEGER)
+    {
+        m_values.push_back(IntegerRange::Interval(value, value));
+    }
+    else
+    {
+        m_values.push_back(IntegerRange::Top());
+    }
+}
+
+void CRangeAnalysis::Visit(CCallAST &expr)
+{
+    for (const auto &pArg : expr.GetArguments())
+    {
+        Evaluate(*pArg);
+    }
+    m_values.push_back(IntegerRange::Top());
+}
+
+void CRangeAnalysis::Visit(CVariableRefAST &expr)
+{
+    if (!m_candidates.count(expr.GetNameId()))
+    {
+        m_values.push_back(IntegerRange::Top());
+        return;
+    }
+    auto it = m_state.variables.find(expr.GetNameId());
+    m_values.push_back((it != m_state.variables.end()) ? it->second : IntegerRange::Bottom());
+}
+
+void CRangeAnalysis::Visit(CParameterDeclAST &)
+{
+    m_values.push_back(IntegerRange::Top());
+}
+
+void CRangeAnalysis::Visit(CConversionAST &expr)
+{
+    Evaluate(expr.GetOperand());
+    m_values.push_back(IntegerRange::Top());
+}
+
+void CRangeAnalysis::Visit(CSliceAST &expr)
+{
+    Evaluate(expr.GetOperand());
+    for (IExpressionAST *pBound : {expr.GetBegin(), expr.GetEnd()})
+    {
+        if (pBound)
+        {
+            Evaluate(*pBound);
+        }
+    }
+    m_values.push_back(IntegerRange::Top());
+}
+
+void CRangeAnalysis::Execute(const StatementsList &statements)
+{
+    for (const auto &pStmt : statements)
+    {
+        pStmt->Accept(*this);
+    }
+}
+
+IntegerRange CRangeAnalysis::Evaluate(IExpressionAST &expr)
+{
+    expr.Accept(*this);
+    IntegerRange value = m_values.back();
+    m_values.pop_back();
+    if (!m_state.isReachable)
+    {
+        value = IntegerRange::Bottom();
+    }
+    Record(expr, value);
+    return value;
+}
+
+IntegerRange CRangeAnalysis::EvaluateSilently(IExpressionAST &expr)
+{
+    ++m_silenceDepth;
+    IntegerRange value = Evaluate(expr);
+    --m_silenceDepth;
+    return value;
+}
+
+// Сравнения ограниченных диапазонов, то есть целых чисел без NaN, сводятся к `<` и `==`:
+//  `a > b` - это `b < a`, а `a <= b` - это `!(b < a)`.
+CRangeAnalysis::State CRangeAnalysis::Refine(const State &state, IExpressionAST &condition, bool isTrue)
+{
+    State result = state;
+    if (!result.isReachable)
+    {
+        return result;
+    }
+    if (auto *pUnary = dynamic_cast<CUnaryExpressionAST *>(&condition))
+    {
+        if (pUnary->GetOperation() == UnaryOperation::LogicalNot)
+        {
+            return Refine(state, pUnary->GetOperand(), !isTrue);
+        }
+        return result;
+    }
+    auto *pCompare = dynamic_cast<CBinaryExpressionAST *>(&condition);
+    if (!pCompare)
+    {
+        return result;
+    }
+    IExpressionAST &left = pCompare->GetLeft();
+    IExpressionAST &right = pCompare->GetRight();
+    const BinaryOperation op = pCompare->GetOperation();
+    if (op == BinaryOperation::And || op == BinaryOperation::Or)
+    {
+        // Истинное `a and b` и ложное `a or b` требуют одного значения от обоих операндов,
+        //  иначе либо левый операнд даёт результат сам, либо результат даёт правый.
+        State leftDecides = Refine(state, left, isTrue);
+        if ((op == BinaryOperation::And) == isTrue)
+        {
+            return Refine(leftDecides, right, isTrue);
+        }
+        return Join(leftDecides, Refine(Refine(state, left, !isTrue), right, isTrue));
+    }
+    if (left.GetType() != ExpressionType::Number)
+    {
+        return result;
+    }
+
+    std::swap(m_state, result);
+    switch (op)
+    {
+    case BinaryOperation::Less:
+        RefineLess(m_state, left, right, isTrue);
+        break;
+    case BinaryOperation::Greater:
+        RefineLess(m_state, right, left, isTrue);
+        break;
+    case BinaryOperation::LessOrEquals:
+        RefineLess(m_state, right, left, !isTrue);
+        break;
+    case BinaryOperation::GreaterOrEquals:
+        RefineLess(m_state, left, right, !isTrue);
+        break;
+    case BinaryOperation::Equals:
+    case BinaryOperation::NotEquals:
+        if (isTrue == (op == BinaryOperation::Equals))
+        {
+            RefineEquals(m_state, left, right);
+        }
+        break;
+    default:
+        break;
+    }
+    std::swap(m_state, result);
+    return result;
+}
+
+// Обе стороны равенства лежат в пересечении диапазонов.
+void CRangeAnalysis::RefineEquals(State &state, IExpressionAST &left, IExpressionAST &right)
+{
+    IntegerRange a = EvaluateSilently(left);
+    IntegerRange b = EvaluateSilently(right);
+    if (a.IsBottom() || a.IsTop() || b.IsBottom() || b.IsTop())
+    {
+        return;
+    }
+    IntegerRange common = IntegerRange::Interval(std::max(a.low, b.low), std::min(a.high, b.high));
+    if (common.IsBottom())
+    {
+        state.isReachable = false;
+        return;
+    }
+    for (IExpressionAST *pSide : {&left, &right})
+    {
+        auto *pVar = dynamic_cast<CVariableRefAST *>(pSide);
+        if (pVar && m_candidates.count(pVar->GetNameId()))
+        {
+            state.variables[pVar->GetNameId()] = common;
+        }
+    }
+}
+
+// Уточняет диапазоны переменных по условию `left < right` или его отрицанию.
+void CRangeAnalysis::RefineLess(State &state, IExpressionAST &left, IExpressionAST &right, bool isTrue)
+{
+    IntegerRange a = EvaluateSilently(left);
+    IntegerRange b = EvaluateSilently(right);
+    if (a.IsBottom() || a.IsTop() || b.IsBottom() || b.IsTop())
+    {
+        return;
+    }
+
+    // Для целых: a < b равносильно a <= b - 1, а !(a < b) равносильно a >= b.
+    IntegerRange newA = isTrue
+            ? IntegerRange::Interval(a.low, std::min(a.high, b.high - 1))
+            : IntegerRange::Interval(std::max(a.low, b.low), a.high);
+    IntegerRange newB = isTrue
+            ? IntegerRange::Interval(std::max(b.low, a.low + 1), b.high)
+            : IntegerRange::Interval(b.low, std::min(b.high, a.high));
+    if (newA.IsBottom() || newB.IsBottom())
+    {
+        state.isReachable = false;
+        return;
+    }
+
+    auto *pLeftVar = dynamic_cast<CVariableRefAST *>(&left);
+    if (pLeftVar && m_candidates.count(pLeftVar->GetNameId()))
+    {
+        state.variables[pLeftVar->GetNameId()] = newA;
+    }
+    auto *pRightVar = dynamic_cast<CVariableRefAST *>(&right);
+    if (pRightVar && m_candidates.count(pRightVar->GetNameId()))
+    {
+        state.variables[pRightVar->GetNameId()] = newB;
+    }
+}
+
+// Выполняет тело цикла из состояния state и возвращает состояние перед проверкой условия.
+// Состояния перед break в этом проходе тела собираются в m_loops.back().breakState.
+CRangeAnalysis::State CRangeAnalysis::ExecuteLoopBody(const State &state, const StatementsList &body)
+{
+    LoopExits &loop = m_loops.back();
+    loop.breakState.isReachable = false;
+    loop.continueState.isReachable = false;
+    m_state = state;
+    Execute(body);
+    return Join(m_state, m_loops.back().continueState);
+}
+
+CRangeAnalysis::State CRangeAnalysis::Join(const State &a, const State &b) const
+{
+    if (!a.isReachable)
+    {
+        return b;
+    }
+    if (!b.isReachable)
+    {
+        return a;
+    }
+    State result = a;
+    for (const auto &pair : b.variables)
+    {
+        result.variables[pair.first] = JoinRanges(result.variables[pair.first], pair.second);
+    }
+    return result;
+}
+
+CRangeAnalysis::State CRangeAnalysis::Widen(const State &previous, const State &next) const
+{
+    if (!previous.isReachable || !next.isReachable)
+    {
+        return next;
+    }
+    State result = next;
+    for (auto &pair : result.variables)
+    {
+        auto it = previous.variables.find(pair.first);
+        if (it != previous.variables.end())
+        {
+            pair.second = WidenRange(it->second, pair.second);
+        }
+    }
+    return result;
+}
+
+void CRangeAnalysis::Record(IExpressionAST &expr, const IntegerRange &value)
+{
+    if (m_silenceDepth == 0)
+    {
+        IntegerRange &recorded = m_ranges[&expr];
+        recorded = JoinRanges(recorded, value);
+    }
+}
@@ -0,0 +1,110 @@
+#pragma once
+
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+#include "ASTVisitor.h"
+#include "AST.h"
+
+// Результат анализа диапазонов значений для одной функции.
+struct NumberNarrowing
+{
+    // Локальные переменные типа Number, которые всегда хранят целые числа
+    //  и поэтому могут храниться в 64-битных целых.
+    std::unordered_set<unsigned> variables;
+    // Выражения типа Number, которые можно вычислять в 64-битных целых
+    //  без изменения результата.
+    std::unordered_set<const IExpressionAST *> expressions;
+};
+
+// Абстрактное значение выражения типа Number:
+//  - bottom: значение не вычислялось (код недостижим или переменная не присвоена),
+//  - отрезок [low, high] целых чисел, границы могут быть бесконечными,
+//  - top: значение может оказаться дробным, NaN или отрицательным нулём.
+struct IntegerRange
+{
+    static IntegerRange Bottom();
+    static IntegerRange Top();
+    static IntegerRange Interval(double low, double high);
+
+    bool IsBottom()const;
+    bool IsTop()const;
+    // Обе границы конечны, все значения точно представимы в double и в i64.
+    bool IsBounded()const;
+    bool Contains(double value)const;
+    bool operator ==(const IntegerRange &other)const;
+    bool operator !=(const IntegerRange &other)const;
+
+    bool isBottom = true;
+    bool isTop = false;
+    double low = 0;
+    double high = 0;
+};
+
+// Доказывает, что переменная типа Number хранит только целые числа,
+//  которые точно представимы и в double, и в i64.
+// Анализ выполняется абстрактной интерпретацией AST функции:
+//  циклы обрабатываются с расширением (widening) границ до бесконечности
+//  и последующим сужением по условию цикла.
+class CRangeAnalysis
+        : protected IStatementVisitor
+        , protected IExpressionVisitor
+{
+public:
+    NumberNarrowing Analyze(IFunctionAST &ast);
+
+protected:
+    void Visit(CPrintAST &ast) override;
+    void Visit(CAssignAST &ast) override;
+    void Visit(CReturnAST &ast) override;
+    void Visit(CLoopJumpAST &ast) override;
+    void Visit(CWhileAst &ast) override;
+    void Visit(CRepeatAst &ast) override;
+    void Visit(CIfAst &ast) override;
+
+    void Visit(CBinaryExpressionAST &expr) override;
+    void Visit(CUnaryExpressionAST &expr) override;
+    void Visit(CLiteralAST &expr) override;
+    void Visit(CCallAST &expr) override;
+    void Visit(CVariableRefAST &expr) override;
+    void Visit(CParameterDeclAST &expr) override;
+    void Visit(CConversionAST &expr) override;
+    void Visit(CSliceAST &expr) override;
+
+private:
+    // Состояние абстрактного интерпретатора в точке программы.
+    struct State
+    {
+        bool isReachable = true;
+        std::unordered_map<unsigned, IntegerRange> variables;
+
+        bool operator ==(const State &other)const;
+    };
+
+    // Состояния в точках назначения break и continue цикла.
+    struct LoopExits
+    {
+        State breakState;
+        State continueState;
+    };
+
+    void Execute(const StatementsList &statements);
+    State ExecuteLoopBody(const State &state, const StatementsList &body);
+    IntegerRange Evaluate(IExpressionAST &expr);
+    IntegerRange EvaluateSilently(IExpressionAST &expr);
+    State Refine(const State &state, IExpressionAST &condition, bool isTrue);
+    void RefineLess(State &state, IExpressionAST &left, IExpressionAST &right, bool isTrue);
+    void RefineEquals(State &state, IExpressionAST &left, IExpressionAST &right);
+    State Join(const State &a, const State &b)const;
+    State Widen(const State &previous, const State &next)const;
+    void Record(IExpressionAST &expr, const IntegerRange &value);
+
+    std::unordered_set<unsigned> m_candidates;
+    std::unordered_map<const IExpressionAST *, IntegerRange> m_ranges;
+    std::vector<IntegerRange> m_values;
+    State m_state;
+    std::vector<LoopExits> m_loops;
+    // Пока счётчик больше нуля, результаты вычислений не сохраняются:
+    //  итерации цикла до достижения неподвижной точки дают неокончательные диапазоны.
+    unsigned m_silenceDepth = 0;
+};
@@ -0,0 +1,236 @@
+#include "StringLivenessAnalysis.h"
+#include <algorithm>
+#include <iterator>
+
+DeadStrings CStringLivenessAnalysis::Analyze(IFunctionAST &ast, const std::set<unsigned> &variables)
+{
+    m_pVariables = &variables;
+    m_live.clear();
+    m_loops.clear();
+    m_deadStrings.clear();
+    Execute(ast.GetBody());
+    return std::move(m_deadStrings);
+}
+
+void CStringLivenessAnalysis::Visit(CPrintAST &ast)
+{
+    AddUses(ast.GetValue());
+}
+
+void CStringLivenessAnalysis::Visit(CAssignAST &ast)
+{
+    // Присваивание затирает старое значение, но `x = x + y` его читает.
+    m_live.erase(ast.GetNameId());
+    if (!m_loops.empty() && m_pVariables->count(ast.GetNameId()))
+    {
+        m_loops.back().touched.insert(ast.GetNameId());
+    }
+    AddUses(ast.GetValue());
+}
+
+// После return значения всех переменных освобождаются при выходе из функции.
+void CStringLivenessAnalysis::Visit(CReturnAST &ast)
+{
+    m_live.clear();
+    AddUses(ast.GetValue());
+}
+
+// После break живы переменные, живые после цикла, после continue - живые перед проверкой условия.
+void CStringLivenessAnalysis::Visit(CLoopJumpAST &ast)
+{
+    LoopTargets &loop = m_loops.back();
+    loop.jumps.insert(&ast);
+    m_live = (ast.GetKind() == LoopJump::Break) ? loop.breakLive : loop.continueLive;
+}
+
+// Условие проверяется перед каждой итерацией и после последней из них.
+void CStringLivenessAnalysis::Visit(CWhileAst &ast)
+{
+    const VariableSet liveOut = m_live;
+    m_loops.push_back(LoopTargets());
+    m_loops.back().breakLive = liveOut;
+    VariableSet head;
+    do
+    {
+        head = m_live;
+        m_loops.back().continueLive = head;
+        VariableSet bodyIn = ExecuteBody(ast.GetBody(), head);
+        m_live = liveOut;
+        m_live.insert(bodyIn.begin(), bodyIn.end());
+        AddUses(ast.GetCondition());
+    }
+    while (m_live != head);
+    PopLoop();
+}
+
+// Тело выполняется до первой проверки условия.
+void CStringLivenessAnalysis::Visit(CRepeatAst &ast)
+{
+    const VariableSet liveOut = m_live;
+    m_loops.push_back(LoopTargets());
+    m_loops.back().breakLive = liveOut;
+    VariableSet bodyIn;
+    bool changed = true;
+    while (changed)
+    {
+        m_live = liveOut;
+        m_live.insert(bodyIn.begin(), bodyIn.end());
+        AddUses(ast.GetCondition());
+        m_loops.back().continueLive = m_live;
+        VariableSet newBodyIn = ExecuteBody(ast.GetBody(), m_live);
+        changed = (newBodyIn != bodyIn);
+        bodyIn = std::move(newBodyIn);
+    }
+    m_live = std::move(bodyIn);
+    PopLoop();
+}
+
+void CStringLivenessAnalysis::Visit(CIfAst &ast)
+{
+    const VariableSet liveOut = m_live;
+    VariableSet thenIn = ExecuteBody(ast.GetThenBody(), liveOut);
+    m_live = ExecuteBody(ast.GetElseBody(), liveOut);
+    m_live.insert(thenIn.begin(), thenIn.end());
+    AddUses(ast.GetCondition());
+}
+
+void CStringLivenessAnalysis::Visit(CBinaryExpressionAST &expr)
+{
+    expr.GetLeft().Accept(*this);
+    expr.GetRight().Accept(*this);
+}
+
+void CStringLivenessAnalysis::Visit(CUnaryExpressionAST &expr)
+{
+    expr.GetOperand().Accept(*this);
+}
+
+void CStringLivenessAnalysis::Visit(CLiteralAST &)
+{
+}
+
+void CStringLivenessAnalysis::Visit(CCallAST &expr)
+{
+    for (const auto &pArg : expr.GetArguments())
+    {
+        pArg->Accept(*this);
+    }
+}
+
+void CStringLivenessAnalysis::Visit(CVariableRefAST &expr)
+{
+    if (m_pVariables->count(expr.GetNameId()))
+    {
+        m_live.insert(expr.GetNameId());
+        if (!m_loops.empty())
+        {
+            m_loops.back().touched.insert(expr.GetNameId());
+        }
+    }
+}
+
+void CStringLivenessAnalysis::Visit(CParameterDeclAST &)
+{
+}
+
+void CStringLivenessAnalysis::Visit(CConversionAST &expr)
+{
+    expr.GetOperand().Accept(*this);
+}
+
+void CStringLivenessAnalysis::Visit(CSliceAST &expr)
+{
+    expr.GetOperand().Accept(*this);
+    for (IExpressionAST *pBound : {expr.GetBegin(), expr.GetEnd()})
+    {
+        if (pBound)
+        {
+            pBound->Accept(*this);
+        }
+    }
+}
+
+// Переменная умирает после оператора, если она была жива перед ним
+//  или получила в нём значение, но не жива после него.
+// Вложенные списки операторов отмечают смерть своих переменных сами,
+//  а повторное освобождение уже освобождённой переменной ничего не делает.
+void CStringLivenessAnalysis::Execute(const StatementsList &statements)
+{
+    for (auto it = statements.rbegin(); it != statements.rend(); ++it)
+    {
+        const VariableSet liveOut = m_live;
+        (*it)->Accept(*this);
+        if (dynamic_cast<CLoopJumpAST *>(it->get()))
+        {
+            // Строки перехода отмечает PopLoop.
+            continue;
+        }
+        VariableSet dead;
+        auto addDead = [&](unsigned nameId) {
+            if (!liveOut.count(nameId))
+            {
+                dead.insert(nameId);
+            }
+        };
+        for (unsigned nameId : m_live)
+        {
+            addDead(nameId);
+        }
+        if (auto *pAssign = dynamic_cast<CAssignAST *>(it->get()))
+        {
+            if (m_pVariables->count(pAssign->GetNameId()))
+            {
+                addDead(pAssign->GetNameId());
+            }
+        }
+        if (dead.empty())
+        {
+            m_deadStrings.erase(it->get());
+        }
+        else
+        {
+            m_deadStrings[it->get()] = std::move(dead);
+        }
+    }
+}
+
+CStringLivenessAnalysis::VariableSet CStringLivenessAnalysis::ExecuteBody(const StatementsList &statements,
+                                                                         const VariableSet &liveOut)
+{
+    m_live = liveOut;
+    Execute(statements);
+    return m_live;
+}
+
+void CStringLivenessAnalysis::AddUses(IExpressionAST &expr)
+{
+    expr.Accept(*this);
+}
+
+// Переход минует освобождение строк в конце объемлющих операторов,
+//  поэтому сам освобождает переменные цикла, которые не живы в точке назначения.
+// Освобождённая раньше переменная хранит пустую строку, и её повторное освобождение ничего не делает.
+void CStringLivenessAnalysis::PopLoop()
+{
+    LoopTargets loop = std::move(m_loops.back());
+    m_loops.pop_back();
+    for (const CLoopJumpAST *pJump : loop.jumps)
+    {
+        const VariableSet &target = (pJump->GetKind() == LoopJump::Break) ? loop.breakLive : loop.continueLive;
+        VariableSet dead;
+        std::set_difference(loop.touched.begin(), loop.touched.end(), target.begin(), target.end(),
+                            std::inserter(dead, dead.end()));
+        if (dead.empty())
+        {
+            m_deadStrings.erase(pJump);
+        }
+        else
+        {
+            m_deadStrings[pJump] = std::move(dead);
+        }
+    }
+    if (!m_loops.empty())
+    {
+        m_loops.back().touched.insert(loop.touched.begin(), loop.touched.end());
+    }
+}
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <set>
+#include <unordered_map>
+#include <vector>
+#include "ASTVisitor.h"
+#include "AST.h"
+
+// Строковые переменные, значения которых больше не используются после оператора:
+//  их можно освободить сразу, не дожидаясь выхода из функции.
+using DeadStrings = std::unordered_map<const IStatementAST *, std::set<unsigned>>;
+
+// Анализ живости строковых переменных, которые владеют своим значением.
+// Выполняется обратным проходом по AST функции: переменная жива в точке,
+//  если её текущее значение может быть прочитано дальше по какому-либо пути.
+// Для циклов множество живых переменных на входе вычисляется до неподвижной точки,
+//  поэтому значение, переживающее итерацию, не освобождается внутри цикла.
+class CStringLivenessAnalysis
+        : protected IStatementVisitor
+        , protected IExpressionVisitor
+{
+public:
+    // variables - переменные, которые владеют своим значением.
+    DeadStrings Analyze(IFunctionAST &ast, const std::set<unsigned> &variables);
+
+protected:
+    void Visit(CPrintAST &ast) override;
+    void Visit(CAssignAST &ast) override;
+    void Visit(CReturnAST &ast) override;
+    void Visit(CLoopJumpAST &ast) override;
+    void Visit(CWhileAst &ast) override;
+    void Visit(CRepeatAst &ast) override;
+    void Visit(CIfAst &ast) override;
+
+    void Visit(CBinaryExpressionAST &expr) override;
+    void Visit(CUnaryExpressionAST &expr) override;
+    void Visit(CLiteralAST &expr) override;
+    void Visit(CCallAST &expr) override;
+    void Visit(CVariableRefAST &expr) override;
+    void Visit(CParameterDeclAST &expr) override;
+    void Visit(CConversionAST &expr) override;
+    void Visit(CSliceAST &expr) override;
+
+private:
+    using VariableSet = std::set<unsigned>;
+
+    // Точки назначения break и continue цикла.
+    struct LoopTargets
+    {
+        // Живые после цикла.
+        VariableSet breakLive;
+        // Живые перед проверкой условия.
+        VariableSet continueLive;
+        // Переменные, которые читаются или присваиваются в цикле.
+        VariableSet touched;
+        std::set<const CLoopJumpAST *> jumps;
+    };
+
+    // Переводит m_live из множества живых после операторов в множество живых перед ними.
+    void Execute(const StatementsList &statements);
+    VariableSet ExecuteBody(const StatementsList &statements, const VariableSet &liveOut);
+    void AddUses(IExpressionAST &expr);
+    void PopLoop();
+
+    const VariableSet *m_pVariables = nullptr;
+    VariableSet m_live;
+    std::vector<LoopTargets> m_loops;
+    DeadStrings m_deadStrings;
+};
@@ -0,0 +1,78 @@
+#include "StringVariablesAnalysis.h"
+
+StringVariables CStringVariablesAnalysis::Analyze(IFunctionAST &ast)
+{
+    m_variables = StringVariables();
+    Execute(ast.GetBody());
+    return std::move(m_variables);
+}
+
+// Самый левый операнд цепочки конкатенаций совпадает с присваиваемой переменной.
+bool CStringVariablesAnalysis::IsSelfAppend(CAssignAST &ast)
+{
+    IExpressionAST *pExpr = &ast.GetValue();
+    auto *pConcat = dynamic_cast<CBinaryExpressionAST *>(pExpr);
+    if (!pConcat || pConcat->GetType() != ExpressionType::String)
+    {
+        return false;
+    }
+    while (auto *pBinary = dynamic_cast<CBinaryExpressionAST *>(pExpr))
+    {
+        if (pBinary->GetType() != ExpressionType::String)
+        {
+            break;
+        }
+        pExpr = &pBinary->GetLeft();
+    }
+    auto *pVar = dynamic_cast<CVariableRefAST *>(pExpr);
+    return pVar && (pVar->GetNameId() == ast.GetNameId());
+}
+
+void CStringVariablesAnalysis::Visit(CPrintAST &)
+{
+}
+
+void CStringVariablesAnalysis::Visit(CAssignAST &ast)
+{
+    if (ast.GetValue().GetType() != ExpressionType::String)
+    {
+        return;
+    }
+    m_variables.assigned.insert(ast.GetNameId());
+    if (IsSelfAppend(ast))
+    {
+        m_variables.appended.insert(ast.GetNameId());
+    }
+}
+
+void CStringVariablesAnalysis::Visit(CReturnAST &)
+{
+}
+
+void CStringVariablesAnalysis::Visit(CLoopJumpAST &)
+{
+}
+
+void CStringVariablesAnalysis::Visit(CWhileAst &ast)
+{
+    Execute(ast.GetBody());
+}
+
+void CStringVariablesAnalysis::Visit(CRepeatAst &ast)
+{
+    Execute(ast.GetBody());
+}
+
+void CStringVariablesAnalysis::Visit(CIfAst &ast)
+{
+    Execute(ast.GetThenBody());
+    Execute(ast.GetElseBody());
+}
+
+void CStringVariablesAnalysis::Execute(const StatementsList &statements)
+{
+    for (const auto &pStmt : statements)
+    {
+        pStmt->Accept(*this);
+    }
+}
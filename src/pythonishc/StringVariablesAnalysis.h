@@ -0,0 +1,39 @@
+#pragma once
+
+#include <set>
+#include "ASTVisitor.h"
+#include "AST.h"
+
+// Строковые переменные функции, которым присваиваются значения.
+struct StringVariables
+{
+    // Переменные, которым присваивается строка, включая параметры.
+    std::set<unsigned> assigned;
+    // Переменные, которые дописываются присваиванием вида `x = x + y`:
+    //  они хранят строку в буфере с запасом ёмкости.
+    std::set<unsigned> appended;
+};
+
+// Находит строковые переменные, которые владеют своим значением.
+class CStringVariablesAnalysis : protected IStatementVisitor
+{
+public:
+    StringVariables Analyze(IFunctionAST &ast);
+
+    // Возвращает true, если присваивание дописывает строку в конец переменной.
+    static bool IsSelfAppend(CAssignAST &ast);
+
+protected:
+    void Visit(CPrintAST &ast) override;
+    void Visit(CAssignAST &ast) override;
+    void Visit(CReturnAST &ast) override;
+    void Visit(CLoopJumpAST &ast) override;
+    void Visit(CWhileAst &ast) override;
+    void Visit(CRepeatAst &ast) override;
+    void Visit(CIfAst &ast) override;
+
+private:
+    void Execute(const StatementsList &statements);
+
+    StringVariables m_variables;
+};
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <cstdint>
+
 struct Token
 {
     unsigned line;
@@ -8,6 +10,7 @@ struct Token
         // Id in CStringPool object. Always 0 for most tokens.
         unsigned stringId;
         double value;
+        int64_t intValue;
         bool boolValue;
     };
 };
@@ -1,5 +1,6 @@
 #include "TypecheckVisitor.h"
 #include "FrontendContext.h"
+#include "Builtins.h"
 #include <boost/range/algorithm.hpp>
 
 namespace
@@ -14,6 +15,8 @@ std::string PrettyPrint(ExpressionType type)
         return "Number";
     case ExpressionType::String:
         return "String";
+    case ExpressionType::Int:
+        return "Int";
     }
     throw std::logic_error("cannot print unknown type name");
 }
@@ -26,6 +29,18 @@ std::string PrettyPrint(BinaryOperation op)
         return "<";
     case BinaryOperation::Equals:
         return "==";
+    case BinaryOperation::NotEquals:
+        return "!=";
+    case BinaryOperation::Greater:
+        return ">";
+    case BinaryOperation::LessOrEquals:
+        return "<=";
+    case BinaryOperation::GreaterOrEquals:
+        return ">=";
+    case BinaryOperation::And:
+        return "and";
+    case BinaryOperation::Or:
+        return "or";
     case BinaryOperation::Add:
         return "+";
     case BinaryOperation::Substract:
@@ -36,6 +51,16 @@ std::string PrettyPrint(BinaryOperation op)
         return "/";
     case BinaryOperation::Modulo:
         return "%";
+    case BinaryOperation::BitwiseAnd:
+        return "&";
+    case BinaryOperation::BitwiseOr:
+        return "|";
+    case BinaryOperation::BitwiseXor:
+        return "^";
+    case BinaryOperation::ShiftLeft:
+        return "<<";
+    case BinaryOperation::ShiftRight:
+        return ">>";
     }
     return "?";
 }
@@ -48,10 +73,97 @@ std::string PrettyPrint(UnaryOperation op)
         return "-";
     case UnaryOperation::Plus:
         return "+";
+    case UnaryOperation::BitwiseNot:
+        return "~";
+    case UnaryOperation::LogicalNot:
+        return "not";
     }
     return "?";
 }
 
+bool IsArithmetic(ExpressionType type)
+{
+    return (type == ExpressionType::Number) || (type == ExpressionType::Int);
+}
+
+// Выражение из целочисленных констант без типа, например `10`, `-1` или `60 * 60`.
+// Деление не допускается: его результат в Number может оказаться дробным.
+bool IsUntypedIntegerConstant(IExpressionAST &expr)
+{
+    if (auto *pLiteral = dynamic_cast<CLiteralAST *>(&expr))
+    {
+        return pLiteral->IsUntypedInteger();
+    }
+    if (auto *pUnary = dynamic_cast<CUnaryExpressionAST *>(&expr))
+    {
+        const UnaryOperation op = pUnary->GetOperation();
+        return (op == UnaryOperation::Plus || op == UnaryOperation::Minus)
+                && IsUntypedIntegerConstant(pUnary->GetOperand());
+    }
+    if (auto *pBinary = dynamic_cast<CBinaryExpressionAST *>(&expr))
+    {
+        switch (pBinary->GetOperation())
+        {
+        case BinaryOperation::Add:
+        case BinaryOperation::Substract:
+        case BinaryOperation::Multiply:
+        case BinaryOperation::Modulo:
+            return IsUntypedIntegerConstant(pBinary->GetLeft()) && IsUntypedIntegerConstant(pBinary->GetRight());
+        default:
+            return false;
+        }
+    }
+    return false;
+}
+
+// Целочисленная константа или выражение из них получает тип Int,
+//  если встречено в контексте Int, например `i < 60 * 60` или `-1` для параметра Int.
+bool CoerceToInt(IExpressionAST &expr)
+{
+    if (!IsUntypedIntegerConstant(expr))
+    {
+        return false;
+    }
+    if (auto *pLiteral = dynamic_cast<CLiteralAST *>(&expr))
+    {
+        pLiteral->SetIntegerType(ExpressionType::Int);
+    }
+    else if (auto *pUnary = dynamic_cast<CUnaryExpressionAST *>(&expr))
+    {
+        CoerceToInt(pUnary->GetOperand());
+        pUnary->SetType(ExpressionType::Int);
+    }
+    else if (auto *pBinary = dynamic_cast<CBinaryExpressionAST *>(&expr))
+    {
+        CoerceToInt(pBinary->GetLeft());
+        CoerceToInt(pBinary->GetRight());
+        pBinary->SetType(ExpressionType::Int);
+    }
+    return true;
+}
+
+bool IsBitwise(BinaryOperation op)
+{
+    switch (op)
+    {
+    case BinaryOperation::BitwiseAnd:
+    case BinaryOperation::BitwiseOr:
+    case BinaryOperation::BitwiseXor:
+    case BinaryOperation::ShiftLeft:
+    case BinaryOperation::ShiftRight:
+        return true;
+    default:
+        return false;
+    }
+}
+
+// Допустимы преобразования Int <-> Number и преобразование в собственный тип.
+bool CanConvert(ExpressionType from, ExpressionType to)
+{
+    // В строку преобразуется любое значение: `String(x)` даёт тот же текст, что и `print x`.
+    return (from == to) || (IsArithmetic(from) && IsArithmetic(to)) || (to == ExpressionType::String);
+}
+
 ExpressionType EvaluateBinaryOperationType(BinaryOperation op, ExpressionType left, ExpressionType right)
 {
     auto check = [&](bool condition) {
@@ -66,8 +178,16 @@ ExpressionType EvaluateBinaryOperationType(BinaryOperation op, ExpressionType le
     {
     case BinaryOperation::Less:
     case BinaryOperation::Equals:
+    case BinaryOperation::NotEquals:
+    case BinaryOperation::Greater:
+    case BinaryOperation::LessOrEquals:
+    case BinaryOperation::GreaterOrEquals:
         check(left == right);
         return ExpressionType::Boolean;
+    case BinaryOperation::And:
+    case BinaryOperation::Or:
+        check(left == ExpressionType::Boolean && right == ExpressionType::Boolean);
+        return ExpressionType::Boolean;
     case BinaryOperation::Add:
         check(left == right && left != ExpressionType::Boolean);
         return left;
@@ -75,8 +195,15 @@ ExpressionType EvaluateBinaryOperationType(BinaryOperation op, ExpressionType le
     case BinaryOperation::Multiply:
     case BinaryOperation::Divide:
     case BinaryOperation::Modulo:
-        check(left == right && left == ExpressionType::Number);
-        return ExpressionType::Number;
+        check(left == right && IsArithmetic(left));
+        return left;
+    case BinaryOperation::BitwiseAnd:
+    case BinaryOperation::BitwiseOr:
+    case BinaryOperation::BitwiseXor:
+    case BinaryOperation::ShiftLeft:
+    case BinaryOperation::ShiftRight:
+        check(left == right && left == ExpressionType::Int);
+        return ExpressionType::Int;
     }
     throw std::logic_error("GetBinaryOperationResultType() not implemented for this type");
 }
@@ -95,8 +222,14 @@ ExpressionType EvaluateUnaryOperationType(UnaryOperation op, ExpressionType oper
     {
     case UnaryOperation::Minus:
     case UnaryOperation::Plus:
-        check(operandType == ExpressionType::Number);
-        return ExpressionType::Number;
+        check(IsArithmetic(operandType));
+        return operandType;
+    case UnaryOperation::BitwiseNot:
+        check(operandType == ExpressionType::Int);
+        return ExpressionType::Int;
+    case UnaryOperation::LogicalNot:
+        check(operandType == ExpressionType::Boolean);
+        return ExpressionType::Boolean;
     }
     throw std::logic_error("GetUnaryOperationResultType() not implemented for this type");
 }
@@ -116,16 +249,44 @@ ExpressionType CTypeEvaluator::EvaluateTypes(IExpressionAST &expr)
     return expr.GetType();
 }
 
+ExpressionType CTypeEvaluator::EvaluateTypes(IExpressionAST &expr, ExpressionType expectedType)
+{
+    expr.Accept(*this);
+    if (expectedType == ExpressionType::Int && expr.GetType() == ExpressionType::Number)
+    {
+        CoerceToInt(expr);
+    }
+    return expr.GetType();
+}
+
 void CTypeEvaluator::Visit(CBinaryExpressionAST &expr)
 {
     expr.GetLeft().Accept(*this);
     expr.GetRight().Accept(*this);
+    // Битовые операции определены только для Int.
+    if (IsBitwise(expr.GetOperation()))
+    {
+        CoerceToInt(expr.GetLeft());
+        CoerceToInt(expr.GetRight());
+    }
+    else if (expr.GetLeft().GetType() == ExpressionType::Int)
+    {
+        CoerceToInt(expr.GetRight());
+    }
+    else if (expr.GetRight().GetType() == ExpressionType::Int)
+    {
+        CoerceToInt(expr.GetLeft());
+    }
     expr.SetType(EvaluateBinaryOperationType(expr.GetOperation(), expr.GetLeft().GetType(), expr.GetRight().GetType()));
 }
 
 void CTypeEvaluator::Visit(CUnaryExpressionAST &expr)
 {
     expr.GetOperand().Accept(*this);
+    if (expr.GetOperation() == UnaryOperation::BitwiseNot)
+    {
+        CoerceToInt(expr.GetOperand());
+    }
     expr.SetType(EvaluateUnaryOperationType(expr.GetOperation(), expr.GetOperand().GetType()));
 }
 
@@ -138,32 +299,48 @@ void CTypeEvaluator::Visit(CCallAST &expr)
 {
     const unsigned functionNameId = expr.GetFunctionNameId();
     const auto functionOpt = m_functionsRef.GetSymbol(functionNameId);
-    if (!functionOpt)
+    std::string fnName = m_context.GetString(functionNameId);
+    std::vector<ExpressionType> paramTypes;
+    ExpressionType returnType;
+    if (functionOpt)
+    {
+        IFunctionAST &function = **functionOpt;
+        for (const auto &pParam : function.GetParameters())
+        {
+            paramTypes.push_back(pParam->GetType());
+        }
+        returnType = function.GetReturnType();
+    }
+    else if (const BuiltinSignature *pBuiltin = FindBuiltinCall(fnName))
+    {
+        paramTypes = pBuiltin->parameters;
+        returnType = pBuiltin->returnType;
+    }
+    else
     {
-        std::string fnName = m_context.GetString(functionNameId);
         throw std::logic_error("function " + fnName + " is undefined");
     }
-    IFunctionAST &function = **functionOpt;
-    const ParameterDeclList &params = function.GetParameters();
     const ExpressionList &args = expr.GetArguments();
-    if (params.size() != args.size())
+    if (paramTypes.size() != args.size())
     {
-        std::string fnName = m_context.GetString(functionNameId);
-        throw std::logic_error("function " + fnName + " requires " + std::to_string(params.size())
+        throw std::logic_error("function " + fnName + " requires " + std::to_string(paramTypes.size())
                                + " arguments, while " + std::to_string(args.size()) + " provided");
     }
     std::vector<ExpressionType> argTypes = EvaluateArgumentTypes(expr);
     for (size_t i = 0; i < argTypes.size(); ++i)
     {
-        ExpressionType expectedType = params.at(i)->GetType();
-        if (argTypes.at(i) != params.at(i)->GetType())
+        ExpressionType expectedType = paramTypes.at(i);
+        if (expectedType == ExpressionType::Int && CoerceToInt(*args.at(i)))
+        {
+            argTypes.at(i) = ExpressionType::Int;
+        }
+        if (argTypes.at(i) != expectedType)
         {
-            std::string fnName = m_context.GetString(functionNameId);
             throw std::logic_error("function " + fnName + " expects " + PrettyPrint(expectedType)
                                    + " in the " + std::to_string(i) + " parameter");
         }
     }
-    expr.SetType(function.GetReturnType());
+    expr.SetType(returnType);
 }
 
 void CTypeEvaluator::Visit(CVariableRefAST &expr)
@@ -184,6 +361,32 @@ void CTypeEvaluator::Visit(CParameterDeclAST &)
     // Parameter type is known at parsing time.
 }
 
+void CTypeEvaluator::Visit(CConversionAST &expr)
+{
+    // Target type is known at parsing time.
+    const ExpressionType targetType = expr.GetType();
+    const ExpressionType operandType = EvaluateTypes(expr.GetOperand(), targetType);
+    if (!CanConvert(operandType, targetType))
+    {
+        throw std::logic_error("Cannot convert " + PrettyPrint(operandType) + " to " + PrettyPrint(targetType));
+    }
+}
+
+void CTypeEvaluator::Visit(CSliceAST &expr)
+{
+    if (EvaluateTypes(expr.GetOperand()) != ExpressionType::String)
+    {
+        throw std::logic_error("only String can be sliced");
+    }
+    for (IExpressionAST *pBound : {expr.GetBegin(), expr.GetEnd()})
+    {
+        if (pBound && EvaluateTypes(*pBound, ExpressionType::Int) != ExpressionType::Int)
+        {
+            throw std::logic_error("slice bounds must be Int");
+        }
+    }
+}
+
 std::vector<ExpressionType> CTypeEvaluator::EvaluateArgumentTypes(CCallAST &expr)
 {
     std::vector<ExpressionType> argTypes;
@@ -229,6 +432,7 @@ void CTypecheckVisitor::CheckTypes(IFunctionAST &ast)
 {
     m_variableTypes.PushScope();
     m_returnType = ast.GetReturnType();
+    m_loopDepth = 0;
     for (const auto &pParam : ast.GetParameters())
     {
         m_variableTypes.DefineSymbol(pParam->GetName(), pParam->GetType());
@@ -247,9 +451,12 @@ void CTypecheckVisitor::Visit(CPrintAST &ast)
 
 void CTypecheckVisitor::Visit(CAssignAST &ast)
 {
-    ExpressionType type = m_evaluator.EvaluateTypes(ast.GetValue());
     unsigned nameId = ast.GetNameId();
-    if (auto typeOpt = m_variableTypes.GetSymbol(nameId))
+    auto typeOpt = m_variableTypes.GetSymbol(nameId);
+    ExpressionType type = typeOpt
+            ? m_evaluator.EvaluateTypes(ast.GetValue(), *typeOpt)
+            : m_evaluator.EvaluateTypes(ast.GetValue());
+    if (typeOpt)
     {
         if (type != *typeOpt)
         {
@@ -265,7 +472,7 @@ void CTypecheckVisitor::Visit(CAssignAST &ast)
 
 void CTypecheckVisitor::Visit(CReturnAST &ast)
 {
-    ExpressionType type = m_evaluator.EvaluateTypes(ast.GetValue());
+    ExpressionType type = m_evaluator.EvaluateTypes(ast.GetValue(), *m_returnType);
     if (type != *m_returnType)
     {
         std::string typeName = PrettyPrint(type);
@@ -273,14 +480,27 @@ void CTypecheckVisitor::Visit(CReturnAST &ast)
     }
 }
 
+void CTypecheckVisitor::Visit(CLoopJumpAST &ast)
+{
+    if (m_loopDepth == 0)
+    {
+        const char *keyword = (ast.GetKind() == LoopJump::Break) ? "break" : "continue";
+        throw std::logic_error(std::string("Cannot use ") + keyword + " outside of loop");
+    }
+}
+
 void CTypecheckVisitor::Visit(CWhileAst &ast)
 {
+    ++m_loopDepth;
     CheckConditionalAstTypes(ast.GetCondition(), ast.GetBody());
+    --m_loopDepth;
 }
 
 void CTypecheckVisitor::Visit(CRepeatAst &ast)
 {
+    ++m_loopDepth;
     CheckConditionalAstTypes(ast.GetCondition(), ast.GetBody());
+    --m_loopDepth;
 }
 
 void CTypecheckVisitor::Visit(CIfAst &ast)
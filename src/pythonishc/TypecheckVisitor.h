@@ -13,6 +13,8 @@ public:
                    CScopeChain<IFunctionAST*> &functionsRef);
 
     ExpressionType EvaluateTypes(IExpressionAST & expr);
+    // То же, но целочисленная константа в месте, где ожидается Int, получает тип Int.
+    ExpressionType EvaluateTypes(IExpressionAST & expr, ExpressionType expectedType);
 
     // IExpressionVisitor interface
 protected:
@@ -22,6 +24,8 @@ protected:
     void Visit(CCallAST &expr) override;
     void Visit(CVariableRefAST &expr) override;
     void Visit(CParameterDeclAST &expr) override;
+    void Visit(CConversionAST &expr) override;
+    void Visit(CSliceAST &expr) override;
 
 private:
     std::vector<ExpressionType> EvaluateArgumentTypes(CCallAST &expr);
@@ -49,6 +53,7 @@ protected:
     void Visit(CPrintAST &ast) override;
     void Visit(CAssignAST &ast) override;
     void Visit(CReturnAST &ast) override;
+    void Visit(CLoopJumpAST &ast) override;
     void Visit(CWhileAst &ast) override;
     void Visit(CRepeatAst &ast) override;
     void Visit(CIfAst &ast) override;
@@ -59,5 +64,7 @@ private:
     CScopeChain<ExpressionType> m_variableTypes;
     CScopeChain<IFunctionAST*> m_functions;
     boost::optional<ExpressionType> m_returnType;
+    // Число циклов, объемлющих проверяемый оператор.
+    unsigned m_loopDepth = 0;
     CTypeEvaluator m_evaluator;
 };
@@ -4,11 +4,14 @@
 #include <string>
 #include <boost/program_options.hpp>
 #include <boost/optional.hpp>
+#include <boost/algorithm/string/split.hpp>
+#include <boost/algorithm/string/classification.hpp>
 
 struct CompilerOptions
 {
     std::string inputPath;
     std::string outputPath;
+    CodegenOptions codegen;
 };
 
 boost::optional<CompilerOptions> parse_args(int argc, char* argv[]);
@@ -23,6 +26,7 @@ int main(int argc, char* argv[])
         if (options)
         {
             CCompilerDriver driver(std::cerr);
+            driver.SetCodegenOptions(options->codegen);
             if (!driver.Compile(options->inputPath, options->outputPath))
             {
                 throw std::runtime_error("fatal error: compilation failed");
@@ -47,7 +51,11 @@ boost::optional<CompilerOptions> parse_args(int argc, char* argv[])
     desc.add_options()
         ("help,h", "print usage message")
         ("input,i", value<std::string>(), "pathname for input")
-        ("output,o", value<std::string>()->default_value("program.o"), "pathname for output (optional)");
+        ("output,o", value<std::string>()->default_value("program.o"), "pathname for output (optional)")
+        ("fast-math", value<std::string>()->implicit_value("fast"),
+         "relax IEEE 754 rules for Number operations, comma-separated: reassoc, contract, nnan, ninf, arcp, fast")
+        ("report-narrowing", "report Number variables stored as 64-bit integers")
+        ("libc-malloc", "allocate strings with libc malloc/free instead of the runtime pool");
 
     variables_map vm;
     store(parse_command_line(argc, argv, desc), vm);
@@ -63,6 +71,22 @@ boost::optional<CompilerOptions> parse_args(int argc, char* argv[])
     {
         throw std::runtime_error("missing input file (-i option)");
     }
+    result.codegen.reportNarrowing = (vm.count("report-narrowing") != 0);
+    result.codegen.useLibCAllocator = (vm.count("libc-malloc") != 0);
+    if (vm.count("fast-math"))
+    {
+        std::vector<std::string> names;
+        boost::split(names, vm["fast-math"].as<std::string>(), boost::is_any_of(","));
+        for (const std::string &name : names)
+        {
+            unsigned flag = FastMath::ParseFlag(name);
+            if (flag == FastMath::None)
+            {
+                throw std::runtime_error("unknown --fast-math flag: " + name);
+            }
+            result.codegen.fastMathFlags |= flag;
+        }
+    }
 
     return result;
 }
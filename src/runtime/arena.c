@@ -0,0 +1,100 @@
+#include "runtime.h"
+#include "runtime_private.h"
+#include <stdlib.h>
+
+// Размер блока арены по умолчанию, более крупные выделения получают отдельный блок.
+#define ARENA_CHUNK_SIZE (64 * 1024)
+#define ARENA_ALIGNMENT sizeof(size_t)
+
+typedef struct ArenaChunk
+{
+    struct ArenaChunk *prev;
+    struct ArenaChunk *next;
+    char *end;
+} ArenaChunk;
+
+// Блоки образуют список: блоки до current заняты, блоки после - свободны
+//  и переиспользуются при следующих выделениях.
+typedef struct Arena
+{
+    ArenaChunk *first;
+    ArenaChunk *current;
+    char *top;
+} Arena;
+
+static _Thread_local Arena g_arena;
+
+static char *GetChunkData(ArenaChunk *chunk)
+{
+    return (char *)(chunk + 1);
+}
+
+static size_t GetChunkCapacity(ArenaChunk *chunk)
+{
+    return (size_t)(chunk->end - GetChunkData(chunk));
+}
+
+static void FreeChunks(ArenaChunk *chunk)
+{
+    while (chunk)
+    {
+        ArenaChunk *next = chunk->next;
+        free(chunk);
+        chunk = next;
+    }
+}
+
+// Переходит к следующему блоку, при необходимости выделяя новый.
+static void *AllocateSlow(Arena *arena, size_t size)
+{
+    ArenaChunk **pNext = arena->current ? &arena->current->next : &arena->first;
+    if (*pNext && GetChunkCapacity(*pNext) < size)
+    {
+        // Свободные блоки слишком малы, заменяем их блоком нужного размера.
+        FreeChunks(*pNext);
+        *pNext = NULL;
+    }
+    if (!*pNext)
+    {
+        size_t capacity = (size > ARENA_CHUNK_SIZE) ? size : ARENA_CHUNK_SIZE;
+        ArenaChunk *chunk = pythonish_abort_on_null(malloc(sizeof(ArenaChunk) + capacity));
+        chunk->prev = arena->current;
+        chunk->next = NULL;
+        chunk->end = GetChunkData(chunk) + capacity;
+        *pNext = chunk;
+    }
+    arena->current = *pNext;
+    arena->top = GetChunkData(arena->current) + size;
+    return GetChunkData(arena->current);
+}
+
+void *pythonish_arena_alloc(size_t size)
+{
+    Arena *arena = &g_arena;
+    size = (size + ARENA_ALIGNMENT - 1) & ~(ARENA_ALIGNMENT - 1);
+    if (arena->current && size <= (size_t)(arena->current->end - arena->top))
+    {
+        void *ptr = arena->top;
+        arena->top += size;
+        return ptr;
+    }
+    return AllocateSlow(arena, size);
+}
+
+void *pythonish_arena_mark(void)
+{
+    return g_arena.top;
+}
+
+void pythonish_arena_release(void *mark)
+{
+    Arena *arena = &g_arena;
+    char *top = mark;
+    // Возвращаемся к блоку, которому принадлежит отметка.
+    // Отметка NULL получена до первого выделения и освобождает всю арену.
+    while (arena->current && !(GetChunkData(arena->current) <= top && top <= arena->current->end))
+    {
+        arena->current = arena->current->prev;
+    }
+    arena->top = arena->current ? top : NULL;
+}
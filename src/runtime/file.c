@@ -0,0 +1,339 @@
+// O_CLOEXEC и MAP_ANONYMOUS не входят в ISO C.
+#define _DEFAULT_SOURCE
+#include "runtime.h"
+#include "runtime_private.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// Буфер записи файла. Строка не короче буфера записывается напрямую, минуя его.
+#define FILE_BUFFER_SIZE (256 * 1024)
+// Начальный размер блока для файла, размер которого заранее неизвестен, например, канала.
+#define FILE_READ_CHUNK_SIZE (64 * 1024)
+#define FILE_TABLE_MIN_CAPACITY 8
+
+typedef struct OpenFile
+{
+    // -1 у свободной ячейки таблицы.
+    int fd;
+    int isWritable;
+    // Ошибка записи запоминается до закрытия файла.
+    int hasError;
+    // Буфер записи выделяется при первой записи.
+    char *buffer;
+    size_t size;
+} OpenFile;
+
+// Номер файла в программе - индекс в таблице.
+typedef struct FileTable
+{
+    OpenFile *files;
+    size_t capacity;
+    int isExitHandlerSet;
+} FileTable;
+
+static FileTable g_files;
+
+// Возвращает 0 при ошибке записи.
+static int WriteAll(int fd, const char *data, size_t size)
+{
+    while (size != 0)
+    {
+        ssize_t written = write(fd, data, size);
+        if (written < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            return 0;
+        }
+        data += written;
+        size -= (size_t)written;
+    }
+    return 1;
+}
+
+static void Flush(OpenFile *file)
+{
+    if (file->size != 0 && !WriteAll(file->fd, file->buffer, file->size))
+    {
+        file->hasError = 1;
+    }
+    file->size = 0;
+}
+
+// Файлы, которые программа не закрыла, дописываются при её завершении.
+static void FlushAtExit(void)
+{
+    for (size_t i = 0; i < g_files.capacity; ++i)
+    {
+        if (g_files.files[i].fd >= 0 && g_files.files[i].isWritable)
+        {
+            Flush(&g_files.files[i]);
+        }
+    }
+}
+
+static OpenFile *GetFile(int64_t handle)
+{
+    if (handle < 0 || (uint64_t)handle >= g_files.capacity || g_files.files[handle].fd < 0)
+    {
+        return NULL;
+    }
+    return &g_files.files[handle];
+}
+
+// Возвращает номер свободной ячейки, при необходимости вдвое расширив таблицу.
+static int64_t ReserveSlot(FileTable *table)
+{
+    for (size_t i = 0; i < table->capacity; ++i)
+    {
+        if (table->files[i].fd < 0)
+        {
+            return (int64_t)i;
+        }
+    }
+    const size_t oldCapacity = table->capacity;
+    table->capacity = oldCapacity ? oldCapacity * 2 : FILE_TABLE_MIN_CAPACITY;
+    table->files = pythonish_abort_on_null(realloc(table->files, table->capacity * sizeof(OpenFile)));
+    for (size_t i = oldCapacity; i < table->capacity; ++i)
+    {
+        table->files[i].fd = -1;
+    }
+    if (!table->isExitHandlerSet)
+    {
+        table->isExitHandlerSet = 1;
+        atexit(FlushAtExit);
+    }
+    return (int64_t)oldCapacity;
+}
+
+static int ParseMode(const char *mode, size_t modeLength, int *flags, int *isWritable)
+{
+    if (modeLength != 1)
+    {
+        return 0;
+    }
+    switch (mode[0])
+    {
+    case 'r':
+        *flags = O_RDONLY;
+        *isWritable = 0;
+        return 1;
+    case 'w':
+        *flags = O_WRONLY | O_CREAT | O_TRUNC;
+        *isWritable = 1;
+        return 1;
+    case 'a':
+        *flags = O_WRONLY | O_CREAT | O_APPEND;
+        *isWritable = 1;
+        return 1;
+    default:
+        return 0;
+    }
+}
+
+int64_t pythonish_open(const char *path, size_t pathLength, const char *mode, size_t modeLength)
+{
+    int flags = 0;
+    int isWritable = 0;
+    if (!ParseMode(mode, modeLength, &flags, &isWritable) || pathLength == 0 || memchr(path, '\0', pathLength))
+    {
+        return -1;
+    }
+    char *cPath = pythonish_abort_on_null(malloc(pathLength + 1));
+    memcpy(cPath, path, pathLength);
+    cPath[pathLength] = '\0';
+    int fd;
+    do
+    {
+        fd = open(cPath, flags | O_CLOEXEC, 0666);
+    }
+    while (fd < 0 && errno == EINTR);
+    free(cPath);
+    if (fd < 0)
+    {
+        return -1;
+    }
+    const int64_t handle = ReserveSlot(&g_files);
+    OpenFile *file = &g_files.files[handle];
+    file->fd = fd;
+    file->isWritable = isWritable;
+    file->hasError = 0;
+    file->buffer = NULL;
+    file->size = 0;
+    return handle;
+}
+
+int pythonish_write_file(int64_t handle, const char *data, size_t length)
+{
+    OpenFile *file = GetFile(handle);
+    if (!file || !file->isWritable)
+    {
+        return 0;
+    }
+    if (FILE_BUFFER_SIZE - file->size < length)
+    {
+        Flush(file);
+    }
+    if (length >= FILE_BUFFER_SIZE)
+    {
+        if (!WriteAll(file->fd, data, length))
+        {
+            file->hasError = 1;
+        }
+    }
+    else if (length != 0)
+    {
+        if (!file->buffer)
+        {
+            file->buffer = pythonish_abort_on_null(malloc(FILE_BUFFER_SIZE));
+        }
+        memcpy(file->buffer + file->size, data, length);
+        file->size += length;
+    }
+    return !file->hasError;
+}
+
+int pythonish_write_file_line(int64_t handle, const char *data, size_t length)
+{
+    return pythonish_write_file(handle, data, length) && pythonish_write_file(handle, "\n", 1);
+}
+
+int pythonish_close(int64_t handle)
+{
+    OpenFile *file = GetFile(handle);
+    if (!file)
+    {
+        return 0;
+    }
+    if (file->isWritable)
+    {
+        Flush(file);
+    }
+    // В Linux дескриптор закрыт, даже если close прерван сигналом.
+    int isOk = !file->hasError && (close(file->fd) == 0 || errno == EINTR);
+    free(file->buffer);
+    file->buffer = NULL;
+    file->fd = -1;
+    return isOk;
+}
+
+static void MakeInlineString(const char *data, size_t length, PythonishString *str)
+{
+    unsigned char bytes[sizeof(PythonishString)] = {0};
+    if (length != 0)
+    {
+        memcpy(bytes, data, length);
+    }
+    bytes[sizeof(bytes) - 1] = (unsigned char)(0x80 | length);
+    memcpy(str, bytes, sizeof(bytes));
+}
+
+/*
+ * Отображает файл в память сразу после страницы заголовка:
+ *  [начало отображения][его длина][PYTHONISH_MAPPED_BLOCK][счётчик ссылок = 1][байты файла...]
+ * Страница заголовка доступна для записи, байты файла - только для чтения.
+ * Возвращает байты файла или NULL, если отобразить файл не удалось.
+ */
+static char *MapFile(int fd, size_t size)
+{
+    const size_t pageSize = (size_t)sysconf(_SC_PAGESIZE);
+    const size_t mappingSize = pageSize + size;
+    char *mapping = mmap(NULL, mappingSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (mapping == MAP_FAILED)
+    {
+        return NULL;
+    }
+    char *data = mapping + pageSize;
+    if (mmap(data, size, PROT_READ, MAP_PRIVATE | MAP_FIXED, fd, 0) == MAP_FAILED)
+    {
+        munmap(mapping, mappingSize);
+        return NULL;
+    }
+    size_t *header = (size_t *)data - 4;
+    header[0] = (size_t)mapping;
+    header[1] = mappingSize;
+    header[2] = PYTHONISH_MAPPED_BLOCK;
+    header[3] = 1;
+    return data;
+}
+
+// Читает файл вызовами read(2) в блок строки на capacity байт, который вдвое растёт при заполнении.
+static void ReadToEnd(int fd, size_t capacity, PythonishAllocate allocate, PythonishFree release,
+                      PythonishString *text)
+{
+    size_t *header = pythonish_abort_on_null(allocate(sizeof(size_t) + capacity));
+    size_t length = 0;
+    for (;;)
+    {
+        if (length == capacity)
+        {
+            size_t *grown = pythonish_abort_on_null(allocate(sizeof(size_t) + 2 * capacity));
+            memcpy(grown + 1, header + 1, length);
+            release(header);
+            header = grown;
+            capacity *= 2;
+        }
+        ssize_t count = read(fd, (char *)(header + 1) + length, capacity - length);
+        if (count > 0)
+        {
+            length += (size_t)count;
+            continue;
+        }
+        if (count < 0 && errno == EINTR)
+        {
+            continue;
+        }
+        // Ошибка чтения, как и конец файла, завершает текст.
+        break;
+    }
+    if (length <= PYTHONISH_INLINE_CAPACITY)
+    {
+        MakeInlineString((const char *)(header + 1), length, text);
+        release(header);
+        return;
+    }
+    *header = 1;
+    text->data = (const char *)(header + 1);
+    text->length = length;
+}
+
+void pythonish_read_all(PythonishAllocate allocate, PythonishFree release, int64_t handle, PythonishString *text)
+{
+    OpenFile *file = GetFile(handle);
+    if (!file || file->isWritable)
+    {
+        MakeInlineString(NULL, 0, text);
+        return;
+    }
+    struct stat info;
+    size_t capacity = FILE_READ_CHUNK_SIZE;
+    if (fstat(file->fd, &info) == 0 && S_ISREG(info.st_mode))
+    {
+        off_t position = lseek(file->fd, 0, SEEK_CUR);
+        // Отображённый блок умеет освобождать только pythonish_free, а при malloc/free файл читается в блок строки.
+        if (position == 0 && (size_t)info.st_size > PYTHONISH_INLINE_CAPACITY && allocate == pythonish_alloc)
+        {
+            char *data = MapFile(file->fd, (size_t)info.st_size);
+            if (data)
+            {
+                lseek(file->fd, info.st_size, SEEK_SET);
+                text->data = data;
+                text->length = (size_t)info.st_size;
+                return;
+            }
+        }
+        // Лишний байт позволяет увидеть конец файла известного размера, не расширяя блок.
+        if (position >= 0)
+        {
+            capacity = (position < info.st_size) ? (size_t)(info.st_size - position) + 1 : 1;
+        }
+    }
+    ReadToEnd(file->fd, capacity, allocate, release, text);
+}
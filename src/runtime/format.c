@@ -0,0 +1,519 @@
+#include "runtime.h"
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/*
+ * Кратчайшая запись числа double, которая при чтении даёт то же самое число.
+ * Цифры получаются алгоритмом Grisu3 (F. Loitsch, "Printing Floating-Point
+ *  Numbers Quickly and Accurately with Integers"): число и границы его интервала
+ *  округления умножаются на заранее вычисленную степень 10 в 64-битной арифметике,
+ *  после чего генерируются цифры, пока результат не попадёт в интервал.
+ * Для примерно 0.5% чисел погрешность умножения не позволяет доказать, что запись
+ *  кратчайшая, и тогда она ищется медленно, но точно, через snprintf и strtod.
+ */
+
+// Число с плавающей точкой без ограничений: f * 2^e.
+typedef struct DiyFp
+{
+    uint64_t f;
+    int e;
+} DiyFp;
+
+typedef struct CachedPower
+{
+    uint64_t f;
+    int e;
+} CachedPower;
+
+#define DOUBLE_SIGNIFICAND_SIZE 52
+#define DOUBLE_EXPONENT_BIAS (0x3FF + DOUBLE_SIGNIFICAND_SIZE)
+#define DOUBLE_HIDDEN_BIT ((uint64_t)1 << DOUBLE_SIGNIFICAND_SIZE)
+#define DOUBLE_SIGNIFICAND_MASK (DOUBLE_HIDDEN_BIT - 1)
+#define DOUBLE_EXPONENT_MASK ((uint64_t)0x7FF << DOUBLE_SIGNIFICAND_SIZE)
+
+// Округлённые до 64 бит степени 10^k для k = -348, -340, ..., 340.
+static const CachedPower CACHED_POWERS[] = {
+    {0xfa8fd5a0081c0288ull, -1220}, // 1e-348
+    {0xbaaee17fa23ebf76ull, -1193}, // 1e-340
+    {0x8b16fb203055ac76ull, -1166}, // 1e-332
+    {0xcf42894a5dce35eaull, -1140}, // 1e-324
+    {0x9a6bb0aa55653b2dull, -1113}, // 1e-316
+    {0xe61acf033d1a45dfull, -1087}, // 1e-308
+    {0xab70fe17c79ac6caull, -1060}, // 1e-300
+    {0xff77b1fcbebcdc4full, -1034}, // 1e-292
+    {0xbe5691ef416bd60cull, -1007}, // 1e-284
+    {0x8dd01fad907ffc3cull, -980}, // 1e-276
+    {0xd3515c2831559a83ull, -954}, // 1e-268
+    {0x9d71ac8fada6c9b5ull, -927}, // 1e-260
+    {0xea9c227723ee8bcbull, -901}, // 1e-252
+    {0xaecc49914078536dull, -874}, // 1e-244
+    {0x823c12795db6ce57ull, -847}, // 1e-236
+    {0xc21094364dfb5637ull, -821}, // 1e-228
+    {0x9096ea6f3848984full, -794}, // 1e-220
+    {0xd77485cb25823ac7ull, -768}, // 1e-212
+    {0xa086cfcd97bf97f4ull, -741}, // 1e-204
+    {0xef340a98172aace5ull, -715}, // 1e-196
+    {0xb23867fb2a35b28eull, -688}, // 1e-188
+    {0x84c8d4dfd2c63f3bull, -661}, // 1e-180
+    {0xc5dd44271ad3cdbaull, -635}, // 1e-172
+    {0x936b9fcebb25c996ull, -608}, // 1e-164
+    {0xdbac6c247d62a584ull, -582}, // 1e-156
+    {0xa3ab66580d5fdaf6ull, -555}, // 1e-148
+    {0xf3e2f893dec3f126ull, -529}, // 1e-140
+    {0xb5b5ada8aaff80b8ull, -502}, // 1e-132
+    {0x87625f056c7c4a8bull, -475}, // 1e-124
+    {0xc9bcff6034c13053ull, -449}, // 1e-116
+    {0x964e858c91ba2655ull, -422}, // 1e-108
+    {0xdff9772470297ebdull, -396}, // 1e-100
+    {0xa6dfbd9fb8e5b88full, -369}, // 1e-92
+    {0xf8a95fcf88747d94ull, -343}, // 1e-84
+    {0xb94470938fa89bcfull, -316}, // 1e-76
+    {0x8a08f0f8bf0f156bull, -289}, // 1e-68
+    {0xcdb02555653131b6ull, -263}, // 1e-60
+    {0x993fe2c6d07b7facull, -236}, // 1e-52
+    {0xe45c10c42a2b3b06ull, -210}, // 1e-44
+    {0xaa242499697392d3ull, -183}, // 1e-36
+    {0xfd87b5f28300ca0eull, -157}, // 1e-28
+    {0xbce5086492111aebull, -130}, // 1e-20
+    {0x8cbccc096f5088ccull, -103}, // 1e-12
+    {0xd1b71758e219652cull, -77}, // 1e-4
+    {0x9c40000000000000ull, -50}, // 1e4
+    {0xe8d4a51000000000ull, -24}, // 1e12
+    {0xad78ebc5ac620000ull, 3}, // 1e20
+    {0x813f3978f8940984ull, 30}, // 1e28
+    {0xc097ce7bc90715b3ull, 56}, // 1e36
+    {0x8f7e32ce7bea5c70ull, 83}, // 1e44
+    {0xd5d238a4abe98068ull, 109}, // 1e52
+    {0x9f4f2726179a2245ull, 136}, // 1e60
+    {0xed63a231d4c4fb27ull, 162}, // 1e68
+    {0xb0de65388cc8ada8ull, 189}, // 1e76
+    {0x83c7088e1aab65dbull, 216}, // 1e84
+    {0xc45d1df942711d9aull, 242}, // 1e92
+    {0x924d692ca61be758ull, 269}, // 1e100
+    {0xda01ee641a708deaull, 295}, // 1e108
+    {0xa26da3999aef774aull, 322}, // 1e116
+    {0xf209787bb47d6b85ull, 348}, // 1e124
+    {0xb454e4a179dd1877ull, 375}, // 1e132
+    {0x865b86925b9bc5c2ull, 402}, // 1e140
+    {0xc83553c5c8965d3dull, 428}, // 1e148
+    {0x952ab45cfa97a0b3ull, 455}, // 1e156
+    {0xde469fbd99a05fe3ull, 481}, // 1e164
+    {0xa59bc234db398c25ull, 508}, // 1e172
+    {0xf6c69a72a3989f5cull, 534}, // 1e180
+    {0xb7dcbf5354e9beceull, 561}, // 1e188
+    {0x88fcf317f22241e2ull, 588}, // 1e196
+    {0xcc20ce9bd35c78a5ull, 614}, // 1e204
+    {0x98165af37b2153dfull, 641}, // 1e212
+    {0xe2a0b5dc971f303aull, 667}, // 1e220
+    {0xa8d9d1535ce3b396ull, 694}, // 1e228
+    {0xfb9b7cd9a4a7443cull, 720}, // 1e236
+    {0xbb764c4ca7a44410ull, 747}, // 1e244
+    {0x8bab8eefb6409c1aull, 774}, // 1e252
+    {0xd01fef10a657842cull, 800}, // 1e260
+    {0x9b10a4e5e9913129ull, 827}, // 1e268
+    {0xe7109bfba19c0c9dull, 853}, // 1e276
+    {0xac2820d9623bf429ull, 880}, // 1e284
+    {0x80444b5e7aa7cf85ull, 907}, // 1e292
+    {0xbf21e44003acdd2dull, 933}, // 1e300
+    {0x8e679c2f5e44ff8full, 960}, // 1e308
+    {0xd433179d9c8cb841ull, 986}, // 1e316
+    {0x9e19db92b4e31ba9ull, 1013}, // 1e324
+    {0xeb96bf6ebadf77d9ull, 1039}, // 1e332
+    {0xaf87023b9bf0ee6bull, 1066}, // 1e340
+};
+#define CACHED_POWERS_MIN_EXPONENT (-348)
+#define CACHED_POWERS_STEP 8
+
+static const uint64_t POWERS_OF_10[] = {
+    1ull, 10ull, 100ull, 1000ull, 10000ull, 100000ull, 1000000ull, 10000000ull, 100000000ull,
+    1000000000ull, 10000000000ull, 100000000000ull, 1000000000000ull, 10000000000000ull,
+    100000000000000ull, 1000000000000000ull, 10000000000000000ull, 100000000000000000ull,
+    1000000000000000000ull, 10000000000000000000ull,
+};
+
+static uint64_t GetDoubleBits(double value)
+{
+    uint64_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    return bits;
+}
+
+// Разбирает положительное конечное число на мантиссу и двоичный порядок.
+static DiyFp MakeDiyFp(double value)
+{
+    const uint64_t bits = GetDoubleBits(value);
+    const int biasedExponent = (int)((bits & DOUBLE_EXPONENT_MASK) >> DOUBLE_SIGNIFICAND_SIZE);
+    DiyFp result;
+    result.f = bits & DOUBLE_SIGNIFICAND_MASK;
+    if (biasedExponent != 0)
+    {
+        result.f += DOUBLE_HIDDEN_BIT;
+        result.e = biasedExponent - DOUBLE_EXPONENT_BIAS;
+    }
+    else
+    {
+        result.e = 1 - DOUBLE_EXPONENT_BIAS;
+    }
+    return result;
+}
+
+// Произведение с округлением старших 64 бит 128-битного результата.
+static DiyFp Multiply(DiyFp a, DiyFp b)
+{
+    const unsigned __int128 product = (unsigned __int128)a.f * b.f;
+    DiyFp result;
+    result.f = (uint64_t)(product >> 64);
+    if ((uint64_t)product & ((uint64_t)1 << 63))
+    {
+        ++result.f;
+    }
+    result.e = a.e + b.e + 64;
+    return result;
+}
+
+static DiyFp Normalize(DiyFp value)
+{
+    const int shift = __builtin_clzll(value.f);
+    value.f <<= shift;
+    value.e -= shift;
+    return value;
+}
+
+// Вычисляет границы интервала чисел, которые округляются к value, с общим порядком.
+static void GetNormalizedBoundaries(DiyFp value, DiyFp *minus, DiyFp *plus)
+{
+    DiyFp upper = {(value.f << 1) + 1, value.e - 1};
+    upper = Normalize(upper);
+    // У степени двойки нижний сосед вдвое ближе верхнего, кроме наименьшего нормализованного числа.
+    DiyFp lower = (value.f == DOUBLE_HIDDEN_BIT && value.e > 1 - DOUBLE_EXPONENT_BIAS)
+            ? (DiyFp){(value.f << 2) - 1, value.e - 2}
+            : (DiyFp){(value.f << 1) - 1, value.e - 1};
+    lower.f <<= lower.e - upper.e;
+    lower.e = upper.e;
+    *minus = lower;
+    *plus = upper;
+}
+
+// Выбирает степень 10^-k, после умножения на которую порядок попадает в [-60, -32].
+static DiyFp GetCachedPower(int exponent, int *decimalExponent)
+{
+    const double dk = (-61 - exponent) * 0.30102999566398114 + 347;
+    int k = (int)dk;
+    if (dk - k > 0.0)
+    {
+        ++k;
+    }
+    const unsigned index = (unsigned)((k >> 3) + 1);
+    *decimalExponent = -(CACHED_POWERS_MIN_EXPONENT + (int)index * CACHED_POWERS_STEP);
+    DiyFp result = {CACHED_POWERS[index].f, CACHED_POWERS[index].e};
+    return result;
+}
+
+// Уменьшает последнюю цифру, пока это приближает результат к точному значению.
+// Значение и границы интервала округления известны с погрешностью unit, поэтому
+//  возвращает 0, если нельзя доказать, что результат лежит в интервале и ближе всех к значению.
+static int RoundWeed(char *digits, size_t length, uint64_t distanceToValue, uint64_t unsafeInterval,
+                     uint64_t rest, uint64_t tenKappa, uint64_t unit)
+{
+    const uint64_t smallDistance = distanceToValue - unit;
+    const uint64_t bigDistance = distanceToValue + unit;
+    while (rest < smallDistance && unsafeInterval - rest >= tenKappa
+           && (rest + tenKappa < smallDistance || smallDistance - rest >= rest + tenKappa - smallDistance))
+    {
+        --digits[length - 1];
+        rest += tenKappa;
+    }
+    if (rest < bigDistance && unsafeInterval - rest >= tenKappa
+        && (rest + tenKappa < bigDistance || bigDistance - rest > rest + tenKappa - bigDistance))
+    {
+        return 0;
+    }
+    return 2 * unit <= rest && rest <= unsafeInterval - 4 * unit;
+}
+
+static int CountDecimalDigits(uint32_t value)
+{
+    int count = 1;
+    while (count < 10 && value >= POWERS_OF_10[count])
+    {
+        ++count;
+    }
+    return count;
+}
+
+// Генерирует цифры верхней границы интервала, расширенного на погрешность умножения,
+//  пока остаток не станет меньше ширины этого интервала.
+// Возвращает 0, если из-за погрешности результат может оказаться не кратчайшим.
+static int GenerateDigits(DiyFp value, DiyFp lower, DiyFp upper, char *digits, size_t *length, int *decimalExponent)
+{
+    const int shift = -upper.e;
+    const uint64_t one = (uint64_t)1 << shift;
+    uint64_t unit = 1;
+    const uint64_t tooHigh = upper.f + unit;
+    const uint64_t distanceToValue = tooHigh - value.f;
+    uint64_t unsafeInterval = tooHigh - (lower.f - unit);
+    uint32_t integral = (uint32_t)(tooHigh >> shift);
+    uint64_t fractional = tooHigh & (one - 1);
+    int kappa = CountDecimalDigits(integral);
+    *length = 0;
+    while (kappa > 0)
+    {
+        const uint32_t divisor = (uint32_t)POWERS_OF_10[kappa - 1];
+        const uint32_t digit = integral / divisor;
+        integral %= divisor;
+        if (digit != 0 || *length != 0)
+        {
+            digits[(*length)++] = (char)('0' + digit);
+        }
+        --kappa;
+        const uint64_t rest = ((uint64_t)integral << shift) + fractional;
+        if (rest < unsafeInterval)
+        {
+            *decimalExponent += kappa;
+            return RoundWeed(digits, *length, distanceToValue, unsafeInterval, rest,
+                             (uint64_t)divisor << shift, unit);
+        }
+    }
+    for (;;)
+    {
+        fractional *= 10;
+        unit *= 10;
+        unsafeInterval *= 10;
+        const char digit = (char)(fractional >> shift);
+        if (digit != 0 || *length != 0)
+        {
+            digits[(*length)++] = (char)('0' + digit);
+        }
+        fractional &= one - 1;
+        --kappa;
+        if (fractional < unsafeInterval)
+        {
+            *decimalExponent += kappa;
+            return RoundWeed(digits, *length, distanceToValue * unit, unsafeInterval, fractional, one, unit);
+        }
+    }
+}
+
+// Записывает цифры положительного конечного числа value = digits * 10^decimalExponent.
+// Возвращает 0 для немногих чисел, кратчайшую запись которых Grisu3 не гарантирует,
+//  но и тогда length - длина, близкая к кратчайшей.
+static int Grisu3(double value, char *digits, size_t *length, int *decimalExponent)
+{
+    const DiyFp v = MakeDiyFp(value);
+    DiyFp minus;
+    DiyFp plus;
+    GetNormalizedBoundaries(v, &minus, &plus);
+    const DiyFp cachedPower = GetCachedPower(plus.e, decimalExponent);
+    const DiyFp scaled = Multiply(Normalize(v), cachedPower);
+    const DiyFp upper = Multiply(plus, cachedPower);
+    const DiyFp lower = Multiply(minus, cachedPower);
+    return GenerateDigits(scaled, lower, upper, digits, length, decimalExponent);
+}
+
+// Проверяет, читается ли significand * 10^exponent обратно в value.
+static int IsRoundTrip(double value, uint64_t significand, int exponent)
+{
+    char text[32];
+    snprintf(text, sizeof(text), "%" PRIu64 "e%d", significand, exponent);
+    return strtod(text, NULL) == value;
+}
+
+// Ищет запись из precision значащих цифр, которая читается обратно в value:
+//  ближайшую к value или её соседа, если интервал округления несимметричен.
+static int FindRoundTrip(double value, int precision, uint64_t *significand, int *exponent)
+{
+    char text[32];
+    snprintf(text, sizeof(text), "%.*e", precision - 1, value);
+    uint64_t nearest = 0;
+    const char *p = text;
+    for (; *p != 'e'; ++p)
+    {
+        if (*p != '.')
+        {
+            nearest = nearest * 10 + (uint64_t)(*p - '0');
+        }
+    }
+    *exponent = (int)strtol(p + 1, NULL, 10) - (precision - 1);
+    const uint64_t candidates[] = {nearest, nearest - 1, nearest + 1};
+    for (size_t i = 0; i < sizeof(candidates) / sizeof(candidates[0]); ++i)
+    {
+        if (candidates[i] != 0 && IsRoundTrip(value, candidates[i], *exponent))
+        {
+            *significand = candidates[i];
+            return 1;
+        }
+    }
+    return 0;
+}
+
+// Медленный, но точный поиск кратчайшей записи через snprintf и strtod.
+// Запись из n цифр дополняется нулём до n + 1 цифры, поэтому длины, при которых
+//  запись есть, образуют отрезок [длина кратчайшей, 17]. Поиск начинается с длины guess.
+static size_t FindShortest(double value, int guess, char *digits, int *decimalExponent)
+{
+    int precision = (guess < 1) ? 1 : (guess > 17 ? 17 : guess);
+    uint64_t significand = 0;
+    int exponent = 0;
+    if (FindRoundTrip(value, precision, &significand, &exponent))
+    {
+        uint64_t shorter = 0;
+        int shorterExponent = 0;
+        while (precision > 1 && FindRoundTrip(value, precision - 1, &shorter, &shorterExponent))
+        {
+            --precision;
+            significand = shorter;
+            exponent = shorterExponent;
+        }
+    }
+    else
+    {
+        do
+        {
+            ++precision;
+        }
+        while (!FindRoundTrip(value, precision, &significand, &exponent));
+    }
+    while (significand % 10 == 0)
+    {
+        significand /= 10;
+        ++exponent;
+    }
+    char reversed[20];
+    size_t length = 0;
+    for (; significand != 0; significand /= 10)
+    {
+        reversed[length++] = (char)('0' + significand % 10);
+    }
+    for (size_t i = 0; i < length; ++i)
+    {
+        digits[i] = reversed[length - 1 - i];
+    }
+    *decimalExponent = exponent;
+    return length;
+}
+
+static char *WriteExponent(char *dest, int exponent)
+{
+    *dest++ = 'e';
+    if (exponent < 0)
+    {
+        *dest++ = '-';
+        exponent = -exponent;
+    }
+    else
+    {
+        *dest++ = '+';
+    }
+    if (exponent >= 100)
+    {
+        *dest++ = (char)('0' + exponent / 100);
+        exponent %= 100;
+        *dest++ = (char)('0' + exponent / 10);
+    }
+    else if (exponent >= 10)
+    {
+        *dest++ = (char)('0' + exponent / 10);
+    }
+    *dest++ = (char)('0' + exponent % 10);
+    return dest;
+}
+
+// Размещает цифры так же, как Number.prototype.toString в JavaScript:
+//  десятичная запись для 1e-6 <= |value| < 1e21, иначе экспоненциальная.
+// point - позиция десятичной точки относительно первой цифры.
+static char *WriteDecimal(char *dest, const char *digits, int length, int point)
+{
+    if (length <= point && point <= 21)
+    {
+        // 1234e2 -> 123400
+        memcpy(dest, digits, (size_t)length);
+        memset(dest + length, '0', (size_t)(point - length));
+        return dest + point;
+    }
+    if (0 < point && point <= 21)
+    {
+        // 1234e-2 -> 12.34
+        memcpy(dest, digits, (size_t)point);
+        dest[point] = '.';
+        memcpy(dest + point + 1, digits + point, (size_t)(length - point));
+        return dest + length + 1;
+    }
+    if (-6 < point && point <= 0)
+    {
+        // 1234e-6 -> 0.001234
+        const int zeros = -point;
+        dest[0] = '0';
+        dest[1] = '.';
+        memset(dest + 2, '0', (size_t)zeros);
+        memcpy(dest + 2 + zeros, digits, (size_t)length);
+        return dest + 2 + zeros + length;
+    }
+    // 1234e30 -> 1.234e+33
+    *dest++ = digits[0];
+    if (length > 1)
+    {
+        *dest++ = '.';
+        memcpy(dest, digits + 1, (size_t)(length - 1));
+        dest += length - 1;
+    }
+    return WriteExponent(dest, point - 1);
+}
+
+size_t pythonish_format_num(double value, char *buffer)
+{
+    char *dest = buffer;
+    const uint64_t bits = GetDoubleBits(value);
+    if ((bits & DOUBLE_EXPONENT_MASK) == DOUBLE_EXPONENT_MASK)
+    {
+        const char *text = (bits & DOUBLE_SIGNIFICAND_MASK) ? "nan" : (value < 0 ? "-inf" : "inf");
+        const size_t length = strlen(text);
+        memcpy(dest, text, length);
+        return length;
+    }
+    if (bits >> 63)
+    {
+        *dest++ = '-';
+        value = -value;
+    }
+    if (value == 0)
+    {
+        *dest++ = '0';
+        return (size_t)(dest - buffer);
+    }
+    char digits[20];
+    int decimalExponent = 0;
+    size_t length = 0;
+    if (!Grisu3(value, digits, &length, &decimalExponent))
+    {
+        length = FindShortest(value, (int)length, digits, &decimalExponent);
+    }
+    dest = WriteDecimal(dest, digits, (int)length, (int)length + decimalExponent);
+    return (size_t)(dest - buffer);
+}
+
+size_t pythonish_format_int(int64_t value, char *buffer)
+{
+    char digits[20];
+    size_t count = 0;
+    // Модуль INT64_MIN не представим в int64_t, поэтому вычисляется в беззнаковом типе.
+    uint64_t magnitude = (value < 0) ? 0 - (uint64_t)value : (uint64_t)value;
+    do
+    {
+        digits[count++] = (char)('0' + magnitude % 10);
+        magnitude /= 10;
+    }
+    while (magnitude != 0);
+
+    char *dest = buffer;
+    if (value < 0)
+    {
+        *dest++ = '-';
+    }
+    while (count != 0)
+    {
+        *dest++ = digits[--count];
+    }
+    return (size_t)(dest - buffer);
+}
@@ -0,0 +1,306 @@
+#include "runtime.h"
+#include "runtime_private.h"
+#include <errno.h>
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+// Размер блока ввода. Строка длиннее блока переносится в блок вдвое большего размера.
+#define INPUT_CHUNK_SIZE (1024 * 1024)
+
+typedef struct InputBuffer
+{
+    // Байты блока, перед ними - счётчик ссылок, как у строки в куче.
+    char *data;
+    size_t capacity;
+    // Непрочитанные программой байты - [begin, end).
+    size_t begin;
+    size_t end;
+    int isEof;
+} InputBuffer;
+
+static InputBuffer g_input;
+
+static const double POWERS_OF_TEN[] = {
+    1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22,
+};
+
+static size_t *GetRefcount(const InputBuffer *input)
+{
+    return (size_t *)input->data - 1;
+}
+
+static int IsSpace(char ch)
+{
+    return ch == ' ' || ch == '\t' || ch == '\n' || ch == '\r' || ch == '\v' || ch == '\f';
+}
+
+// Освобождает место в конце блока: переносит непрочитанные байты в его начало,
+//  а если на блок есть другие ссылки или он заполнен целиком - в новый блок.
+static void MakeRoom(InputBuffer *input, PythonishAllocate allocate, PythonishFree release)
+{
+    const size_t pending = input->end - input->begin;
+    if (input->data && *GetRefcount(input) == 1 && pending < input->capacity)
+    {
+        memmove(input->data, input->data + input->begin, pending);
+    }
+    else
+    {
+        size_t capacity = INPUT_CHUNK_SIZE;
+        while (capacity < 2 * pending)
+        {
+            capacity *= 2;
+        }
+        size_t *header = pythonish_abort_on_null(allocate(sizeof(size_t) + capacity));
+        *header = 1;
+        char *data = (char *)(header + 1);
+        if (input->data)
+        {
+            memcpy(data, input->data + input->begin, pending);
+            if (--*GetRefcount(input) == 0)
+            {
+                release(GetRefcount(input));
+            }
+        }
+        input->data = data;
+        input->capacity = capacity;
+    }
+    input->begin = 0;
+    input->end = pending;
+}
+
+// Дочитывает ввод в блок. Возвращает 0, если ввод кончился.
+static int Fill(InputBuffer *input, PythonishAllocate allocate, PythonishFree release)
+{
+    if (input->isEof)
+    {
+        return 0;
+    }
+    if (!input->data || input->end == input->capacity)
+    {
+        MakeRoom(input, allocate, release);
+    }
+    for (;;)
+    {
+        ssize_t count = read(STDIN_FILENO, input->data + input->end, input->capacity - input->end);
+        if (count > 0)
+        {
+            input->end += (size_t)count;
+            return 1;
+        }
+        if (count < 0 && errno == EINTR)
+        {
+            continue;
+        }
+        // Ошибку чтения программа, как и конец ввода, видит через pythonish_end_of_input.
+        input->isEof = 1;
+        return 0;
+    }
+}
+
+// Пропускает пробельные символы, а если stopAtLineEnd - не дальше первого перевода строки.
+// Возвращает 0, если ввод кончился.
+static int SkipSpaces(InputBuffer *input, PythonishAllocate allocate, PythonishFree release, int stopAtLineEnd)
+{
+    for (;;)
+    {
+        while (input->begin < input->end)
+        {
+            const char ch = input->data[input->begin];
+            if (!IsSpace(ch))
+            {
+                return 1;
+            }
+            ++input->begin;
+            if (stopAtLineEnd && ch == '\n')
+            {
+                return 1;
+            }
+        }
+        if (!Fill(input, allocate, release))
+        {
+            return 0;
+        }
+    }
+}
+
+// Записывает в line короткую строку внутри значения или срез блока ввода.
+static void MakeLine(InputBuffer *input, const char *start, size_t length, PythonishString *line)
+{
+    if (length <= PYTHONISH_INLINE_CAPACITY)
+    {
+        unsigned char bytes[sizeof(PythonishString)] = {0};
+        if (length != 0)
+        {
+            memcpy(bytes, start, length);
+        }
+        bytes[sizeof(bytes) - 1] = (unsigned char)(0x80 | length);
+        memcpy(line, bytes, sizeof(bytes));
+        return;
+    }
+    const size_t offset = (size_t)(start - input->data);
+    if (offset > PYTHONISH_VIEW_MAX_OFFSET || length > PYTHONISH_VIEW_MAX_LENGTH)
+    {
+        // Строку не выразить срезом: она длиннее 512 МиБ, либо ей предшествовала такая строка.
+        abort();
+    }
+    ++*GetRefcount(input);
+    line->data = start;
+    line->length = PYTHONISH_VIEW_TAG | (offset << PYTHONISH_VIEW_OFFSET_SHIFT) | length;
+}
+
+void pythonish_read_line(PythonishAllocate allocate, PythonishFree release, PythonishString *line)
+{
+    InputBuffer *input = &g_input;
+    const char *newline = NULL;
+    // Байты после begin, в которых перевода строки уже нет.
+    size_t scanned = 0;
+    for (;;)
+    {
+        if (input->data)
+        {
+            const char *from = input->data + input->begin + scanned;
+            newline = memchr(from, '\n', input->end - input->begin - scanned);
+            if (newline)
+            {
+                break;
+            }
+            scanned = input->end - input->begin;
+        }
+        if (!Fill(input, allocate, release))
+        {
+            break;
+        }
+    }
+    const char *start = input->data ? input->data + input->begin : NULL;
+    size_t length = newline ? (size_t)(newline - start) : input->end - input->begin;
+    input->begin += newline ? length + 1 : length;
+    if (newline && length != 0 && start[length - 1] == '\r')
+    {
+        --length;
+    }
+    MakeLine(input, start, length, line);
+}
+
+// Разбирает строку через strtod: числа, которые нельзя разобрать точно без округления, inf и nan.
+static double ParseWithStrtod(const char *token, size_t length)
+{
+    char buffer[128];
+    char *text = (length < sizeof(buffer)) ? buffer : pythonish_abort_on_null(malloc(length + 1));
+    memcpy(text, token, length);
+    text[length] = '\0';
+    char *stop = NULL;
+    double value = strtod(text, &stop);
+    if (length == 0 || stop != text + length)
+    {
+        value = NAN;
+    }
+    if (text != buffer)
+    {
+        free(text);
+    }
+    return value;
+}
+
+// Разбирает десятичную запись числа, которая занимает всё слово.
+// Если в мантиссе не больше 15 значащих цифр, а порядок не больше 22 по модулю, то и мантисса,
+//  и степень десяти точно представимы в double, и результат округляется один раз:
+//  одного умножения или деления достаточно. Остальные числа разбирает strtod.
+static double ParseNumber(const char *token, size_t length)
+{
+    const char *pos = token;
+    const char *end = token + length;
+    const int isNegative = (pos != end && *pos == '-');
+    if (pos != end && (*pos == '-' || *pos == '+'))
+    {
+        ++pos;
+    }
+    uint64_t mantissa = 0;
+    int significantDigits = 0;
+    int exponent = 0;
+    int hasDigits = 0;
+    int isPointSeen = 0;
+    for (; pos != end; ++pos)
+    {
+        if (*pos == '.' && !isPointSeen)
+        {
+            isPointSeen = 1;
+            continue;
+        }
+        if (*pos < '0' || *pos > '9')
+        {
+            break;
+        }
+        hasDigits = 1;
+        if (mantissa != 0 || *pos != '0')
+        {
+            ++significantDigits;
+        }
+        mantissa = mantissa * 10 + (uint64_t)(*pos - '0');
+        exponent -= isPointSeen;
+        if (significantDigits > 15)
+        {
+            return ParseWithStrtod(token, length);
+        }
+    }
+    if (hasDigits && pos != end && (*pos == 'e' || *pos == 'E'))
+    {
+        ++pos;
+        const int isNegativeExponent = (pos != end && *pos == '-');
+        if (pos != end && (*pos == '-' || *pos == '+'))
+        {
+            ++pos;
+        }
+        int value = 0;
+        const char *digits = pos;
+        for (; pos != end && *pos >= '0' && *pos <= '9' && value < 1000; ++pos)
+        {
+            value = value * 10 + (*pos - '0');
+        }
+        if (pos == digits)
+        {
+            return NAN;
+        }
+        exponent += isNegativeExponent ? -value : value;
+    }
+    if (!hasDigits || pos != end || exponent < -22 || exponent > 22)
+    {
+        return ParseWithStrtod(token, length);
+    }
+    double value = (double)mantissa;
+    value = (exponent < 0) ? value / POWERS_OF_TEN[-exponent] : value * POWERS_OF_TEN[exponent];
+    return isNegative ? -value : value;
+}
+
+double pythonish_read_number(PythonishAllocate allocate, PythonishFree release)
+{
+    InputBuffer *input = &g_input;
+    if (!SkipSpaces(input, allocate, release, 0))
+    {
+        return 0;
+    }
+    size_t length = 0;
+    for (;;)
+    {
+        while (input->begin + length < input->end && !IsSpace(input->data[input->begin + length]))
+        {
+            ++length;
+        }
+        if (input->begin + length < input->end || !Fill(input, allocate, release))
+        {
+            break;
+        }
+    }
+    const double value = ParseNumber(input->data + input->begin, length);
+    input->begin += length;
+    SkipSpaces(input, allocate, release, 1);
+    return value;
+}
+
+int pythonish_end_of_input(PythonishAllocate allocate, PythonishFree release)
+{
+    InputBuffer *input = &g_input;
+    return input->begin == input->end && !Fill(input, allocate, release);
+}
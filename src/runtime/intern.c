@@ -0,0 +1,120 @@
+#include "runtime.h"
+#include "runtime_private.h"
+#include <stdlib.h>
+#include <string.h>
+
+/*
+ * Хеш-таблица с открытой адресацией и линейным пробированием.
+ * Ёмкость - степень двойки, таблица растёт вдвое при заполнении на 3/4.
+ * Блоки интернированных строк выделяются через malloc и не освобождаются.
+ */
+#define INTERN_MIN_CAPACITY 64
+
+typedef struct InternEntry
+{
+    const char *data;
+    size_t length;
+    uint64_t hash;
+} InternEntry;
+
+typedef struct InternTable
+{
+    InternEntry *entries;
+    size_t capacity;
+    size_t count;
+} InternTable;
+
+static InternTable g_interned;
+
+// FNV-1a.
+static uint64_t HashBytes(const char *data, size_t length)
+{
+    uint64_t hash = 14695981039346656037ull;
+    for (size_t i = 0; i < length; ++i)
+    {
+        hash ^= (unsigned char)data[i];
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+// Возвращает ячейку с той же строкой или пустую ячейку, в которую её следует добавить.
+static InternEntry *FindEntry(InternTable *table, const char *data, size_t length, uint64_t hash)
+{
+    const size_t mask = table->capacity - 1;
+    for (size_t i = (size_t)hash & mask;; i = (i + 1) & mask)
+    {
+        InternEntry *entry = &table->entries[i];
+        if (!entry->data)
+        {
+            return entry;
+        }
+        if (entry->hash == hash && entry->length == length && memcmp(entry->data, data, length) == 0)
+        {
+            return entry;
+        }
+    }
+}
+
+static void Grow(InternTable *table)
+{
+    InternTable grown;
+    grown.capacity = table->capacity ? table->capacity * 2 : INTERN_MIN_CAPACITY;
+    grown.count = table->count;
+    grown.entries = pythonish_abort_on_null(calloc(grown.capacity, sizeof(InternEntry)));
+    for (size_t i = 0; i < table->capacity; ++i)
+    {
+        const InternEntry *entry = &table->entries[i];
+        if (entry->data)
+        {
+            *FindEntry(&grown, entry->data, entry->length, entry->hash) = *entry;
+        }
+    }
+    free(table->entries);
+    *table = grown;
+}
+
+// Возвращает ячейку для строки, заранее расширив таблицу, если в неё может не поместиться ещё одна строка.
+static InternEntry *FindOrReserve(const char *data, size_t length, uint64_t hash)
+{
+    InternTable *table = &g_interned;
+    if (4 * (table->count + 1) > 3 * table->capacity)
+    {
+        Grow(table);
+    }
+    return FindEntry(table, data, length, hash);
+}
+
+const char *pythonish_intern(const char *data, size_t length)
+{
+    const uint64_t hash = HashBytes(data, length);
+    InternEntry *entry = FindOrReserve(data, length, hash);
+    if (!entry->data)
+    {
+        size_t *header = pythonish_abort_on_null(malloc(sizeof(size_t) + length));
+        *header = PYTHONISH_STRING_INTERNED;
+        char *copy = (char *)(header + 1);
+        memcpy(copy, data, length);
+        entry->data = copy;
+        entry->length = length;
+        entry->hash = hash;
+        ++g_interned.count;
+    }
+    return entry->data;
+}
+
+void pythonish_intern_literals(const PythonishString *literals, size_t count)
+{
+    for (size_t i = 0; i < count; ++i)
+    {
+        const uint64_t hash = HashBytes(literals[i].data, literals[i].length);
+        InternEntry *entry = FindOrReserve(literals[i].data, literals[i].length, hash);
+        if (!entry->data)
+        {
+            entry->data = literals[i].data;
+            entry->length = literals[i].length;
+            entry->hash = hash;
+            ++g_interned.count;
+        }
+    }
+}
@@ -0,0 +1,148 @@
+#include "runtime.h"
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+// Вывод сбрасывается в stdout одним вызовом write при заполнении буфера
+//  и при завершении программы, а для терминала - после каждой строки.
+#define OUTPUT_BUFFER_SIZE (64 * 1024)
+
+typedef struct OutputBuffer
+{
+    size_t size;
+    int isInitialized;
+    int isTerminal;
+    char data[OUTPUT_BUFFER_SIZE];
+} OutputBuffer;
+
+static OutputBuffer g_output;
+
+static void WriteAll(const char *data, size_t size)
+{
+    while (size != 0)
+    {
+        ssize_t written = write(STDOUT_FILENO, data, size);
+        if (written < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            // Ошибку вывода, например, закрытый канал, сообщить некуда.
+            return;
+        }
+        data += written;
+        size -= (size_t)written;
+    }
+}
+
+static void FlushAtExit(void)
+{
+    pythonish_flush();
+}
+
+static OutputBuffer *GetOutput(void)
+{
+    OutputBuffer *output = &g_output;
+    if (!output->isInitialized)
+    {
+        output->isInitialized = 1;
+        output->isTerminal = isatty(STDOUT_FILENO);
+        atexit(FlushAtExit);
+    }
+    return output;
+}
+
+// Возвращает указатель на size свободных байт в конце буфера, при необходимости сбросив его.
+static char *Reserve(OutputBuffer *output, size_t size)
+{
+    if (OUTPUT_BUFFER_SIZE - output->size < size)
+    {
+        pythonish_flush();
+    }
+    return output->data + output->size;
+}
+
+void pythonish_flush(void)
+{
+    WriteAll(g_output.data, g_output.size);
+    g_output.size = 0;
+}
+
+void pythonish_write_str(const char *data, size_t length)
+{
+    OutputBuffer *output = GetOutput();
+    if (length > OUTPUT_BUFFER_SIZE)
+    {
+        // Длинная строка выводится напрямую, минуя буфер.
+        pythonish_flush();
+        WriteAll(data, length);
+    }
+    else
+    {
+        memcpy(Reserve(output, length), data, length);
+        output->size += length;
+    }
+}
+
+void pythonish_write_num(double value)
+{
+    OutputBuffer *output = GetOutput();
+    char *dest = Reserve(output, PYTHONISH_NUMBER_BUFFER_SIZE);
+    output->size += pythonish_format_num(value, dest);
+}
+
+void pythonish_write_int(int64_t value)
+{
+    OutputBuffer *output = GetOutput();
+    char *dest = Reserve(output, PYTHONISH_NUMBER_BUFFER_SIZE);
+    output->size += pythonish_format_int(value, dest);
+}
+
+void pythonish_write_bool(int value)
+{
+    if (value)
+    {
+        pythonish_write_str("true", 4);
+    }
+    else
+    {
+        pythonish_write_str("false", 5);
+    }
+}
+
+void pythonish_end_line(void)
+{
+    OutputBuffer *output = GetOutput();
+    *Reserve(output, 1) = '\n';
+    ++output->size;
+    if (output->isTerminal)
+    {
+        pythonish_flush();
+    }
+}
+
+void pythonish_print_str(const char *data, size_t length)
+{
+    pythonish_write_str(data, length);
+    pythonish_end_line();
+}
+
+void pythonish_print_num(double value)
+{
+    pythonish_write_num(value);
+    pythonish_end_line();
+}
+
+void pythonish_print_int(int64_t value)
+{
+    pythonish_write_int(value);
+    pythonish_end_line();
+}
+
+void pythonish_print_bool(int value)
+{
+    pythonish_write_bool(value);
+    pythonish_end_line();
+}
@@ -0,0 +1,180 @@
+#include "runtime.h"
+#include "runtime_private.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/mman.h>
+
+/*
+ * Блок начинается с заголовка, в котором хранится номер класса размера
+ *  (для крупного блока - его размер), поэтому pythonish_free не требует размера блока.
+ * Классы размеров (вместе с заголовком): от 32 до 128 байт с шагом 16,
+ *  далее по четыре класса на каждое удвоение вплоть до POOL_MAX_BLOCK_SIZE.
+ * Более крупные блоки выделяются и освобождаются напрямую через malloc/free.
+ */
+#define POOL_HEADER_SIZE sizeof(size_t)
+#define POOL_MIN_BLOCK_SIZE 32
+#define POOL_SMALL_BLOCK_SIZE 128
+#define POOL_MAX_BLOCK_SIZE 4096
+#define POOL_SMALL_CLASS_COUNT 7
+#define POOL_CLASS_COUNT 27
+#define POOL_SLAB_SIZE (64 * 1024)
+
+typedef struct FreeBlock
+{
+    struct FreeBlock *next;
+} FreeBlock;
+
+// Блок, освобождённый другим потоком, попадает в список свободных блоков этого потока.
+// Пластины (slab), из которых нарезаются блоки, не возвращаются системе.
+typedef struct ThreadPool
+{
+    FreeBlock *freeLists[POOL_CLASS_COUNT];
+    PythonishAllocStats stats;
+} ThreadPool;
+
+static _Thread_local ThreadPool g_pool;
+
+static size_t GetClassIndex(size_t blockSize)
+{
+    if (blockSize <= POOL_SMALL_BLOCK_SIZE)
+    {
+        return (blockSize <= POOL_MIN_BLOCK_SIZE) ? 0 : (blockSize - 1) / 16 - 1;
+    }
+    // 2^power < blockSize <= 2^(power+1), внутри удвоения шаг равен 2^(power-2).
+    size_t power = (size_t)(8 * sizeof(unsigned long) - 1 - __builtin_clzl((unsigned long)(blockSize - 1)));
+    size_t quarter = ((blockSize - 1) >> (power - 2)) - 4;
+    return POOL_SMALL_CLASS_COUNT + (power - 7) * 4 + quarter;
+}
+
+static size_t GetClassSize(size_t classIndex)
+{
+    if (classIndex < POOL_SMALL_CLASS_COUNT)
+    {
+        return POOL_MIN_BLOCK_SIZE + classIndex * 16;
+    }
+    size_t power = 7 + (classIndex - POOL_SMALL_CLASS_COUNT) / 4;
+    size_t quarter = (classIndex - POOL_SMALL_CLASS_COUNT) % 4 + 1;
+    return ((size_t)1 << power) + quarter * ((size_t)1 << (power - 2));
+}
+
+static void PrintStats(void)
+{
+    PythonishAllocStats stats;
+    pythonish_alloc_stats(&stats);
+    fprintf(stderr,
+            "pythonish allocator: %zu allocations, %zu frees, %zu large, %zu slabs, "
+            "%zu bytes in use, %zu bytes peak\n",
+            stats.allocations, stats.frees, stats.largeAllocations, stats.slabs,
+            stats.bytesInUse, stats.peakBytesInUse);
+}
+
+// При первом обращении к системе проверяет PYTHONISH_ALLOC_STATS
+//  и при необходимости печатает статистику при завершении программы.
+static void RegisterStatsPrinter(void)
+{
+    static int s_registered = 0;
+    if (!s_registered)
+    {
+        s_registered = 1;
+        if (getenv("PYTHONISH_ALLOC_STATS"))
+        {
+            atexit(PrintStats);
+        }
+    }
+}
+
+void *pythonish_abort_on_null(void *ptr)
+{
+    if (!ptr)
+    {
+        abort();
+    }
+    return ptr;
+}
+
+// Нарезает новую пластину на блоки класса и добавляет их в список свободных.
+static void RefillClass(ThreadPool *pool, size_t classIndex)
+{
+    RegisterStatsPrinter();
+    const size_t blockSize = GetClassSize(classIndex);
+    char *slab = pythonish_abort_on_null(malloc(POOL_SLAB_SIZE));
+    FreeBlock *head = pool->freeLists[classIndex];
+    for (char *block = slab + POOL_SLAB_SIZE - POOL_SLAB_SIZE % blockSize; block != slab;)
+    {
+        block -= blockSize;
+        FreeBlock *freeBlock = (FreeBlock *)block;
+        freeBlock->next = head;
+        head = freeBlock;
+    }
+    pool->freeLists[classIndex] = head;
+    ++pool->stats.slabs;
+}
+
+static void AddBytesInUse(ThreadPool *pool, size_t blockSize)
+{
+    pool->stats.bytesInUse += blockSize;
+    if (pool->stats.bytesInUse > pool->stats.peakBytesInUse)
+    {
+        pool->stats.peakBytesInUse = pool->stats.bytesInUse;
+    }
+}
+
+void *pythonish_alloc(size_t size)
+{
+    ThreadPool *pool = &g_pool;
+    const size_t blockSize = size + POOL_HEADER_SIZE;
+    ++pool->stats.allocations;
+    size_t *header;
+    if (blockSize > POOL_MAX_BLOCK_SIZE)
+    {
+        RegisterStatsPrinter();
+        header = pythonish_abort_on_null(malloc(blockSize));
+        *header = blockSize;
+        ++pool->stats.largeAllocations;
+        AddBytesInUse(pool, blockSize);
+        return header + 1;
+    }
+    const size_t classIndex = GetClassIndex(blockSize);
+    if (!pool->freeLists[classIndex])
+    {
+        RefillClass(pool, classIndex);
+    }
+    FreeBlock *block = pool->freeLists[classIndex];
+    pool->freeLists[classIndex] = block->next;
+    header = (size_t *)block;
+    *header = classIndex;
+    AddBytesInUse(pool, GetClassSize(classIndex));
+    return header + 1;
+}
+
+void pythonish_free(void *ptr)
+{
+    if (!ptr)
+    {
+        return;
+    }
+    ThreadPool *pool = &g_pool;
+    size_t *header = (size_t *)ptr - 1;
+    const size_t classIndex = *header;
+    if (classIndex == PYTHONISH_MAPPED_BLOCK)
+    {
+        munmap((void *)header[-2], header[-1]);
+        return;
+    }
+    ++pool->stats.frees;
+    if (classIndex >= POOL_CLASS_COUNT)
+    {
+        pool->stats.bytesInUse -= classIndex;
+        free(header);
+        return;
+    }
+    FreeBlock *block = (FreeBlock *)header;
+    block->next = pool->freeLists[classIndex];
+    pool->freeLists[classIndex] = block;
+    pool->stats.bytesInUse -= GetClassSize(classIndex);
+}
+
+void pythonish_alloc_stats(PythonishAllocStats *stats)
+{
+    *stats = g_pool.stats;
+}
@@ -0,0 +1,206 @@
+#pragma once
+
+/*
+ * Библиотека времени выполнения программ, скомпилированных pythonishc.
+ * Сгенерированный код вызывает эти функции напрямую, поэтому их сигнатуры
+ *  должны совпадать с объявлениями в CCodegenContext.
+ *
+ * Потоки: сгенерированный код выполняется в одном потоке.
+ *  - Пул и арена, из которых выделяется память строк, свои у каждого потока
+ *    и не требуют синхронизации.
+ *  - Остальное состояние одно на всю программу и не синхронизировано:
+ *    буферы ввода и вывода, таблица открытых файлов, таблица интернированных строк.
+ *    Функции, которые его используют, можно вызывать только из одного потока.
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Арена для временных строк: память выделяется сдвигом указателя,
+ *  а освобождается целиком откатом к ранее запомненной отметке.
+ * Отметки образуют стек: функция запоминает отметку при входе
+ *  и откатывается к ней в конце каждого оператора.
+ * Арена своя у каждого потока.
+ */
+
+// Выделяет size байт, выровненных по границе size_t.
+void *pythonish_arena_alloc(size_t size);
+
+// Возвращает текущую отметку арены.
+void *pythonish_arena_mark(void);
+
+// Освобождает всё, что было выделено после получения отметки.
+void pythonish_arena_release(void *mark);
+
+/*
+ * Пул для блоков строк: списки свободных блоков по классам размеров, свои у каждого потока.
+ * Компилятор с опцией --libc-malloc вместо пула вызывает malloc и free.
+ * Если задана переменная окружения PYTHONISH_ALLOC_STATS,
+ *  статистика пула печатается в stderr при завершении программы.
+ */
+
+typedef struct PythonishAllocStats
+{
+    size_t allocations;
+    size_t frees;
+    // Блоки больше максимального класса, которые выделяются через malloc.
+    size_t largeAllocations;
+    // Пластины, на которые нарезаются блоки классов.
+    size_t slabs;
+    size_t bytesInUse;
+    size_t peakBytesInUse;
+} PythonishAllocStats;
+
+// Выделяет size байт, выровненных по границе size_t.
+void *pythonish_alloc(size_t size);
+
+// Освобождает блок, выделенный pythonish_alloc, или блок файла, отображённого в память.
+void pythonish_free(void *ptr);
+
+// Заголовок блока, который pythonish_free освобождает вызовом munmap,
+//  см. pythonish_read_all. Перед заголовком хранятся начало и длина отображения.
+#define PYTHONISH_MAPPED_BLOCK ((size_t)-1)
+
+// Возвращает статистику пула текущего потока.
+void pythonish_alloc_stats(PythonishAllocStats *stats);
+
+/*
+ * Таблица интернированных строк: строки с одинаковым текстом представлены одним блоком,
+ *  поэтому две интернированные строки равны тогда и только тогда, когда равны их указатели.
+ * Счётчик ссылок в заголовке интернированной строки равен PYTHONISH_STRING_INTERNED:
+ *  такие строки, как и литералы, никогда не освобождаются.
+ */
+#define PYTHONISH_STRING_INTERNED ((size_t)-2)
+
+// Значение String: байты без завершающего нуля и длина.
+typedef struct PythonishString
+{
+    const char *data;
+    size_t length;
+} PythonishString;
+
+// Возвращает байты интернированной строки с тем же текстом, при необходимости копируя текст в таблицу.
+const char *pythonish_intern(const char *data, size_t length);
+
+// Добавляет в таблицу литералы программы, заголовки которых уже равны PYTHONISH_STRING_INTERNED.
+// Вызывается до main, если программа интернирует строки.
+void pythonish_intern_literals(const PythonishString *literals, size_t count);
+
+/*
+ * Представление String, которое runtime создаёт сам, совпадает с CodegenVisitor.cpp:
+ *  строка до 15 байт хранится внутри значения, старший байт length равен 0x80 | длина;
+ *  срез ссылается на байты блока со счётчиком ссылок, а его length равен
+ *  PYTHONISH_VIEW_TAG | (смещение от начала блока << PYTHONISH_VIEW_OFFSET_SHIFT) | длина.
+ */
+#define PYTHONISH_INLINE_CAPACITY 15
+#define PYTHONISH_VIEW_TAG ((size_t)1 << 62)
+#define PYTHONISH_VIEW_OFFSET_SHIFT 32
+#define PYTHONISH_VIEW_MAX_OFFSET (((size_t)1 << 30) - 1)
+#define PYTHONISH_VIEW_MAX_LENGTH (((size_t)1 << 32) - 1)
+
+/*
+ * Чтение stdin. Ввод читается вызовами read(2) прямо в большие блоки строк,
+ *  длинные строки ввода возвращаются срезами этих блоков без копирования.
+ * Блоки выделяются и освобождаются теми же функциями, что и строки сгенерированного кода
+ *  (пул или malloc/free), поэтому последний владелец среза освобождает блок как обычную строку.
+ * Runtime владеет одной ссылкой на текущий блок и дочитывает в него на месте,
+ *  только если других ссылок нет.
+ */
+
+typedef void *(*PythonishAllocate)(size_t size);
+typedef void (*PythonishFree)(void *ptr);
+
+// Записывает в line следующую строку ввода без "\n" и без "\r" перед ним.
+// Длинная строка - срез, который владеет ссылкой на блок ввода. В конце ввода записывает пустую строку.
+void pythonish_read_line(PythonishAllocate allocate, PythonishFree release, PythonishString *line);
+
+// Пропускает пробельные символы, читает слово и пропускает пробелы до конца строки включительно.
+// Возвращает число, записанное словом, или NaN, если слово не является числом. В конце ввода возвращает 0.
+double pythonish_read_number(PythonishAllocate allocate, PythonishFree release);
+
+// Возвращает ненулевое значение, если во вводе не осталось ни одного байта.
+int pythonish_end_of_input(PythonishAllocate allocate, PythonishFree release);
+
+/*
+ * Файлы. Номер открытого файла - неотрицательное число, а -1 означает, что файл не открыт.
+ * Запись идёт через буфер размером 256 КиБ, который сбрасывается при заполнении,
+ *  закрытии файла и завершении программы.
+ * Файл, который читается целиком, отображается в память, и строка ссылается
+ *  прямо на его страницы, если строки выделяются пулом (pythonish_alloc).
+ *  Такой файл не должен укорачиваться, пока программа его читает.
+ */
+
+// Открывает файл на чтение ("r"), перезапись ("w") или дозапись ("a").
+int64_t pythonish_open(const char *path, size_t pathLength, const char *mode, size_t modeLength);
+
+// Записывает в text непрочитанную часть файла, открытого на чтение, или пустую строку.
+// Длинный текст - строка в куче, которой владеет вызывающий.
+// Размер файла не ограничен смещением среза PYTHONISH_VIEW_MAX_OFFSET:
+//  срез дальше этого смещения от начала текста сгенерированный код копирует.
+void pythonish_read_all(PythonishAllocate allocate, PythonishFree release, int64_t file, PythonishString *text);
+
+// Дописывает байты в файл, открытый на запись.
+// Возвращает 0, если файл не открыт на запись или при записи в него уже произошла ошибка.
+int pythonish_write_file(int64_t file, const char *data, size_t length);
+
+// Дописывает байты и перевод строки, как инструкция print.
+int pythonish_write_file_line(int64_t file, const char *data, size_t length);
+
+// Сбрасывает буфер и закрывает файл. Возвращает 0 при ошибке записи или закрытия.
+int pythonish_close(int64_t file);
+
+/*
+ * Поиск в строках.
+ */
+
+// Возвращает позицию первого вхождения sub в data или -1, если вхождения нет.
+// Пустая подстрока находится в позиции 0.
+int64_t pythonish_find(const char *data, size_t length, const char *sub, size_t subLength);
+
+/*
+ * Преобразование чисел в текст. Функции пишут в buffer не более
+ *  PYTHONISH_NUMBER_BUFFER_SIZE байт без завершающего нуля и возвращают длину записи.
+ */
+#define PYTHONISH_NUMBER_BUFFER_SIZE 32
+
+// Записывает кратчайшую запись числа, которая читается обратно в то же число:
+//  0.1, 100, 1.5e+300, -0, inf, nan.
+size_t pythonish_format_num(double value, char *buffer);
+
+size_t pythonish_format_int(int64_t value, char *buffer);
+
+/*
+ * Буферизованный вывод для инструкции print: каждая функция печатает значение
+ *  и перевод строки. Буфер сбрасывается одним вызовом write(2) при заполнении
+ *  и при завершении программы, а если stdout - терминал, то после каждой строки.
+ */
+
+void pythonish_print_str(const char *data, size_t length);
+
+// Печатает число в кратчайшей записи, см. pythonish_format_num.
+void pythonish_print_num(double value);
+
+void pythonish_print_int(int64_t value);
+
+// Печатает true, если value не равно нулю, иначе false.
+void pythonish_print_bool(int value);
+
+// Функции write дописывают значение в буфер без перевода строки:
+//  так печатается цепочка конкатенаций `print a + String(x) + b` без сборки строки.
+void pythonish_write_str(const char *data, size_t length);
+void pythonish_write_num(double value);
+void pythonish_write_int(int64_t value);
+void pythonish_write_bool(int value);
+void pythonish_end_line(void);
+
+// Записывает содержимое буфера вывода в stdout.
+void pythonish_flush(void);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,9 @@
+#pragma once
+
+/*
+ * Внутренние функции библиотеки времени выполнения, общие для нескольких её файлов.
+ * Сгенерированный код их не вызывает.
+ */
+
+// Возвращает ptr, а при нехватке памяти (ptr == NULL) аварийно завершает программу.
+void *pythonish_abort_on_null(void *ptr);
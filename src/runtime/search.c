@@ -0,0 +1,30 @@
+#include "runtime.h"
+#include <string.h>
+
+// Кандидаты на вхождение ищутся memchr по первому байту подстроки,
+//  остальные байты сравниваются memcmp.
+int64_t pythonish_find(const char *data, size_t length, const char *sub, size_t subLength)
+{
+    if (subLength == 0)
+    {
+        return 0;
+    }
+    if (subLength > length)
+    {
+        return -1;
+    }
+    const char *last = data + (length - subLength);
+    for (const char *pos = data; pos <= last; ++pos)
+    {
+        pos = memchr(pos, (unsigned char)sub[0], (size_t)(last - pos) + 1);
+        if (!pos)
+        {
+            return -1;
+        }
+        if (memcmp(pos + 1, sub + 1, subLength - 1) == 0)
+        {
+            return (int64_t)(pos - data);
+        }
+    }
+    return -1;
+}